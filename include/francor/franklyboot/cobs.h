@@ -0,0 +1,173 @@
+/**
+ * @file cobs.h
+ * @author Martin Bauernschmitt (martin.bauernschmitt@francor.de)
+ * @brief COBS framing layer with CRC for byte stream transports (UART, USB-CDC)
+ * @version 0.1
+ * @date 2022-11-26
+ *
+ * @copyright Copyright (c) 2022 - BSD-3-clause - FRANCOR e.V.
+ *
+ */
+
+#ifndef FRANCOR_FRANKLYBOOT_COBS_H_
+#define FRANCOR_FRANKLYBOOT_COBS_H_
+
+#ifdef __cplusplus
+
+#include <francor/franklyboot/msg.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Groups all definitions of the frankly boot bootloader
+ */
+namespace franklyboot {
+
+/**
+ * @brief COBS framing layer
+ *
+ * Byte stream transports are not limited to 8 byte messages. Every frame is encoded with
+ * Consistent Overhead Byte Stuffing (COBS) and terminated by a zero byte. The decoded frame has
+ * the following layout (all values little endian):
+ *
+ * [CRC32 (4 bytes) | msg header + msg data (8 bytes) | data block (0 ... n bytes)]
+ *
+ * The CRC is located in front of the message, so the decoder knows that every byte after the
+ * message belongs to the data block. The data block is decoded into a staging buffer of the transport,
+ * the receiver copies it (e.g. Handler::processBlockRequest()) only after the CRC of the frame is valid.
+ */
+namespace cobs {
+
+/** \brief Delimiter of encoded frames */
+constexpr uint8_t FRAME_DELIMITER = {0x00U};
+
+/** \brief Size of the CRC value in front of the message */
+constexpr uint32_t FRAME_CRC_SIZE = {4U};
+
+/** \brief Size of the message in a frame */
+constexpr uint32_t FRAME_MSG_SIZE = {msg::MSG_HEADER_SIZE + msg::MSG_DATA_SIZE_CAN};
+
+/** \brief Size of a frame without data block */
+constexpr uint32_t FRAME_HEADER_SIZE = {FRAME_CRC_SIZE + FRAME_MSG_SIZE};
+
+/** \brief Max. number of data bytes of one COBS block */
+constexpr uint32_t COBS_BLOCK_MAX_SIZE = {254U};
+
+/** \brief Start value of the CRC calculation */
+constexpr uint32_t CRC_INIT_VALUE = {0xFFFFFFFFU};
+
+/**
+ * @brief Get the max. size of an encoded frame (incl. delimiter)
+ *
+ * @param block_size Size of the data block in bytes
+ */
+constexpr uint32_t getMaxEncodedSize(const uint32_t block_size) {
+  const uint32_t decoded_size = FRAME_HEADER_SIZE + block_size;
+  return decoded_size + (decoded_size / COBS_BLOCK_MAX_SIZE) + 2U;
+}
+
+/**
+ * @brief Updates a CRC32 (IEEE 802.3) value with one byte
+ *
+ * Software implementation with a 16 entry table, because the frame CRC has to be calculated
+ * byte by byte while receiving.
+ *
+ * @param crc Current CRC value (start with CRC_INIT_VALUE)
+ * @param byte Byte to add
+ * @return uint32_t New CRC value
+ */
+[[nodiscard]] uint32_t updateCRC(uint32_t crc, uint8_t byte);
+
+/** \brief Finalizes a CRC32 value calculated with updateCRC() */
+[[nodiscard]] constexpr uint32_t finalizeCRC(const uint32_t crc) { return ~crc; }
+
+/**
+ * @brief Encodes a frame (host and bootloader side)
+ *
+ * @param msg Message to encode
+ * @param block_ptr Pointer to data block (nullptr if no block is transmitted)
+ * @param block_size Size of data block in bytes
+ * @param dst_ptr Destination buffer
+ * @param dst_size Size of destination buffer (see getMaxEncodedSize())
+ * @return uint32_t Number of encoded bytes incl. delimiter (0 if destination buffer is too small)
+ */
+[[nodiscard]] uint32_t encodeFrame(const msg::Msg& msg, const uint8_t* block_ptr, uint32_t block_size,
+                                   uint8_t* dst_ptr, uint32_t dst_size);
+
+/**
+ * @brief Decoder of frames received byte by byte (bootloader and host side)
+ */
+class Decoder {
+ public:
+  Decoder() = default;
+
+  /**
+   * @brief Set the staging buffer of data blocks
+   *
+   * Data blocks are decoded into this buffer before the CRC of the frame is checked, so it must not hold
+   * valid data (e.g. the page buffer of the handler). Dropped frames leave undefined contents. Blocks larger
+   * than the buffer are received (CRC is checked) but not stored, getBlockPtr() returns a nullptr in this case.
+   *
+   * @param block_ptr Pointer to the staging buffer (nullptr if no blocks are accepted)
+   * @param block_size Size of the staging buffer
+   */
+  void setBlockBuffer(uint8_t* block_ptr, uint32_t block_size);
+
+  /**
+   * @brief Processes a received byte
+   *
+   * @return true Complete and valid frame received
+   */
+  bool processByte(uint8_t byte);
+
+  /** \brief Checks if a complete frame was received */
+  [[nodiscard]] bool isMsgAvl() const { return _msg_avl; }
+
+  /** \brief Get the message of the received frame */
+  [[nodiscard]] msg::Msg getMsg() const;
+
+  /** \brief Get pointer to the received data block (nullptr if block did not fit into buffer) */
+  [[nodiscard]] const uint8_t* getBlockPtr() const;
+
+  /** \brief Get size of the received data block in bytes */
+  [[nodiscard]] uint32_t getBlockSize() const { return _block_size; }
+
+  /** \brief Get number of dropped frames (CRC error, framing error, frame not released) */
+  [[nodiscard]] uint32_t getNumDroppedFrames() const { return _num_dropped_frames; }
+
+  /** \brief Releases the received frame, so that the next frame can be received */
+  void releaseMsg();
+
+ private:
+  void resetFrame();
+  void addDecodedByte(uint8_t byte);
+  void finishFrame();
+
+  uint8_t* _block_buffer_ptr = {nullptr};  //!< Destination of data blocks
+  uint32_t _block_buffer_size = {0U};      //!< Size of destination buffer
+
+  msg::MsgRaw _msg_raw = {};                    //!< Received message
+  uint32_t _block_size = {0U};                  //!< Size of received data block
+  bool _msg_avl = {false};                      //!< Complete frame available
+  uint32_t _frame_crc = {0U};                   //!< CRC value received in current frame
+  uint32_t _frame_calc_crc = {CRC_INIT_VALUE};  //!< CRC value calculated over current frame
+  uint32_t _frame_pos = {0U};                   //!< Number of decoded bytes of current frame
+  uint32_t _frame_block_size = {0U};            //!< Size of data block of current frame
+  bool _frame_error = {false};                  //!< Current frame has to be dropped
+  bool _frame_started = {false};                //!< At least one byte of current frame received
+
+  uint8_t _code = {0U};            //!< Code byte of current COBS block
+  uint8_t _code_remaining = {0U};  //!< Remaining bytes of current COBS block
+
+  uint32_t _num_dropped_frames = {0U};  //!< Number of dropped frames
+};
+
+}; /* namespace cobs */
+
+}; /* namespace franklyboot */
+
+#endif /* __cplusplus */
+
+#endif /* FRANCOR_FRANKLYBOOT_COBS_H_ */
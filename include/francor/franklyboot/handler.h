@@ -15,18 +15,48 @@
 
 #include <francor/franklyboot/franklyboot.h>
 #include <francor/franklyboot/hardware_interface.h>
+#include <francor/franklyboot/lzss.h>
 #include <francor/franklyboot/msg.h>
+#include <francor/franklyboot/ring_buffer.h>
 
 #include <array>
+#include <bitset>
 #include <cstddef>
 #include <cstdint>
+#include <initializer_list>
 #include <limits>
+#include <type_traits>
 
 /**
  * @brief Groups all definitions of the frankly boot bootloader
  */
 namespace franklyboot {
 
+/**
+ * @brief Request extension disabling a built-in request
+ *
+ * The request is answered with RES_ERR_UNKNOWN_REQ and the built-in handler is dropped from the
+ * dispatch table, so its code is not linked.
+ *
+ * Vendor requests are added the same way, an extension provides the request id and a handler
+ * writing the response (prepared as echo of the request with RES_ERR):
+ *
+ * struct VendorRequest {
+ *   static constexpr uint16_t REQUEST = {0x8001U};
+ *   template <typename MSG> static void processRequest(const MSG& request, MSG& response);
+ * };
+ */
+template <msg::RequestType REQUEST_TYPE>
+struct DisableRequest {
+  static constexpr msg::RequestType REQUEST = {REQUEST_TYPE};
+
+  template <typename MSG>
+  static void processRequest(const MSG& request, MSG& response) {
+    (void)request;
+    response.result = msg::RES_ERR_UNKNOWN_REQ;
+  }
+};
+
 /**
  * @brief Frankly Bootloader Handler
  *
@@ -34,10 +64,23 @@ namespace franklyboot {
  * @param FLASH_APP_FIRST_PAGE Page idx where application area starts
  * @param FLASH_SIZE Size of complete flash including bootloader
  * @param FLASH_PAGE_SIZE Size of a flash page
+ * @param STREAM_WINDOW_SIZE Number of streamed page buffer words acknowledged with one response
+ * @param MSG_DATA_SIZE Payload size of a message (4 for CAN, up to 60 for CAN-FD)
+ * @param QUEUE_SIZE Number of entries of the request queue and response ring (0 = no queues, otherwise power of two)
+ * @param DECOMPRESSION_WINDOW_BITS Window bits of the LZSS decompression of compressed uploads (0 = disabled)
+ * @param NUM_PAGE_BUFFERS Number of page buffers, further buffers receive while a page is written (deferred write)
+ * @param HWI Hardware interface policy (default: free functions of franklyboot::hwi, see hwi::FreeFunctions)
+ * @param REQUEST_EXTENSIONS Vendor requests added to / replacing requests of the dispatch table (see DisableRequest)
  */
-template <uint32_t FLASH_START, uint32_t FLASH_APP_FIRST_PAGE, uint32_t FLASH_SIZE, uint32_t FLASH_PAGE_SIZE>
+template <uint32_t FLASH_START, uint32_t FLASH_APP_FIRST_PAGE, uint32_t FLASH_SIZE, uint32_t FLASH_PAGE_SIZE,
+          uint32_t STREAM_WINDOW_SIZE = 16U, size_t MSG_DATA_SIZE = msg::MSG_DATA_SIZE_CAN, size_t QUEUE_SIZE = 0U,
+          uint32_t DECOMPRESSION_WINDOW_BITS = 0U, uint32_t NUM_PAGE_BUFFERS = 1U, typename HWI = hwi::FreeFunctions,
+          typename... REQUEST_EXTENSIONS>
 class Handler {
  public:
+  /** \brief Message type matching the payload size of the handler */
+  using Msg = msg::BasicMsg<MSG_DATA_SIZE>;
+
   enum class CommandBuffer {
     NONE,          //!< Do nothing
     RESET_DEVICE,  //!< Reset device
@@ -46,8 +89,10 @@ class Handler {
 
   /**
    * @brief Construct a new Handler object
+   *
+   * @param hwi Hardware interface of the device (copied, a policy referencing a backend stores a pointer)
    */
-  Handler();
+  explicit Handler(const HWI& hwi = HWI());
 
   /**
    * @brief Process buffered commands
@@ -55,6 +100,11 @@ class Handler {
    * Processes buffered commands, which cannot be executed immadetly,
    * because otherwise a response cannot be send. This function will do nothing
    * if no command is buffered.
+   *
+   * A running REQ_FLASH_WRITE_ERASE_RANGE is continued with one page (or sector, see hwi::HasSectorErase)
+   * erase per invocation, so this function shall be called cyclically from the main loop. Page buffers
+   * written with WRITE_TO_FLASH_DEFER are written to flash in order, one page per invocation.
+   * With an asynchronous HWI (hwi::IsAsyncFlash) every invocation only starts or polls one flash operation.
    */
   void processBufferedCmds();
 
@@ -63,7 +113,60 @@ class Handler {
    *
    * @param msg Received message from network
    */
-  void processRequest(const msg::Msg& msg);
+  void processRequest(const Msg& msg);
+
+  /**
+   * @brief Processes a bootloader request received by the broadcast ID
+   *
+   * Allows to program many identical devices at once. Page buffer fills (clear, words) are processed
+   * silently, so the devices do not answer every word. Afterwards the host reads the state of every device
+   * with node specific requests (e.g. REQ_PAGE_BUFFER_STATUS, REQ_PAGE_BUFFER_CALC_CRC) and repeats missing
+   * words node specific. All other requests are answered like processRequest().
+   *
+   * @param msg Received message from network
+   */
+  void processBroadcastRequest(const Msg& msg);
+
+  /**
+   * @brief Processes a bootloader request carrying an additional data block
+   *
+   * Used by transports which are able to transfer more data than fitting into
+   * a single message (e.g. ISO-TP). Requests without block are forwarded to processRequest(), as well as
+   * requests disabled / replaced by REQUEST_EXTENSIONS (the extension does not receive the block).
+   *
+   * @param msg Received message from network
+   * @param block_ptr Pointer to the data block following the message
+   * @param block_size Size of the data block in bytes
+   */
+  void processBlockRequest(const Msg& msg, const uint8_t* block_ptr, uint32_t block_size);
+
+  /**
+   * @brief Pushes a received request to the request queue
+   *
+   * Can be called from a receive ISR while the main loop is busy (e.g. programming flash).
+   * Requires QUEUE_SIZE > 0.
+   *
+   * @param msg Received message from network
+   * @return true Request queued / false queue is full (request is dropped)
+   */
+  bool pushRequest(const Msg& msg);
+
+  /**
+   * @brief Processes queued requests (main loop)
+   *
+   * Requests are processed in order as long as the response ring has free entries, so no
+   * response is dropped. Processing stops after a request buffering a command (e.g. REQ_START_APP),
+   * so that the response can be transmitted before processBufferedCmds() executes it.
+   */
+  void processRequestQueue();
+
+  /**
+   * @brief Pops the oldest response from the response ring
+   *
+   * @param msg Response message which shall be transmitted through the network
+   * @return true Response available
+   */
+  bool popResponse(Msg& msg);
 
   /**
    * @brief Get the response of the request
@@ -75,6 +178,24 @@ class Handler {
    */
   auto getResponse() const;
 
+  /**
+   * @brief Checks if the last processed request produced a response
+   *
+   * Streamed requests (e.g. REQ_PAGE_BUFFER_STREAM_WORD) are only acknowledged
+   * once per window. If this function returns false no response shall be transmitted.
+   */
+  [[nodiscard]] bool isResponseAvl() const;
+
+  /**
+   * @brief Prepares the next response of a multi-frame response
+   *
+   * Some requests (e.g. REQ_FLASH_READ_BLOCK) produce a sequence of numbered responses.
+   * After the current response is transmitted, this function creates the next one. The transport
+   * shall drain all responses: while (isResponseAvl()) { send(getResponse()); processNextResponse(); }
+   * A new request aborts a pending multi-frame response.
+   */
+  void processNextResponse();
+
   /**
    * @brief Checks if a valid app is available in flash
    *
@@ -92,14 +213,70 @@ class Handler {
   [[nodiscard]] auto getFlashAppAddress() const { return FLASH_APP_ADDRESS; }
   [[nodiscard]] auto getFlashAppNumPages() const { return FLASH_APP_NUM_PAGES; }
   [[nodiscard]] auto getFlashAppCRCValueAddress() const { return FLASH_APP_CRC_VALUE_ADDRESS; }
+  [[nodiscard]] auto getStreamWindowSize() const { return STREAM_WINDOW_SIZE; }
+  [[nodiscard]] auto getMsgDataSize() const { return MSG_DATA_SIZE; }
+  [[nodiscard]] auto getQueueSize() const { return QUEUE_SIZE; }
+  [[nodiscard]] auto getDecompressionWindowBits() const { return DECOMPRESSION_WINDOW_BITS; }
+  [[nodiscard]] auto getNumPageBuffers() const { return NUM_PAGE_BUFFERS; }
+  [[nodiscard]] static constexpr auto getCapabilities() { return CAPABILITIES; }
 
   [[nodiscard]] auto getByteFromPageBuffer(uint32_t byte_idx) const;
 
+  /** \brief Get number of bytes which can still be written to the page buffer */
+  [[nodiscard]] uint32_t getPageBufferNumBytesFree() const {
+    return static_cast<uint32_t>(getPageBuffer().size()) - _page_buffer_pos;
+  }
+
  private:
+  enum class ResponseStream {
+    NONE,              //!< Single response
+    FLASH_READ_BLOCK,  //!< Flash data of REQ_FLASH_READ_BLOCK
+    INVENTORY,         //!< Fields of REQ_DEV_INFO_INVENTORY
+    CAPABILITIES,      //!< Fields of REQ_DEV_INFO_CAPABILITIES
+    MISSING_WORDS,     //!< Bitmap of REQ_PAGE_BUFFER_MISSING_WORDS
+  };
+
+  /** \brief Placeholder if the decompression is disabled */
+  struct NoDecoder {};
+
+  /** \brief LZSS decoder of compressed uploads, the page buffer is the window of the decoder */
+  using Decoder = std::conditional_t<(DECOMPRESSION_WINDOW_BITS > 0U), lzss::Decoder<DECOMPRESSION_WINDOW_BITS>,
+                                     NoDecoder>;
+
+  /** \brief Page buffer, receives the words of a flash page */
+  using PageBuffer = std::array<uint8_t, FLASH_PAGE_SIZE>;
+
+  /** \brief Flash write of a page buffer (REQ_PAGE_BUFFER_WRITE_TO_FLASH) */
+  struct PageCommit {
+    uint32_t page_id = {0U};                   //!< Destination flash page
+    uint8_t flags = {0U};                      //!< Flags of the request (msg::WriteToFlashFlag)
+    msg::ResultType result = {msg::RES_NONE};  //!< RES_BUSY while waiting for the write, afterwards its result
+    uint32_t crc = {0U};                       //!< CRC of the flash page after the write (WRITE_TO_FLASH_VERIFY)
+  };
+
+  /** \brief State of the asynchronous flash operation (hwi::IsAsyncFlash) */
+  enum class FlashState : uint8_t {
+    IDLE,   //!< No operation running
+    ERASE,  //!< Page erase running
+    WRITE,  //!< Page write running
+  };
+
+  /** \brief Handler of a request of the dispatch table */
+  using RequestHandler = void (*)(Handler& handler, const Msg& request);
+
+  /** \brief Entry of the dispatch table */
+  struct RequestEntry {
+    msg::RequestType request = {msg::REQ_PING};  //!< Request type
+    RequestHandler handler = {nullptr};          //!< Handler processing the request
+  };
+
+  /** \brief Number of words (message payloads) of the page buffer, last word can be shorter */
+  static constexpr uint32_t PAGE_BUFFER_NUM_WORDS = {(FLASH_PAGE_SIZE + MSG_DATA_SIZE - 1U) / MSG_DATA_SIZE};
+
   /* General requests */
   void handleReqPing();
   void handleReqResetDevice();
-  void handleReqStartApp(const msg::Msg& request);
+  void handleReqStartApp(const Msg& request);
 
   /* Device information */
   void handleReqInfoBootloaderVer();
@@ -108,6 +285,8 @@ class Handler {
   void handleReqInfoProductID();
   void handleReqInfoProductionDate();
   void handleReqInfoUniqueID(msg::RequestType request);
+  void handleReqInfoInventory();
+  void handleReqInfoCapabilities();
 
   /* Flash information */
   void handleReqFlashStartAddress();
@@ -120,31 +299,144 @@ class Handler {
   void handleReqAppCrcStrd();
 
   /* Flash Read commands */
-  void handleReqFlashReadWord(const msg::Msg& request);
+  void handleReqFlashReadWord(const Msg& request);
+  void handleReqFlashReadBlock(const Msg& request);
+  void handleReqFlashReadPageCrc(const Msg& request);
+  void handleReqFlashReadCrc(const Msg& request);
 
   /* Page Buffer Commands */
   void handleReqPageBufferClear();
-  void handleReqPageBufferReadWord(const msg::Msg& request);
-  void handleReqPageBufferWriteWord(const msg::Msg& request);
+  void handleReqPageBufferReadWord(const Msg& request);
+  void handleReqPageBufferWriteWord(const Msg& request);
+  void handleReqPageBufferStreamWord(const Msg& request);
+  void handleReqPageBufferWriteBlock(const Msg& request, const uint8_t* block_ptr, uint32_t block_size);
+  void handleReqPageBufferMissingWords(const Msg& request);
+  void handleReqPageBufferWriteWordAt(const Msg& request);
+  void handleReqPageBufferWriteBlockAt(const Msg& request, const uint8_t* block_ptr, uint32_t block_size);
+  void handleReqPageBufferStatus();
+  void handleReqPageBufferWriteCompressed(const Msg& request);
+  void handleReqPageBufferCopyFromFlash(const Msg& request);
+  void handleReqPageBufferFill(const Msg& request);
   void handleReqPageBufferCalcCrc();
-  void handleReqPageBufferWriteToFlash(const msg::Msg& request);
+  void handleReqPageBufferWriteToFlash(const Msg& request);
+  void handleReqPageBufferCommitStatus(const Msg& request);
 
   /* Flash Write Commands*/
-  void handleReqFlashWriteErasePage(const msg::Msg& request);
-  void handleReqFlashWriteAppCrc(const msg::Msg& request);
-
+  void handleReqFlashWriteErasePage(const Msg& request);
+  void handleReqFlashWriteAppCrc(const Msg& request);
+  void handleReqFlashWriteEraseRange(const Msg& request);
+  void handleReqFlashWriteEraseStatus();
+
+  /* Background erase */
+  void processEraseRange();
+  [[nodiscard]] bool isEraseRangeBusy() const;
+  [[nodiscard]] static bool isFlashWriteRequest(msg::RequestType request);
+  [[nodiscard]] bool isFlashBusy(msg::RequestType request) const;
+  [[nodiscard]] static bool isPageBufferWriteRequest(msg::RequestType request);
+
+  /* Page buffer commit */
+  void commitPageBuffer(uint32_t buffer_idx);
+  void processPageCommit(uint32_t buffer_idx);
+  void startPageWrite(uint32_t buffer_idx);
+  void finishPageCommit(uint32_t buffer_idx, msg::ResultType result);
+  void processPageCommits();
+  [[nodiscard]] bool isPageCommitPending() const;
+  [[nodiscard]] bool isPageBufferLocked() const;
+
+  /* Request dispatch */
+  template <typename EXTENSION>
+  static void processExtensionRequest(Handler& handler, const Msg& request);
+  template <size_t NUM_ENTRIES>
+  [[nodiscard]] static constexpr auto makeArray(const RequestEntry (&entries)[NUM_ENTRIES]);
+  [[nodiscard]] static constexpr auto createBuiltinRequests();
+  [[nodiscard]] static constexpr bool isExtensionRequest(msg::RequestType request);
+  [[nodiscard]] static constexpr bool isBuiltinRequestActive(std::initializer_list<msg::RequestType> requests);
+  [[nodiscard]] static constexpr uint32_t createCapabilityFeatures();
+  [[nodiscard]] static constexpr uint32_t getNumRequests();
+  [[nodiscard]] static constexpr auto createRequestTable();
+  [[nodiscard]] static constexpr uint32_t findRequestHashSize();
+  [[nodiscard]] static constexpr auto createRequestHash();
+
+  /* Multi-frame requests / responses */
+  [[nodiscard]] bool receiveFlashRangeArgs(const Msg& request, uint32_t& address, uint32_t& num_bytes);
+  void createFlashReadBlockResponse();
+  void createFieldsResponse();
+  void createMissingWordsResponse();
+  [[nodiscard]] uint32_t getInventoryField(uint32_t field) const;
+
+  void writeWordToPageBuffer(uint32_t word_idx, const msg::BasicMsgData<MSG_DATA_SIZE>& data);
+  void markPageBufferWordsRcvd(uint32_t byte_idx, uint32_t num_bytes);
+  void advancePageBufferPos();
+  [[nodiscard]] bool isPageBufferComplete() const;
+  [[nodiscard]] PageBuffer& getPageBuffer();
+  [[nodiscard]] const PageBuffer& getPageBuffer() const;
+  void clearPageBuffer();
+  [[nodiscard]] bool isPageBufferEqualToFlash(uint32_t buffer_idx, uint32_t address) const;
+  [[nodiscard]] bool isFlashPageBlank(uint32_t page_id) const;
+  bool eraseFlashPageIfNotBlank(uint32_t page_id);
+  [[nodiscard]] msg::ResultType getPageBufferWordsRange(const Msg& request, uint32_t& num_bytes) const;
+  [[nodiscard]] bool getPageBufferWordIdx(uint8_t packet_id, uint32_t& word_idx) const;
+  [[nodiscard]] bool isPageBufferWordMissing(uint32_t word_idx) const;
+  [[nodiscard]] uint8_t getPageBufferPacketId() const;
   [[nodiscard]] uint32_t getPageBufferAddress() const;
   [[nodiscard]] uint32_t calcAppCRC() const;
   [[nodiscard]] uint32_t readAppCRCFromFlash() const;
 
+  HWI _hwi;  //!< Hardware interface of the device
+
   /** \brief Command buffer for commands which cannot be processed immediatly */
   CommandBuffer _cmd_buffer = {CommandBuffer::NONE};
 
-  msg::Msg _response = {msg::Msg()};  //!< Response message
+  Msg _response = {Msg()};       //!< Response message
+  bool _response_avl = {false};  //!< Flag indicating that the response shall be transmitted
+
+  /* Request queue / response ring */
+  RingBuffer<Msg, QUEUE_SIZE> _request_queue;   //!< Received requests (filled by pushRequest())
+  RingBuffer<Msg, QUEUE_SIZE> _response_queue;  //!< Responses ready to transmit (emptied by popResponse())
+
+  /* Multi-frame responses */
+  ResponseStream _response_stream = {ResponseStream::NONE};  //!< Active multi-frame response
+  uint32_t _response_stream_idx = {0U};                      //!< Index of next response frame
+  uint32_t _response_stream_num = {0U};                      //!< Number of response frames
 
-  /* Page Buffer */
-  std::array<uint8_t, FLASH_PAGE_SIZE> _page_buffer;  //!< Page buffer
-  uint32_t _page_buffer_pos = {0U};                   //!< Current write position of page buffer
+  /* Flash range arguments (start address received in first frame) */
+  uint32_t _flash_range_address = {0U};                                 //!< Start address of the range
+  msg::RequestType _flash_range_request = {msg::REQ_FLASH_READ_BLOCK};  //!< Request the start address belongs to
+  bool _flash_range_address_avl = {false};                              //!< Start address received
+
+  /* Flash read block */
+  uint32_t _flash_read_address = {0U};    //!< Start address of the block
+  uint32_t _flash_read_num_bytes = {0U};  //!< Number of bytes of the block
+
+  /* Page Buffers (the receiving buffer is selected by _page_buffer_idx, getPageBuffer()) */
+  std::array<PageBuffer, NUM_PAGE_BUFFERS> _page_buffers;  //!< Page buffers
+  std::array<PageCommit, NUM_PAGE_BUFFERS> _page_commits;  //!< Last flash write of every page buffer
+  uint32_t _page_buffer_idx = {0U};                        //!< Page buffer receiving the words of the host
+
+  /* Receiving page buffer */
+  uint32_t _page_buffer_pos = {0U};           //!< Current write position of page buffer
+  uint32_t _page_buffer_end_pos = {0U};       //!< End of the highest word received (>= write position)
+  bool _page_buffer_stream_gap = {false};     //!< Gap in streamed words already reported to host
+  bool _page_buffer_random_access = {false};  //!< Words written at explicit index (every word required)
+
+  /** \brief Received words, words ahead of the write position are kept until a lost word is repeated */
+  std::bitset<PAGE_BUFFER_NUM_WORDS> _page_buffer_words_rcvd;
+
+  /* Compressed upload */
+  Decoder _page_buffer_decoder;                 //!< Decoder writing to the page buffer (reset by clear)
+  uint32_t _page_buffer_compressed_idx = {0U};  //!< Index of the next compressed frame
+
+  /* Missing words */
+  uint32_t _missing_words_start = {0U};  //!< Word index of the first bit of the missing words bitmap
+
+  /* Erase range (continued by processBufferedCmds()) */
+  uint32_t _erase_page_first = {0U};              //!< First page of the range
+  uint32_t _erase_page_next = {0U};               //!< Next page to erase
+  uint32_t _erase_page_end = {0U};                //!< Page behind the range
+  msg::ResultType _erase_result = {msg::RES_OK};  //!< RES_BUSY while erasing, afterwards result of the erase
+
+  /* Asynchronous flash operation (erase range or page buffer commit, polled by processBufferedCmds()) */
+  FlashState _flash_state = {FlashState::IDLE};  //!< Running operation
 
   /* Static Data */
 
@@ -157,6 +449,43 @@ class Handler {
   /** \brief Number of application flash pages */
   static constexpr uint32_t FLASH_APP_NUM_PAGES = {FLASH_NUM_PAGES - FLASH_APP_FIRST_PAGE};
 
+  /** \brief Flash operations of the HWI are started and polled instead of blocking */
+  static constexpr bool ASYNC_FLASH = {hwi::IsAsyncFlash<HWI>::value};
+
+  /** \brief Number of inventory / capability fields transmitted per response frame */
+  static constexpr uint32_t INVENTORY_FIELDS_PER_MSG = {MSG_DATA_SIZE / sizeof(uint32_t)};
+
+  /** \brief Features supported by this instantiation (requests disabled / replaced by extensions are not reported) */
+  static constexpr uint32_t CAPABILITY_FEATURES = {createCapabilityFeatures()};
+
+  /** \brief Fields of REQ_DEV_INFO_CAPABILITIES (order of msg::CapabilityField) */
+  static constexpr std::array<uint32_t, msg::CAP_NUM_FIELDS> CAPABILITIES = {
+      CAPABILITY_FEATURES, MSG_DATA_SIZE, STREAM_WINDOW_SIZE, NUM_PAGE_BUFFERS, DECOMPRESSION_WINDOW_BITS, QUEUE_SIZE};
+
+  /** \brief Number of requests of the dispatch table (built-in requests and vendor requests) */
+  static constexpr uint32_t NUM_REQUESTS = {getNumRequests()};
+
+  /** \brief Dispatch table, processRequest() looks up the entry through REQUEST_HASH */
+  static constexpr std::array<RequestEntry, NUM_REQUESTS> REQUEST_TABLE = {createRequestTable()};
+
+  /** \brief Maximum size of the request hash, searched for a collision free size at compile time */
+  static constexpr uint32_t REQUEST_HASH_SIZE_MAX = {1024U};
+
+  /** \brief Size of the request hash (smallest size with collision free request id % size) */
+  static constexpr uint32_t REQUEST_HASH_SIZE = {findRequestHashSize()};
+
+  /** \brief Index of the dispatch table entry for every request id % REQUEST_HASH_SIZE (NUM_REQUESTS = empty) */
+  static constexpr std::array<uint8_t, REQUEST_HASH_SIZE> REQUEST_HASH = {createRequestHash()};
+
+  /** \brief Number of words reported per response frame of REQ_PAGE_BUFFER_MISSING_WORDS */
+  static constexpr uint32_t MISSING_WORDS_PER_MSG = {MSG_DATA_SIZE * 8U};
+
+  /** \brief Maximum number of words a packet id may be ahead of the write position */
+  static constexpr uint32_t PACKET_ID_MAX_AHEAD = {128U};
+
+  /** \brief Number of bytes of the arguments of flash range requests (address + length) */
+  static constexpr uint32_t FLASH_RANGE_ARGS_SIZE = {2U * sizeof(uint32_t)};
+
   /** \brief Location of CRC value */
   static constexpr uint32_t FLASH_APP_CRC_VALUE_ADDRESS = {FLASH_START + FLASH_SIZE - 4U};
 
@@ -168,6 +497,16 @@ class Handler {
                 "FLASH_APP_FIRST_PAGE has to be > 0, because otherwise it will overwrite the bootloader!");
   static_assert(FLASH_APP_FIRST_PAGE < FLASH_NUM_PAGES,
                 "FLASH_APP_FIRST_PAGE cannot be >= than the maximum page number!");
+  static_assert(STREAM_WINDOW_SIZE > 0, "STREAM_WINDOW_SIZE cannot be 0!");
+  static_assert((NUM_PAGE_BUFFERS > 0U) && (NUM_PAGE_BUFFERS <= (std::numeric_limits<uint8_t>::max() + 1U)),
+                "NUM_PAGE_BUFFERS has to be 1 .. 256 (buffer index is transmitted as packet id)!");
+  static_assert(PAGE_BUFFER_NUM_WORDS <= (std::numeric_limits<uint16_t>::max() + 1U),
+                "FLASH_PAGE_SIZE too large, words of the page buffer have to be addressable with a 16-bit index!");
+  static_assert(STREAM_WINDOW_SIZE <= 128U,
+                "STREAM_WINDOW_SIZE has to be <= 128, because otherwise the 8-bit packet id is ambiguous!");
+  static_assert(NUM_REQUESTS < std::numeric_limits<uint8_t>::max(),
+                "Too many REQUEST_EXTENSIONS, entries of the dispatch table have to be addressable with 8-bit!");
+  static_assert(REQUEST_HASH_SIZE <= REQUEST_HASH_SIZE_MAX, "Request ids of REQUEST_EXTENSIONS have to be unique!");
 };
 
 }; /* namespace franklyboot */
@@ -17,18 +17,28 @@
 namespace franklyboot {
 
 /** \brief Define for the template definition for better readibility */
-#define FRANKLYBOOT_HANDLER_TEMPL \
-  template <uint32_t FLASH_START, uint32_t FLASH_APP_FIRST_PAGE, uint32_t FLASH_SIZE, uint32_t FLASH_PAGE_SIZE>
+#define FRANKLYBOOT_HANDLER_TEMPL                                                                                \
+  template <uint32_t FLASH_START, uint32_t FLASH_APP_FIRST_PAGE, uint32_t FLASH_SIZE, uint32_t FLASH_PAGE_SIZE,   \
+            uint32_t STREAM_WINDOW_SIZE, size_t MSG_DATA_SIZE, size_t QUEUE_SIZE, uint32_t DECOMPRESSION_WINDOW_BITS, \
+            uint32_t NUM_PAGE_BUFFERS, typename HWI, typename... REQUEST_EXTENSIONS>
 
 /** \brief Prefix of template functions for better readability */
-#define FRANKLYBOOT_HANDLER_TEMPL_PREFIX Handler<FLASH_START, FLASH_APP_FIRST_PAGE, FLASH_SIZE, FLASH_PAGE_SIZE>
+#define FRANKLYBOOT_HANDLER_TEMPL_PREFIX                                                                   \
+  Handler<FLASH_START, FLASH_APP_FIRST_PAGE, FLASH_SIZE, FLASH_PAGE_SIZE, STREAM_WINDOW_SIZE, MSG_DATA_SIZE, \
+          QUEUE_SIZE, DECOMPRESSION_WINDOW_BITS, NUM_PAGE_BUFFERS, HWI, REQUEST_EXTENSIONS...>
 
 // Public Functions ---------------------------------------------------------------------------------------------------
 
 FRANKLYBOOT_HANDLER_TEMPL
-FRANKLYBOOT_HANDLER_TEMPL_PREFIX::Handler() {
-  this->_page_buffer.fill({std::numeric_limits<uint8_t>::max()});
+FRANKLYBOOT_HANDLER_TEMPL_PREFIX::Handler(const HWI& hwi) : _hwi(hwi) {
+  for (auto& page_buffer : this->_page_buffers) {
+    page_buffer.fill({std::numeric_limits<uint8_t>::max()});
+  }
   this->_page_buffer_pos = 0U;
+
+  if constexpr (DECOMPRESSION_WINDOW_BITS > 0U) {
+    this->_page_buffer_decoder.reset(FLASH_PAGE_SIZE);
+  }
 }
 
 FRANKLYBOOT_HANDLER_TEMPL
@@ -37,141 +47,168 @@ void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::processBufferedCmds() {
     case CommandBuffer::NONE:
       break;
     case CommandBuffer::RESET_DEVICE:
-      hwi::resetDevice();
+      this->_hwi.resetDevice();
       break;
     case CommandBuffer::START_APP:
       const uint32_t app_flash_address = FLASH_START + FLASH_PAGE_SIZE * FLASH_APP_FIRST_PAGE;
-      hwi::startApp(app_flash_address);
+      this->_hwi.startApp(app_flash_address);
       break;
   }
 
   _cmd_buffer = CommandBuffer::NONE;
+
+  processEraseRange();
+  processPageCommits();
 }
 
 FRANKLYBOOT_HANDLER_TEMPL
-void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::processRequest(const msg::Msg& msg) {
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::processRequest(const Msg& msg) {
   /* First response is always an error as long as request is not handeld*/
   this->_response = msg;
   this->_response.result = msg::RES_ERR;
+  this->_response_avl = true;
+  this->_response_stream = ResponseStream::NONE;
 
-  switch (msg.request) {
-    case msg::REQ_PING:
-      handleReqPing();
-      break;
-
-    case msg::REQ_RESET_DEVICE:
-      handleReqResetDevice();
-      break;
-
-    case msg::REQ_START_APP:
-      handleReqStartApp(msg);
-      break;
-
-    case msg::REQ_DEV_INFO_BOOTLOADER_VERSION:
-      handleReqInfoBootloaderVer();
-      break;
+  /* Flash is erased / written in the background, requests modifying the flash have to wait until it is finished */
+  if (isFlashBusy(msg.request)) {
+    this->_response.result = msg::RES_BUSY;
+    return;
+  }
 
-    case msg::REQ_DEV_INFO_BOOTLOADER_CRC:
-      handleReqInfoBootloaderCRC();
-      break;
+  /* Lookup in the dispatch table, ids not in the table can share a hash slot with a known id */
+  const uint8_t entry_idx = REQUEST_HASH[msg.request % REQUEST_HASH_SIZE];
+  const bool request_known = (entry_idx < NUM_REQUESTS) && (REQUEST_TABLE[entry_idx].request == msg.request);
 
-    case msg::REQ_DEV_INFO_VID:
-      handleReqInfoVendorID();
-      break;
+  if (request_known) {
+    REQUEST_TABLE[entry_idx].handler(*this, msg);
+  } else {
+    this->_response.result = msg::RES_ERR_UNKNOWN_REQ;
+  }
+}
 
-    case msg::REQ_DEV_INFO_PID:
-      handleReqInfoProductID();
-      break;
+FRANKLYBOOT_HANDLER_TEMPL
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::processBroadcastRequest(const Msg& msg) {
+  processRequest(msg);
 
-    case msg::REQ_DEV_INFO_PRD:
-      handleReqInfoProductionDate();
+  switch (msg.request) {
+    case msg::REQ_PAGE_BUFFER_CLEAR:
+    case msg::REQ_PAGE_BUFFER_WRITE_WORD:
+    case msg::REQ_PAGE_BUFFER_STREAM_WORD:
+    case msg::REQ_PAGE_BUFFER_WRITE_WORD_AT:
+    case msg::REQ_PAGE_BUFFER_COPY_FROM_FLASH:
+    case msg::REQ_PAGE_BUFFER_FILL:
+      this->_response_avl = false;
       break;
 
-    case msg::REQ_DEV_INFO_UID_1:
-      handleReqInfoUniqueID(msg::REQ_DEV_INFO_UID_1);
+    default:
       break;
+  }
+}
 
-    case msg::REQ_DEV_INFO_UID_2:
-      handleReqInfoUniqueID(msg::REQ_DEV_INFO_UID_2);
-      break;
+FRANKLYBOOT_HANDLER_TEMPL
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::processBlockRequest(const Msg& msg, const uint8_t* block_ptr,
+                                                           const uint32_t block_size) {
+  /* Requests replaced by an extension (e.g. DisableRequest) are only known by the dispatch table */
+  if ((block_size == 0U) || isExtensionRequest(msg.request)) {
+    processRequest(msg);
+    return;
+  }
 
-    case msg::REQ_DEV_INFO_UID_3:
-      handleReqInfoUniqueID(msg::REQ_DEV_INFO_UID_3);
-      break;
+  this->_response = msg;
+  this->_response.result = msg::RES_ERR;
+  this->_response_avl = true;
+  this->_response_stream = ResponseStream::NONE;
 
-    case msg::REQ_DEV_INFO_UID_4:
-      handleReqInfoUniqueID(msg::REQ_DEV_INFO_UID_4);
-      break;
+  if (isFlashBusy(msg.request)) {
+    this->_response.result = msg::RES_BUSY;
+    return;
+  }
 
-    case msg::REQ_FLASH_INFO_START_ADDR:
-      handleReqFlashStartAddress();
-      break;
+  if (msg.request == msg::REQ_PAGE_BUFFER_WRITE_BLOCK) {
+    handleReqPageBufferWriteBlock(msg, block_ptr, block_size);
+  } else if (msg.request == msg::REQ_PAGE_BUFFER_WRITE_BLOCK_AT) {
+    handleReqPageBufferWriteBlockAt(msg, block_ptr, block_size);
+  } else {
+    this->_response.result = msg::RES_ERR_NOT_SUPPORTED;
+  }
+}
 
-    case msg::REQ_FLASH_INFO_PAGE_SIZE:
-      handleReqFlashPageSize();
-      break;
+FRANKLYBOOT_HANDLER_TEMPL
+bool FRANKLYBOOT_HANDLER_TEMPL_PREFIX::pushRequest(const Msg& msg) {
+  static_assert(QUEUE_SIZE > 0U, "pushRequest() requires QUEUE_SIZE > 0!");
+  return this->_request_queue.push(msg);
+}
 
-    case msg::REQ_FLASH_INFO_NUM_PAGES:
-      handleReqFlashNumPages();
-      break;
+FRANKLYBOOT_HANDLER_TEMPL
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::processRequestQueue() {
+  static_assert(QUEUE_SIZE > 0U, "processRequestQueue() requires QUEUE_SIZE > 0!");
+
+  for (;;) {
+    /* Move responses of the last request to the ring (multi-frame responses are continued next call) */
+    while (this->_response_avl) {
+      if (!this->_response_queue.push(this->_response)) {
+        return;
+      }
+      processNextResponse();
+    }
 
-    case msg::REQ_APP_INFO_PAGE_IDX:
-      handleReqAppPageIdx();
-      break;
+    /* Buffered command has to be executed before the next request is processed */
+    if (this->_cmd_buffer != CommandBuffer::NONE) {
+      return;
+    }
 
-    case msg::REQ_APP_INFO_CRC_CALC:
-      handleReqAppCrcCalc();
-      break;
+    Msg request;
+    if (!this->_request_queue.pop(request)) {
+      return;
+    }
 
-    case msg::REQ_APP_INFO_CRC_STRD:
-      handleReqAppCrcStrd();
-      break;
+    processRequest(request);
+  }
+}
 
-    case msg::REQ_FLASH_READ_WORD:
-      handleReqFlashReadWord(msg);
-      break;
+FRANKLYBOOT_HANDLER_TEMPL
+bool FRANKLYBOOT_HANDLER_TEMPL_PREFIX::popResponse(Msg& msg) {
+  static_assert(QUEUE_SIZE > 0U, "popResponse() requires QUEUE_SIZE > 0!");
+  return this->_response_queue.pop(msg);
+}
 
-    case msg::REQ_PAGE_BUFFER_CLEAR:
-      handleReqPageBufferClear();
-      break;
+FRANKLYBOOT_HANDLER_TEMPL
+auto FRANKLYBOOT_HANDLER_TEMPL_PREFIX::getResponse() const { return this->_response; }
 
-    case msg::REQ_PAGE_BUFFER_READ_WORD:
-      handleReqPageBufferReadWord(msg);
-      break;
+FRANKLYBOOT_HANDLER_TEMPL
+[[nodiscard]] bool FRANKLYBOOT_HANDLER_TEMPL_PREFIX::isResponseAvl() const { return this->_response_avl; }
 
-    case msg::REQ_PAGE_BUFFER_WRITE_WORD:
-      handleReqPageBufferWriteWord(msg);
-      break;
+FRANKLYBOOT_HANDLER_TEMPL
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::processNextResponse() {
+  this->_response_avl = false;
 
-    case msg::REQ_PAGE_BUFFER_CALC_CRC:
-      handleReqPageBufferCalcCrc();
-      break;
+  if (this->_response_stream_idx >= this->_response_stream_num) {
+    this->_response_stream = ResponseStream::NONE;
+  }
 
-    case msg::REQ_PAGE_BUFFER_WRITE_TO_FLASH:
-      handleReqPageBufferWriteToFlash(msg);
+  switch (this->_response_stream) {
+    case ResponseStream::NONE:
       break;
 
-    case msg::REQ_FLASH_WRITE_ERASE_PAGE:
-      handleReqFlashWriteErasePage(msg);
+    case ResponseStream::FLASH_READ_BLOCK:
+      createFlashReadBlockResponse();
       break;
 
-    case msg::REQ_FLASH_WRITE_APP_CRC:
-      handleReqFlashWriteAppCrc(msg);
+    case ResponseStream::INVENTORY:
+    case ResponseStream::CAPABILITIES:
+      createFieldsResponse();
       break;
 
-    default:
-      this->_response.result = msg::RES_ERR_UNKNOWN_REQ;
+    case ResponseStream::MISSING_WORDS:
+      createMissingWordsResponse();
       break;
-  };
+  }
 }
 
-FRANKLYBOOT_HANDLER_TEMPL
-auto FRANKLYBOOT_HANDLER_TEMPL_PREFIX::getResponse() const { return this->_response; }
-
 FRANKLYBOOT_HANDLER_TEMPL
 
 [[nodiscard]] auto FRANKLYBOOT_HANDLER_TEMPL_PREFIX::getByteFromPageBuffer(uint32_t byte_idx) const {
-  return this->_page_buffer.at(byte_idx);
+  return this->getPageBuffer().at(byte_idx);
 }
 
 FRANKLYBOOT_HANDLER_TEMPL
@@ -185,12 +222,215 @@ FRANKLYBOOT_HANDLER_TEMPL
   return (crc_value_stored == crc_value_calc);
 }
 
+// Request Dispatch ---------------------------------------------------------------------------------------------------
+
+FRANKLYBOOT_HANDLER_TEMPL
+template <typename EXTENSION>
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::processExtensionRequest(Handler& handler, const Msg& request) {
+  EXTENSION::processRequest(request, handler._response);
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+template <size_t NUM_ENTRIES>
+constexpr auto FRANKLYBOOT_HANDLER_TEMPL_PREFIX::makeArray(const RequestEntry (&entries)[NUM_ENTRIES]) {
+  std::array<RequestEntry, NUM_ENTRIES> array = {};
+  for (auto idx = 0U; idx < NUM_ENTRIES; idx++) {
+    array[idx] = entries[idx];
+  }
+
+  return array;
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+constexpr auto FRANKLYBOOT_HANDLER_TEMPL_PREFIX::createBuiltinRequests() {
+  using Req = const Msg&;
+
+  /* Number of entries is deduced, so every listed request gets its handler */
+  return makeArray({
+      /* General requests */
+      {msg::REQ_PING, [](Handler& hdl, Req) { hdl.handleReqPing(); }},
+      {msg::REQ_RESET_DEVICE, [](Handler& hdl, Req) { hdl.handleReqResetDevice(); }},
+      {msg::REQ_START_APP, [](Handler& hdl, Req req) { hdl.handleReqStartApp(req); }},
+
+      /* Device information */
+      {msg::REQ_DEV_INFO_BOOTLOADER_VERSION, [](Handler& hdl, Req) { hdl.handleReqInfoBootloaderVer(); }},
+      {msg::REQ_DEV_INFO_BOOTLOADER_CRC, [](Handler& hdl, Req) { hdl.handleReqInfoBootloaderCRC(); }},
+      {msg::REQ_DEV_INFO_VID, [](Handler& hdl, Req) { hdl.handleReqInfoVendorID(); }},
+      {msg::REQ_DEV_INFO_PID, [](Handler& hdl, Req) { hdl.handleReqInfoProductID(); }},
+      {msg::REQ_DEV_INFO_PRD, [](Handler& hdl, Req) { hdl.handleReqInfoProductionDate(); }},
+      {msg::REQ_DEV_INFO_UID_1, [](Handler& hdl, Req req) { hdl.handleReqInfoUniqueID(req.request); }},
+      {msg::REQ_DEV_INFO_UID_2, [](Handler& hdl, Req req) { hdl.handleReqInfoUniqueID(req.request); }},
+      {msg::REQ_DEV_INFO_UID_3, [](Handler& hdl, Req req) { hdl.handleReqInfoUniqueID(req.request); }},
+      {msg::REQ_DEV_INFO_UID_4, [](Handler& hdl, Req req) { hdl.handleReqInfoUniqueID(req.request); }},
+      {msg::REQ_DEV_INFO_INVENTORY, [](Handler& hdl, Req) { hdl.handleReqInfoInventory(); }},
+      {msg::REQ_DEV_INFO_CAPABILITIES, [](Handler& hdl, Req) { hdl.handleReqInfoCapabilities(); }},
+
+      /* Flash information */
+      {msg::REQ_FLASH_INFO_START_ADDR, [](Handler& hdl, Req) { hdl.handleReqFlashStartAddress(); }},
+      {msg::REQ_FLASH_INFO_PAGE_SIZE, [](Handler& hdl, Req) { hdl.handleReqFlashPageSize(); }},
+      {msg::REQ_FLASH_INFO_NUM_PAGES, [](Handler& hdl, Req) { hdl.handleReqFlashNumPages(); }},
+
+      /* App information */
+      {msg::REQ_APP_INFO_PAGE_IDX, [](Handler& hdl, Req) { hdl.handleReqAppPageIdx(); }},
+      {msg::REQ_APP_INFO_CRC_CALC, [](Handler& hdl, Req) { hdl.handleReqAppCrcCalc(); }},
+      {msg::REQ_APP_INFO_CRC_STRD, [](Handler& hdl, Req) { hdl.handleReqAppCrcStrd(); }},
+
+      /* Flash read commands */
+      {msg::REQ_FLASH_READ_WORD, [](Handler& hdl, Req req) { hdl.handleReqFlashReadWord(req); }},
+      {msg::REQ_FLASH_READ_BLOCK, [](Handler& hdl, Req req) { hdl.handleReqFlashReadBlock(req); }},
+      {msg::REQ_FLASH_READ_PAGE_CRC, [](Handler& hdl, Req req) { hdl.handleReqFlashReadPageCrc(req); }},
+      {msg::REQ_FLASH_READ_CRC, [](Handler& hdl, Req req) { hdl.handleReqFlashReadCrc(req); }},
+
+      /* Page buffer commands */
+      {msg::REQ_PAGE_BUFFER_CLEAR, [](Handler& hdl, Req) { hdl.handleReqPageBufferClear(); }},
+      {msg::REQ_PAGE_BUFFER_READ_WORD, [](Handler& hdl, Req req) { hdl.handleReqPageBufferReadWord(req); }},
+      {msg::REQ_PAGE_BUFFER_WRITE_WORD, [](Handler& hdl, Req req) { hdl.handleReqPageBufferWriteWord(req); }},
+      {msg::REQ_PAGE_BUFFER_STREAM_WORD, [](Handler& hdl, Req req) { hdl.handleReqPageBufferStreamWord(req); }},
+      {msg::REQ_PAGE_BUFFER_WRITE_BLOCK,
+       [](Handler& hdl, Req req) { hdl.handleReqPageBufferWriteBlock(req, nullptr, 0U); }},
+      {msg::REQ_PAGE_BUFFER_MISSING_WORDS, [](Handler& hdl, Req req) { hdl.handleReqPageBufferMissingWords(req); }},
+      {msg::REQ_PAGE_BUFFER_WRITE_WORD_AT, [](Handler& hdl, Req req) { hdl.handleReqPageBufferWriteWordAt(req); }},
+      {msg::REQ_PAGE_BUFFER_WRITE_BLOCK_AT,
+       [](Handler& hdl, Req req) { hdl.handleReqPageBufferWriteBlockAt(req, nullptr, 0U); }},
+      {msg::REQ_PAGE_BUFFER_STATUS, [](Handler& hdl, Req) { hdl.handleReqPageBufferStatus(); }},
+      {msg::REQ_PAGE_BUFFER_WRITE_COMPRESSED,
+       [](Handler& hdl, Req req) { hdl.handleReqPageBufferWriteCompressed(req); }},
+      {msg::REQ_PAGE_BUFFER_COPY_FROM_FLASH, [](Handler& hdl, Req req) { hdl.handleReqPageBufferCopyFromFlash(req); }},
+      {msg::REQ_PAGE_BUFFER_FILL, [](Handler& hdl, Req req) { hdl.handleReqPageBufferFill(req); }},
+      {msg::REQ_PAGE_BUFFER_CALC_CRC, [](Handler& hdl, Req) { hdl.handleReqPageBufferCalcCrc(); }},
+      {msg::REQ_PAGE_BUFFER_WRITE_TO_FLASH, [](Handler& hdl, Req req) { hdl.handleReqPageBufferWriteToFlash(req); }},
+      {msg::REQ_PAGE_BUFFER_COMMIT_STATUS, [](Handler& hdl, Req req) { hdl.handleReqPageBufferCommitStatus(req); }},
+
+      /* Flash write commands */
+      {msg::REQ_FLASH_WRITE_ERASE_PAGE, [](Handler& hdl, Req req) { hdl.handleReqFlashWriteErasePage(req); }},
+      {msg::REQ_FLASH_WRITE_APP_CRC, [](Handler& hdl, Req req) { hdl.handleReqFlashWriteAppCrc(req); }},
+      {msg::REQ_FLASH_WRITE_ERASE_RANGE, [](Handler& hdl, Req req) { hdl.handleReqFlashWriteEraseRange(req); }},
+      {msg::REQ_FLASH_WRITE_ERASE_STATUS, [](Handler& hdl, Req) { hdl.handleReqFlashWriteEraseStatus(); }},
+  });
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+constexpr bool FRANKLYBOOT_HANDLER_TEMPL_PREFIX::isExtensionRequest(const msg::RequestType request) {
+  return ((static_cast<msg::RequestType>(REQUEST_EXTENSIONS::REQUEST) == request) || ...);
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+constexpr bool FRANKLYBOOT_HANDLER_TEMPL_PREFIX::isBuiltinRequestActive(
+    const std::initializer_list<msg::RequestType> requests) {
+  bool requests_active = true;
+  for (const auto request : requests) {
+    requests_active = requests_active && !isExtensionRequest(request);
+  }
+
+  return requests_active;
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+constexpr uint32_t FRANKLYBOOT_HANDLER_TEMPL_PREFIX::createCapabilityFeatures() {
+  uint32_t features = 0U;
+
+  /* A feature is only reported if all of its built-in requests are in the dispatch table */
+  const auto add_feature = [&features](const msg::CapabilityFeature feature, const bool feature_active) {
+    features |= feature_active ? static_cast<uint32_t>(feature) : 0U;
+  };
+
+  const bool write_active = isBuiltinRequestActive({msg::REQ_PAGE_BUFFER_WRITE_TO_FLASH});
+
+  add_feature(msg::FEATURE_INVENTORY, isBuiltinRequestActive({msg::REQ_DEV_INFO_INVENTORY}));
+  add_feature(msg::FEATURE_FLASH_READ_BLOCK,
+              isBuiltinRequestActive(
+                  {msg::REQ_FLASH_READ_BLOCK, msg::REQ_FLASH_READ_PAGE_CRC, msg::REQ_FLASH_READ_CRC}));
+  add_feature(msg::FEATURE_STREAM_WORD, isBuiltinRequestActive({msg::REQ_PAGE_BUFFER_STREAM_WORD}));
+  add_feature(msg::FEATURE_MISSING_WORDS,
+              isBuiltinRequestActive({msg::REQ_PAGE_BUFFER_MISSING_WORDS, msg::REQ_PAGE_BUFFER_STATUS}));
+  add_feature(msg::FEATURE_RANDOM_ACCESS,
+              isBuiltinRequestActive({msg::REQ_PAGE_BUFFER_WRITE_WORD_AT, msg::REQ_PAGE_BUFFER_WRITE_BLOCK_AT}));
+  add_feature(msg::FEATURE_COMPRESSION, (DECOMPRESSION_WINDOW_BITS > 0U) &&
+                                            isBuiltinRequestActive({msg::REQ_PAGE_BUFFER_WRITE_COMPRESSED}));
+  add_feature(msg::FEATURE_COPY_FROM_FLASH, isBuiltinRequestActive({msg::REQ_PAGE_BUFFER_COPY_FROM_FLASH}));
+  add_feature(msg::FEATURE_FILL, isBuiltinRequestActive({msg::REQ_PAGE_BUFFER_FILL}));
+  add_feature(msg::FEATURE_WRITE_COMPARE, write_active);
+  add_feature(msg::FEATURE_WRITE_VERIFY, write_active);
+  add_feature(msg::FEATURE_REQUEST_QUEUE, QUEUE_SIZE > 0U);
+  add_feature(msg::FEATURE_ERASE_RANGE,
+              isBuiltinRequestActive({msg::REQ_FLASH_WRITE_ERASE_RANGE, msg::REQ_FLASH_WRITE_ERASE_STATUS}));
+  add_feature(msg::FEATURE_WRITE_DEFER, ((NUM_PAGE_BUFFERS > 1U) || ASYNC_FLASH) && write_active &&
+                                            isBuiltinRequestActive({msg::REQ_PAGE_BUFFER_COMMIT_STATUS}));
+
+  return features;
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+constexpr uint32_t FRANKLYBOOT_HANDLER_TEMPL_PREFIX::getNumRequests() {
+  uint32_t num_requests = sizeof...(REQUEST_EXTENSIONS);
+  for (const auto& entry : createBuiltinRequests()) {
+    num_requests += isExtensionRequest(entry.request) ? 0U : 1U;
+  }
+
+  return num_requests;
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+constexpr auto FRANKLYBOOT_HANDLER_TEMPL_PREFIX::createRequestTable() {
+  std::array<RequestEntry, NUM_REQUESTS> table = {};
+  uint32_t entry_idx = 0U;
+
+  /* Built-in requests replaced by an extension are dropped, so their handlers are not referenced */
+  for (const auto& entry : createBuiltinRequests()) {
+    if (!isExtensionRequest(entry.request)) {
+      table[entry_idx] = entry;
+      entry_idx++;
+    }
+  }
+
+  ((table[entry_idx++] = RequestEntry{static_cast<msg::RequestType>(REQUEST_EXTENSIONS::REQUEST),
+                                      &processExtensionRequest<REQUEST_EXTENSIONS>}),
+   ...);
+
+  return table;
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+constexpr uint32_t FRANKLYBOOT_HANDLER_TEMPL_PREFIX::findRequestHashSize() {
+  for (uint32_t hash_size = NUM_REQUESTS; hash_size <= REQUEST_HASH_SIZE_MAX; hash_size++) {
+    std::array<bool, REQUEST_HASH_SIZE_MAX> slot_used = {};
+    bool collision = false;
+
+    for (const auto& entry : REQUEST_TABLE) {
+      const uint32_t slot = entry.request % hash_size;
+      collision = collision || slot_used[slot];
+      slot_used[slot] = true;
+    }
+
+    if (!collision) {
+      return hash_size;
+    }
+  }
+
+  /* Duplicated request ids (static assertion) */
+  return REQUEST_HASH_SIZE_MAX + 1U;
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+constexpr auto FRANKLYBOOT_HANDLER_TEMPL_PREFIX::createRequestHash() {
+  std::array<uint8_t, REQUEST_HASH_SIZE> hash = {};
+  for (auto& slot : hash) {
+    slot = static_cast<uint8_t>(NUM_REQUESTS);
+  }
+
+  for (uint32_t entry_idx = 0U; entry_idx < NUM_REQUESTS; entry_idx++) {
+    hash[REQUEST_TABLE[entry_idx].request % REQUEST_HASH_SIZE] = static_cast<uint8_t>(entry_idx);
+  }
+
+  return hash;
+}
+
 // Basic Info Requests ------------------------------------------------------------------------------------------------
 
 FRANKLYBOOT_HANDLER_TEMPL
 void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqPing() {
   /* Transmit bootloader version as ping response */
-  this->_response = msg::Msg(msg::REQ_PING, msg::RES_OK, 0);
+  this->_response = Msg(msg::REQ_PING, msg::RES_OK, 0);
 
   for (auto idx = 0U; idx < this->_response.data.size(); idx++) {
     if (idx < version::VERSION.size()) {
@@ -204,15 +444,15 @@ void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqPing() {
 FRANKLYBOOT_HANDLER_TEMPL
 void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqResetDevice() {
   /* Queue reset device command */
-  this->_response = msg::Msg(msg::REQ_RESET_DEVICE, msg::RES_OK, 0);
+  this->_response = Msg(msg::REQ_RESET_DEVICE, msg::RES_OK, 0);
   this->_cmd_buffer = CommandBuffer::RESET_DEVICE;
 }
 
 FRANKLYBOOT_HANDLER_TEMPL
-void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqStartApp(const msg::Msg& request) {
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqStartApp(const Msg& request) {
   constexpr uint32_t START_APP_UNSAFE_WORD = 0xFFFFFFFFU;
 
-  this->_response = msg::Msg(msg::REQ_START_APP, msg::RES_ERR, 0);
+  this->_response = Msg(msg::REQ_START_APP, msg::RES_ERR, 0);
 
   const bool start_app_safe = (msg::convertMsgDataToU32(request.data) != START_APP_UNSAFE_WORD);
   if (start_app_safe) {
@@ -234,7 +474,7 @@ void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqStartApp(const msg::Msg& request
 
 FRANKLYBOOT_HANDLER_TEMPL
 void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqInfoBootloaderVer() {
-  this->_response = msg::Msg(msg::REQ_DEV_INFO_BOOTLOADER_VERSION, msg::RES_OK, 0);
+  this->_response = Msg(msg::REQ_DEV_INFO_BOOTLOADER_VERSION, msg::RES_OK, 0);
   this->_response.data[0] = version::VERSION[0];
   this->_response.data[1] = version::VERSION[1];
   this->_response.data[2] = version::VERSION[2];
@@ -244,46 +484,46 @@ FRANKLYBOOT_HANDLER_TEMPL
 void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqInfoBootloaderCRC() {
   const uint32_t bootl_start_addr = FLASH_START;
   const uint32_t bootl_size = FLASH_APP_FIRST_PAGE * FLASH_PAGE_SIZE;
-  const uint32_t crc_value = hwi::calculateCRC(bootl_start_addr, bootl_size);
+  const uint32_t crc_value = this->_hwi.calculateCRC(bootl_start_addr, bootl_size);
 
-  this->_response = msg::Msg(msg::REQ_DEV_INFO_BOOTLOADER_CRC, msg::RES_OK, 0);
+  this->_response = Msg(msg::REQ_DEV_INFO_BOOTLOADER_CRC, msg::RES_OK, 0);
   msg::convertU32ToMsgData(crc_value, this->_response.data);
 }
 
 FRANKLYBOOT_HANDLER_TEMPL
 void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqInfoVendorID() {
-  this->_response = msg::Msg(msg::REQ_DEV_INFO_VID, msg::RES_OK, 0);
-  msg::convertU32ToMsgData(hwi::getVendorID(), this->_response.data);
+  this->_response = Msg(msg::REQ_DEV_INFO_VID, msg::RES_OK, 0);
+  msg::convertU32ToMsgData(this->_hwi.getVendorID(), this->_response.data);
 }
 
 FRANKLYBOOT_HANDLER_TEMPL
 void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqInfoProductID() {
-  this->_response = msg::Msg(msg::REQ_DEV_INFO_PID, msg::RES_OK, 0);
-  msg::convertU32ToMsgData(hwi::getProductID(), this->_response.data);
+  this->_response = Msg(msg::REQ_DEV_INFO_PID, msg::RES_OK, 0);
+  msg::convertU32ToMsgData(this->_hwi.getProductID(), this->_response.data);
 }
 
 FRANKLYBOOT_HANDLER_TEMPL
 void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqInfoProductionDate() {
-  this->_response = msg::Msg(msg::REQ_DEV_INFO_PRD, msg::RES_OK, 0);
-  msg::convertU32ToMsgData(hwi::getProductionDate(), this->_response.data);
+  this->_response = Msg(msg::REQ_DEV_INFO_PRD, msg::RES_OK, 0);
+  msg::convertU32ToMsgData(this->_hwi.getProductionDate(), this->_response.data);
 }
 
 FRANKLYBOOT_HANDLER_TEMPL
 void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqInfoUniqueID(const msg::RequestType request) {
-  this->_response = msg::Msg(request, msg::RES_OK, 0);
+  this->_response = Msg(request, msg::RES_OK, 0);
   uint32_t data;
   switch (request) {
     case msg::REQ_DEV_INFO_UID_1:
-      data = hwi::getUniqueIDWord(0);
+      data = this->_hwi.getUniqueIDWord(0);
       break;
     case msg::REQ_DEV_INFO_UID_2:
-      data = hwi::getUniqueIDWord(1);
+      data = this->_hwi.getUniqueIDWord(1);
       break;
     case msg::REQ_DEV_INFO_UID_3:
-      data = hwi::getUniqueIDWord(2);
+      data = this->_hwi.getUniqueIDWord(2);
       break;
     case msg::REQ_DEV_INFO_UID_4:
-      data = hwi::getUniqueIDWord(3);
+      data = this->_hwi.getUniqueIDWord(3);
       break;
     default:
       data = 0U;
@@ -293,23 +533,39 @@ void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqInfoUniqueID(const msg::RequestT
   msg::convertU32ToMsgData(data, this->_response.data);
 }
 
+FRANKLYBOOT_HANDLER_TEMPL
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqInfoInventory() {
+  this->_response_stream = ResponseStream::INVENTORY;
+  this->_response_stream_idx = 0U;
+  this->_response_stream_num = (msg::INV_NUM_FIELDS + INVENTORY_FIELDS_PER_MSG - 1U) / INVENTORY_FIELDS_PER_MSG;
+  createFieldsResponse();
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqInfoCapabilities() {
+  this->_response_stream = ResponseStream::CAPABILITIES;
+  this->_response_stream_idx = 0U;
+  this->_response_stream_num = (msg::CAP_NUM_FIELDS + INVENTORY_FIELDS_PER_MSG - 1U) / INVENTORY_FIELDS_PER_MSG;
+  createFieldsResponse();
+}
+
 // Flash Info Requests ------------------------------------------------------------------------------------------------
 
 FRANKLYBOOT_HANDLER_TEMPL
 void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqFlashStartAddress() {
-  this->_response = msg::Msg(msg::REQ_FLASH_INFO_START_ADDR, msg::RES_OK, 0);
+  this->_response = Msg(msg::REQ_FLASH_INFO_START_ADDR, msg::RES_OK, 0);
   msg::convertU32ToMsgData(FLASH_START, this->_response.data);
 }
 
 FRANKLYBOOT_HANDLER_TEMPL
 void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqFlashPageSize() {
-  this->_response = msg::Msg(msg::REQ_FLASH_INFO_PAGE_SIZE, msg::RES_OK, 0);
+  this->_response = Msg(msg::REQ_FLASH_INFO_PAGE_SIZE, msg::RES_OK, 0);
   msg::convertU32ToMsgData(FLASH_PAGE_SIZE, this->_response.data);
 }
 
 FRANKLYBOOT_HANDLER_TEMPL
 void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqFlashNumPages() {
-  this->_response = msg::Msg(msg::REQ_FLASH_INFO_NUM_PAGES, msg::RES_OK, 0);
+  this->_response = Msg(msg::REQ_FLASH_INFO_NUM_PAGES, msg::RES_OK, 0);
   msg::convertU32ToMsgData(FLASH_NUM_PAGES, this->_response.data);
 }
 
@@ -317,29 +573,29 @@ void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqFlashNumPages() {
 
 FRANKLYBOOT_HANDLER_TEMPL
 void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqAppPageIdx() {
-  this->_response = msg::Msg(msg::REQ_APP_INFO_PAGE_IDX, msg::RES_OK, 0);
+  this->_response = Msg(msg::REQ_APP_INFO_PAGE_IDX, msg::RES_OK, 0);
   msg::convertU32ToMsgData(FLASH_APP_FIRST_PAGE, this->_response.data);
 }
 
 FRANKLYBOOT_HANDLER_TEMPL
 void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqAppCrcCalc() {
   uint32_t crc_value_calc = this->calcAppCRC();
-  this->_response = msg::Msg(msg::REQ_APP_INFO_CRC_CALC, msg::RES_OK, 0);
+  this->_response = Msg(msg::REQ_APP_INFO_CRC_CALC, msg::RES_OK, 0);
   msg::convertU32ToMsgData(crc_value_calc, this->_response.data);
 }
 
 FRANKLYBOOT_HANDLER_TEMPL
 void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqAppCrcStrd() {
   uint32_t crc_value_stored = this->readAppCRCFromFlash();
-  this->_response = msg::Msg(msg::REQ_APP_INFO_CRC_STRD, msg::RES_OK, 0);
+  this->_response = Msg(msg::REQ_APP_INFO_CRC_STRD, msg::RES_OK, 0);
   msg::convertU32ToMsgData(crc_value_stored, this->_response.data);
 }
 
 // Flash Read Requests ------------------------------------------------------------------------------------------------
 
 FRANKLYBOOT_HANDLER_TEMPL
-void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqFlashReadWord(const msg::Msg& request) {
-  this->_response = msg::Msg(msg::REQ_FLASH_READ_WORD, msg::RES_ERR, request.packet_id);
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqFlashReadWord(const Msg& request) {
+  this->_response = Msg(msg::REQ_FLASH_READ_WORD, msg::RES_ERR, request.packet_id);
 
   const uint32_t src_address = msg::convertMsgDataToU32(request.data);
   const bool address_inside_low_limit = (src_address >= FLASH_START);
@@ -348,7 +604,7 @@ void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqFlashReadWord(const msg::Msg& re
 
   if (address_valid) {
     for (auto idx = 0U; idx < this->_response.data.size(); idx++) {
-      this->_response.data[idx] = hwi::readByteFromFlash(src_address + idx);
+      this->_response.data[idx] = this->_hwi.readByteFromFlash(src_address + idx);
     }
     this->_response.result = msg::RES_OK;
   } else {
@@ -356,24 +612,80 @@ void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqFlashReadWord(const msg::Msg& re
   }
 }
 
+FRANKLYBOOT_HANDLER_TEMPL
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqFlashReadBlock(const Msg& request) {
+  this->_response = Msg(msg::REQ_FLASH_READ_BLOCK, msg::RES_ERR, request.packet_id);
+
+  uint32_t src_address = 0U;
+  uint32_t num_bytes = 0U;
+  if (receiveFlashRangeArgs(request, src_address, num_bytes)) {
+    this->_flash_read_address = src_address;
+    this->_flash_read_num_bytes = num_bytes;
+    this->_response_stream = ResponseStream::FLASH_READ_BLOCK;
+    this->_response_stream_idx = 0U;
+    this->_response_stream_num = (num_bytes + MSG_DATA_SIZE - 1U) / MSG_DATA_SIZE;
+    createFlashReadBlockResponse();
+  } else {
+    this->_response.result = msg::RES_ERR_INVLD_ARG;
+  }
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqFlashReadPageCrc(const Msg& request) {
+  constexpr uint32_t NUM_BITS_PER_BYTE = 8U;
+
+  this->_response = Msg(msg::REQ_FLASH_READ_PAGE_CRC, msg::RES_ERR, request.packet_id);
+
+  /* Data: page index (u16) | number of pages (u16, 0 is handled as 1 page) */
+  const uint32_t page_idx = request.data[0U] | (request.data[1U] << NUM_BITS_PER_BYTE);
+  const uint32_t num_pages_req = request.data[2U] | (request.data[3U] << NUM_BITS_PER_BYTE);
+  const uint32_t num_pages = (num_pages_req > 0U) ? num_pages_req : 1U;
+
+  const bool page_idx_valid = (page_idx < FLASH_NUM_PAGES);
+  const bool num_pages_valid = (num_pages <= (FLASH_NUM_PAGES - page_idx));
+
+  if (page_idx_valid && num_pages_valid) {
+    const uint32_t src_address = FLASH_START + page_idx * FLASH_PAGE_SIZE;
+    const uint32_t crc_value = this->_hwi.calculateCRC(src_address, num_pages * FLASH_PAGE_SIZE);
+    msg::convertU32ToMsgData(crc_value, this->_response.data);
+    this->_response.result = msg::RES_OK;
+  } else {
+    this->_response.result = msg::RES_ERR_INVLD_ARG;
+  }
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqFlashReadCrc(const Msg& request) {
+  this->_response = Msg(msg::REQ_FLASH_READ_CRC, msg::RES_ERR, request.packet_id);
+
+  uint32_t src_address = 0U;
+  uint32_t num_bytes = 0U;
+  if (receiveFlashRangeArgs(request, src_address, num_bytes)) {
+    const uint32_t crc_value = this->_hwi.calculateCRC(src_address, num_bytes);
+    msg::convertU32ToMsgData(crc_value, this->_response.data);
+    this->_response.result = msg::RES_OK;
+  } else {
+    this->_response.result = msg::RES_ERR_INVLD_ARG;
+  }
+}
+
 // Page Buffer Requests -----------------------------------------------------------------------------------------------
 
 FRANKLYBOOT_HANDLER_TEMPL void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqPageBufferClear() {
-  this->_page_buffer.fill({std::numeric_limits<uint8_t>::max()});
-  this->_page_buffer_pos = 0U;
-  this->_response = msg::Msg(msg::REQ_PAGE_BUFFER_CLEAR, msg::RES_OK, 0);
+  this->clearPageBuffer();
+  this->_response = Msg(msg::REQ_PAGE_BUFFER_CLEAR, msg::RES_OK, 0);
 }
 
 FRANKLYBOOT_HANDLER_TEMPL
-void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqPageBufferReadWord(const msg::Msg& request) {
-  this->_response = msg::Msg(msg::REQ_PAGE_BUFFER_READ_WORD, msg::RES_ERR, request.packet_id);
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqPageBufferReadWord(const Msg& request) {
+  this->_response = Msg(msg::REQ_PAGE_BUFFER_READ_WORD, msg::RES_ERR, request.packet_id);
 
   const auto byte_idx = msg::convertMsgDataToU32(request.data);
-  const auto byte_idx_valid = ((byte_idx + this->_response.data.size()) <= _page_buffer.size());
+  const auto byte_idx_valid = ((byte_idx + this->_response.data.size()) <= getPageBuffer().size());
 
   if (byte_idx_valid) {
     for (auto idx = 0U; idx < this->_response.data.size(); idx++) {
-      this->_response.data[idx] = _page_buffer.at(byte_idx + idx);
+      this->_response.data[idx] = getPageBuffer().at(byte_idx + idx);
     }
     this->_response.result = msg::RES_OK;
   } else {
@@ -382,75 +694,356 @@ void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqPageBufferReadWord(const msg::Ms
 }
 
 FRANKLYBOOT_HANDLER_TEMPL
-void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqPageBufferWriteWord(const msg::Msg& request) {
-  this->_response = msg::Msg(msg::REQ_PAGE_BUFFER_WRITE_WORD, msg::RES_ERR, request.packet_id);
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqPageBufferWriteWord(const Msg& request) {
+  this->_response = Msg(msg::REQ_PAGE_BUFFER_WRITE_WORD, msg::RES_ERR, request.packet_id);
   this->_response.data = request.data;
 
-  const uint32_t data_size = sizeof(uint32_t);
+  /* Words ahead of the write position are accepted, so a lost word can be repeated later */
+  uint32_t word_idx = 0U;
+  const bool word_idx_valid = this->getPageBufferWordIdx(request.packet_id, word_idx);
+  const bool word_behind = (word_idx < (this->_page_buffer_pos / MSG_DATA_SIZE));
+  const bool buffer_overflow = (this->_page_buffer_pos >= this->getPageBuffer().size()) ||
+                               (word_idx_valid && (word_idx >= PAGE_BUFFER_NUM_WORDS));
+
+  if (word_idx_valid && !word_behind && !buffer_overflow) {
+    this->writeWordToPageBuffer(word_idx, request.data);
+    this->_response.result = msg::RES_OK;
+  } else if (buffer_overflow) {
+    this->_response.result = msg::RES_ERR_PAGE_FULL;
+  }
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqPageBufferStreamWord(const Msg& request) {
+  this->_response = Msg(msg::REQ_PAGE_BUFFER_STREAM_WORD, msg::RES_ERR, request.packet_id);
+
+  uint32_t word_idx = 0U;
+  const bool word_idx_valid = this->getPageBufferWordIdx(request.packet_id, word_idx);
+  const bool word_behind = (word_idx < (this->_page_buffer_pos / MSG_DATA_SIZE));
+  const bool buffer_overflow = (this->_page_buffer_pos >= this->getPageBuffer().size()) ||
+                               (word_idx_valid && (word_idx >= PAGE_BUFFER_NUM_WORDS));
+
+  if (buffer_overflow) {
+    this->_response.result = msg::RES_ERR_PAGE_FULL;
+  } else {
+    /* Words behind the write position are repetitions, words ahead of a gap are kept */
+    if (word_idx_valid && !word_behind) {
+      this->writeWordToPageBuffer(word_idx, request.data);
+    }
+
+    const uint32_t num_words_contiguous = (this->_page_buffer_pos + MSG_DATA_SIZE - 1U) / MSG_DATA_SIZE;
+    const bool gap_open = (this->_page_buffer_end_pos > this->_page_buffer_pos);
+    this->_response.packet_id = static_cast<uint8_t>(num_words_contiguous - 1U);
+
+    if (gap_open) {
+      /* Gap detected: report the highest contiguous packet id once, missing words are read by bitmap */
+      this->_response_avl = !this->_page_buffer_stream_gap;
+      this->_page_buffer_stream_gap = true;
+    } else {
+      /* Acknowledge the last word of a window or of the page (also if repeated) and a closed gap */
+      const bool window_complete = word_idx_valid && (((word_idx + 1U) % STREAM_WINDOW_SIZE) == 0U);
+      const bool buffer_full = (this->_page_buffer_pos >= this->getPageBuffer().size());
+
+      this->_response.result = msg::RES_OK;
+      this->_response_avl = window_complete || buffer_full || this->_page_buffer_stream_gap;
+      this->_page_buffer_stream_gap = false;
+    }
+  }
+
+  msg::convertU32ToMsgData(this->_page_buffer_pos, this->_response.data);
+}
 
-  const bool packet_id_valid =
-      ((this->_page_buffer_pos >> 2U) & std::numeric_limits<uint8_t>::max()) == request.packet_id;
+FRANKLYBOOT_HANDLER_TEMPL
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqPageBufferWriteBlock(const Msg& request, const uint8_t* block_ptr,
+                                                                     const uint32_t block_size) {
+  this->_response = Msg(msg::REQ_PAGE_BUFFER_WRITE_BLOCK, msg::RES_ERR, request.packet_id);
 
-  const bool buffer_overflow = (this->_page_buffer_pos + data_size) > this->_page_buffer.size();
+  /* Block has to continue exactly at the current write position of the page buffer */
+  const uint32_t byte_idx = msg::convertMsgDataToU32(request.data);
+  const bool byte_idx_valid = (byte_idx == this->_page_buffer_pos);
+  const bool block_valid = (block_ptr != nullptr) && (block_size > 0U);
+  const bool buffer_overflow = (this->_page_buffer_pos + block_size) > this->getPageBuffer().size();
 
-  if (packet_id_valid && !buffer_overflow) {
-    for (auto idx = 0U; idx < data_size; idx++) {
-      this->_page_buffer[this->_page_buffer_pos] = request.data[idx];
-      this->_page_buffer_pos++;
+  if (buffer_overflow) {
+    this->_response.result = msg::RES_ERR_PAGE_FULL;
+  } else if (byte_idx_valid && block_valid) {
+    /* Block is copied from the receive buffer of the transport, only complete and valid frames arrive here */
+    for (auto idx = 0U; idx < block_size; idx++) {
+      this->getPageBuffer()[this->_page_buffer_pos + idx] = block_ptr[idx];
     }
 
+    this->_page_buffer_pos += block_size;
+    this->markPageBufferWordsRcvd(byte_idx, block_size);
     this->_response.result = msg::RES_OK;
-  } else if (buffer_overflow) {
+  } else {
+    this->_response.result = msg::RES_ERR_INVLD_ARG;
+  }
+
+  msg::convertU32ToMsgData(this->_page_buffer_pos, this->_response.data);
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqPageBufferMissingWords(const Msg& request) {
+  this->_response = Msg(msg::REQ_PAGE_BUFFER_MISSING_WORDS, msg::RES_ERR, request.packet_id);
+
+  /* Bitmap covers the words from the requested word up to the highest word received */
+  const uint32_t start_word_idx = msg::convertMsgDataToU32(request.data);
+  const uint32_t end_word_idx = (this->_page_buffer_end_pos + MSG_DATA_SIZE - 1U) / MSG_DATA_SIZE;
+  const bool start_word_idx_valid = (start_word_idx < PAGE_BUFFER_NUM_WORDS);
+
+  if (start_word_idx_valid) {
+    const uint32_t num_words = (end_word_idx > start_word_idx) ? (end_word_idx - start_word_idx) : 0U;
+    const uint32_t num_frames = (num_words + MISSING_WORDS_PER_MSG - 1U) / MISSING_WORDS_PER_MSG;
+
+    this->_missing_words_start = start_word_idx;
+    this->_response_stream = ResponseStream::MISSING_WORDS;
+    this->_response_stream_idx = 0U;
+    this->_response_stream_num = (num_frames > 0U) ? num_frames : 1U;
+    createMissingWordsResponse();
+  } else {
+    this->_response.result = msg::RES_ERR_INVLD_ARG;
+  }
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqPageBufferWriteWordAt(const Msg& request) {
+  constexpr uint32_t NUM_BITS_PER_BYTE = 8U;
+
+  /* Word index does not wrap: low byte is transmitted as packet id, high byte in the result field */
+  const uint32_t word_idx = request.packet_id | (static_cast<uint32_t>(request.result) << NUM_BITS_PER_BYTE);
+  const bool word_idx_valid = (word_idx < PAGE_BUFFER_NUM_WORDS);
+
+  this->_response = Msg(msg::REQ_PAGE_BUFFER_WRITE_WORD_AT, msg::RES_ERR_INVLD_ARG, request.packet_id);
+
+  if (word_idx_valid) {
+    this->writeWordToPageBuffer(word_idx, request.data);
+    this->_page_buffer_random_access = true;
+    this->_response.result = msg::RES_OK;
+  }
+
+  msg::convertU32ToMsgData(word_idx * MSG_DATA_SIZE, this->_response.data);
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqPageBufferWriteBlockAt(const Msg& request, const uint8_t* block_ptr,
+                                                                       const uint32_t block_size) {
+  this->_response = Msg(msg::REQ_PAGE_BUFFER_WRITE_BLOCK_AT, msg::RES_ERR, request.packet_id);
+
+  /* Block is placed at any word boundary, independent of the write position (e.g. filled by multiple links) */
+  const auto page_size = static_cast<uint32_t>(this->getPageBuffer().size());
+  const uint32_t byte_idx = msg::convertMsgDataToU32(request.data);
+  const bool byte_idx_valid = (byte_idx < page_size) && ((byte_idx % MSG_DATA_SIZE) == 0U);
+  const bool block_valid = (block_ptr != nullptr) && (block_size > 0U);
+  const bool buffer_overflow = byte_idx_valid && (block_size > (page_size - byte_idx));
+
+  if (buffer_overflow) {
     this->_response.result = msg::RES_ERR_PAGE_FULL;
+  } else if (byte_idx_valid && block_valid) {
+    for (auto idx = 0U; idx < block_size; idx++) {
+      this->getPageBuffer()[byte_idx + idx] = block_ptr[idx];
+    }
+
+    this->markPageBufferWordsRcvd(byte_idx, block_size);
+    this->_page_buffer_random_access = true;
+    this->_response.result = msg::RES_OK;
+  } else {
+    this->_response.result = msg::RES_ERR_INVLD_ARG;
+  }
+
+  msg::convertU32ToMsgData(byte_idx + block_size, this->_response.data);
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqPageBufferStatus() {
+  /* Packet id is the index of the receiving page buffer */
+  this->_response = Msg(msg::REQ_PAGE_BUFFER_STATUS, msg::RES_OK, static_cast<uint8_t>(this->_page_buffer_idx));
+
+  const auto num_words_rcvd = static_cast<uint32_t>(this->_page_buffer_words_rcvd.count());
+  msg::convertU32ToMsgData(num_words_rcvd, this->_response.data);
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqPageBufferWriteCompressed(const Msg& request) {
+  this->_response = Msg(msg::REQ_PAGE_BUFFER_WRITE_COMPRESSED, msg::RES_ERR_NOT_SUPPORTED, request.packet_id);
+
+  if constexpr (DECOMPRESSION_WINDOW_BITS > 0U) {
+    /* Frames are decoded in order straight into the page buffer, acknowledged once per window like streamed words */
+    const auto expected_packet_id = static_cast<uint8_t>(this->_page_buffer_compressed_idx);
+    const bool packet_id_valid = (expected_packet_id == request.packet_id);
+    const bool pos_valid = (this->_page_buffer_pos == this->_page_buffer_decoder.getNumBytesDecoded());
+
+    if (!this->_page_buffer_decoder.isValid() || !pos_valid) {
+      this->_response.result = msg::RES_ERR_INVLD_ARG;
+    } else if (this->_page_buffer_decoder.isComplete()) {
+      this->_response.result = msg::RES_ERR_PAGE_FULL;
+    } else if (packet_id_valid) {
+      const uint32_t byte_idx = this->_page_buffer_pos;
+      const bool data_valid =
+          this->_page_buffer_decoder.processData(this->getPageBuffer().data(), request.data.data(), MSG_DATA_SIZE);
+
+      this->_page_buffer_pos = this->_page_buffer_decoder.getNumBytesDecoded();
+      this->markPageBufferWordsRcvd(byte_idx, this->_page_buffer_pos - byte_idx);
+      this->_page_buffer_compressed_idx++;
+
+      const bool window_complete = ((this->_page_buffer_compressed_idx % STREAM_WINDOW_SIZE) == 0U);
+      const bool page_complete = this->_page_buffer_decoder.isComplete();
+
+      this->_response.result = data_valid ? msg::RES_OK : msg::RES_ERR_INVLD_ARG;
+      this->_response_avl = window_complete || page_complete || !data_valid || this->_page_buffer_stream_gap;
+      this->_page_buffer_stream_gap = false;
+    } else {
+      /* Gap detected: report the last frame decoded once, host resends starting with the next frame */
+      this->_response.result = msg::RES_ERR;
+      this->_response.packet_id = static_cast<uint8_t>(expected_packet_id - 1U);
+      this->_response_avl = !this->_page_buffer_stream_gap;
+      this->_page_buffer_stream_gap = true;
+    }
+
+    msg::convertU32ToMsgData(this->_page_buffer_pos, this->_response.data);
+  }
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqPageBufferCopyFromFlash(const Msg& request) {
+  this->_response = Msg(msg::REQ_PAGE_BUFFER_COPY_FROM_FLASH, msg::RES_ERR_INVLD_ARG, request.packet_id);
+
+  uint32_t num_bytes = 0U;
+  const auto range_result = this->getPageBufferWordsRange(request, num_bytes);
+  const uint32_t src_offset = msg::convertMsgDataToU32(request.data);
+  const bool src_valid = (src_offset <= FLASH_SIZE) && (num_bytes <= (FLASH_SIZE - src_offset));
+
+  if (range_result != msg::RES_OK) {
+    this->_response.result = range_result;
+  } else if (src_valid) {
+    /* Source is read now: pages referenced by later copies must not be written before (see docs) */
+    const uint32_t byte_idx = this->_page_buffer_pos;
+    for (auto idx = 0U; idx < num_bytes; idx++) {
+      this->getPageBuffer()[byte_idx + idx] = this->_hwi.readByteFromFlash(FLASH_START + src_offset + idx);
+    }
+
+    this->_page_buffer_pos += num_bytes;
+    this->markPageBufferWordsRcvd(byte_idx, num_bytes);
+    this->_response.result = msg::RES_OK;
+  }
+
+  msg::convertU32ToMsgData(this->_page_buffer_pos, this->_response.data);
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqPageBufferFill(const Msg& request) {
+  constexpr uint32_t PATTERN_SIZE = 4U;
+
+  this->_response = Msg(msg::REQ_PAGE_BUFFER_FILL, msg::RES_ERR_INVLD_ARG, request.packet_id);
+
+  uint32_t num_bytes = 0U;
+  const auto range_result = this->getPageBufferWordsRange(request, num_bytes);
+
+  if (range_result == msg::RES_OK) {
+    /* Pattern is aligned to the page (byte n of the page is byte n % 4 of the pattern) */
+    const uint32_t byte_idx = this->_page_buffer_pos;
+    for (auto idx = byte_idx; idx < (byte_idx + num_bytes); idx++) {
+      this->getPageBuffer()[idx] = request.data[idx % PATTERN_SIZE];
+    }
+
+    this->_page_buffer_pos += num_bytes;
+    this->markPageBufferWordsRcvd(byte_idx, num_bytes);
   }
+
+  this->_response.result = range_result;
+  msg::convertU32ToMsgData(this->_page_buffer_pos, this->_response.data);
 }
 
 FRANKLYBOOT_HANDLER_TEMPL
 void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqPageBufferCalcCrc() {
-  this->_response = msg::Msg(msg::REQ_PAGE_BUFFER_CALC_CRC, msg::RES_OK, 0);
+  this->_response = Msg(msg::REQ_PAGE_BUFFER_CALC_CRC, msg::RES_OK, 0);
 
   uint32_t page_buffer_address = getPageBufferAddress();
-  const uint32_t crc_value = hwi::calculateCRC(page_buffer_address, _page_buffer.size());
+  const uint32_t crc_value = this->_hwi.calculateCRC(page_buffer_address, getPageBuffer().size());
 
   msg::convertU32ToMsgData(crc_value, this->_response.data);
 }
 
 FRANKLYBOOT_HANDLER_TEMPL
-void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqPageBufferWriteToFlash(const msg::Msg& request) {
-  this->_response = msg::Msg(msg::REQ_PAGE_BUFFER_WRITE_TO_FLASH, msg::RES_ERR, 0);
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqPageBufferWriteToFlash(const Msg& request) {
+  /* Packet id is the index of the page buffer written */
+  const auto buffer_idx = static_cast<uint8_t>(this->_page_buffer_idx);
+  this->_response = Msg(msg::REQ_PAGE_BUFFER_WRITE_TO_FLASH, msg::RES_ERR, buffer_idx);
   this->_response.data = request.data;
 
   const uint32_t page_id = msg::convertMsgDataToU32(request.data);
   const uint32_t address = FLASH_START + FLASH_PAGE_SIZE * page_id;
   const bool address_valid = (address >= FLASH_START && address < (FLASH_START + FLASH_SIZE));
+  const bool defer = ((request.result & msg::WRITE_TO_FLASH_DEFER) != 0U) && ((NUM_PAGE_BUFFERS > 1U) || ASYNC_FLASH);
 
-  if (address_valid) {
-    const auto erase_result = hwi::eraseFlashPage(page_id);
+  /* Deferred writes are queued as long as the next page buffer is free, direct writes wait for the queue */
+  const uint32_t next_buffer_idx = (this->_page_buffer_idx + 1U) % NUM_PAGE_BUFFERS;
+  const bool busy = defer ? (this->_page_commits[next_buffer_idx].result == msg::RES_BUSY) : isPageCommitPending();
 
-    if (erase_result) {
-      const bool flash_result = hwi::writeDataBufferToFlash(address, page_id, _page_buffer.data(), _page_buffer.size());
+  if (!address_valid) {
+    this->_response.result = msg::RES_ERR_INVLD_ARG;
+  } else if (!this->isPageBufferComplete()) {
+    this->_response.result = msg::RES_ERR_PAGE_INCOMPLETE;
+  } else if (busy) {
+    this->_response.result = msg::RES_BUSY;
+  } else {
+    auto& commit = this->_page_commits[this->_page_buffer_idx];
+    commit.page_id = page_id;
+    commit.flags = static_cast<uint8_t>(request.result);
+
+    if (defer) {
+      /* Page buffer is written by processBufferedCmds(), the next page buffer receives meanwhile (a single page
+         buffer is locked until it is written) */
+      commit.result = msg::RES_BUSY;
+      if (next_buffer_idx != this->_page_buffer_idx) {
+        this->_page_buffer_idx = next_buffer_idx;
+        this->clearPageBuffer();
+      }
+      this->_response.result = msg::RES_OK;
+    } else {
+      this->commitPageBuffer(this->_page_buffer_idx);
+      this->_response.result = commit.result;
 
-      if (flash_result) {
-        this->_response.result = msg::RES_OK;
+      /* Committed page is proven by the CRC of the flash page instead of the echoed page index */
+      const bool verify = ((commit.flags & msg::WRITE_TO_FLASH_VERIFY) != 0U);
+      if (verify && (commit.result != msg::RES_ERR)) {
+        msg::convertU32ToMsgData(commit.crc, this->_response.data);
       }
     }
-  } else {
-    this->_response.result = msg::RES_ERR_INVLD_ARG;
+  }
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqPageBufferCommitStatus(const Msg& request) {
+  const uint32_t buffer_idx = msg::convertMsgDataToU32(request.data);
+  const bool buffer_idx_valid = (buffer_idx < NUM_PAGE_BUFFERS);
+
+  this->_response = Msg(msg::REQ_PAGE_BUFFER_COMMIT_STATUS, msg::RES_ERR_INVLD_ARG, static_cast<uint8_t>(buffer_idx));
+  this->_response.data = request.data;
+
+  if (buffer_idx_valid) {
+    /* Same result and data as the response of a direct REQ_PAGE_BUFFER_WRITE_TO_FLASH */
+    const auto& commit = this->_page_commits[buffer_idx];
+    const bool verify = ((commit.flags & msg::WRITE_TO_FLASH_VERIFY) != 0U);
+    const bool crc_avl = verify && (commit.result != msg::RES_ERR) && (commit.result != msg::RES_BUSY) &&
+                         (commit.result != msg::RES_NONE);
+
+    this->_response.result = commit.result;
+    msg::convertU32ToMsgData(crc_avl ? commit.crc : commit.page_id, this->_response.data);
   }
 }
 
 // Flash Write Commands -----------------------------------------------------------------------------------------------
 
 FRANKLYBOOT_HANDLER_TEMPL
-void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqFlashWriteErasePage(const msg::Msg& request) {
-  this->_response = msg::Msg(msg::REQ_FLASH_WRITE_ERASE_PAGE, msg::RES_ERR, request.packet_id);
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqFlashWriteErasePage(const Msg& request) {
+  this->_response = Msg(msg::REQ_FLASH_WRITE_ERASE_PAGE, msg::RES_ERR, request.packet_id);
   this->_response.data = request.data;
 
   const uint32_t page_id = msg::convertMsgDataToU32(request.data);
 
   const bool page_id_valid = (page_id >= FLASH_APP_FIRST_PAGE) && (page_id < FLASH_NUM_PAGES);
   if (page_id_valid) {
-    const auto erase_result = hwi::eraseFlashPage(page_id);
+    const auto erase_result = this->_hwi.eraseFlashPage(page_id);
     this->_response.result = (erase_result) ? msg::RES_OK : msg::RES_ERR;
   } else {
     this->_response.result = msg::RES_ERR_INVLD_ARG;
@@ -458,30 +1051,31 @@ void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqFlashWriteErasePage(const msg::M
 }
 
 FRANKLYBOOT_HANDLER_TEMPL
-void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqFlashWriteAppCrc(const msg::Msg& request) {
-  this->_response = msg::Msg(msg::REQ_FLASH_WRITE_APP_CRC, msg::RES_ERR, request.packet_id);
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqFlashWriteAppCrc(const Msg& request) {
+  this->_response = Msg(msg::REQ_FLASH_WRITE_APP_CRC, msg::RES_ERR, request.packet_id);
 
   /* Read complete page to buffer */
   const uint32_t page_id = FLASH_NUM_PAGES - 1U;
   const uint32_t start_address = FLASH_START + page_id * FLASH_PAGE_SIZE;
   uint32_t byte_address = start_address;
   for (uint32_t byte_idx = 0U; byte_idx < FLASH_PAGE_SIZE; byte_idx++) {
-    this->_page_buffer[byte_idx] = hwi::readByteFromFlash(byte_address);
+    this->getPageBuffer()[byte_idx] = this->_hwi.readByteFromFlash(byte_address);
     byte_address++;
   }
 
   /* Store CRC value to last word in page buffer */
-  this->_page_buffer[FLASH_PAGE_SIZE - 4U] = request.data[0];
-  this->_page_buffer[FLASH_PAGE_SIZE - 3U] = request.data[1];
-  this->_page_buffer[FLASH_PAGE_SIZE - 2U] = request.data[2];
-  this->_page_buffer[FLASH_PAGE_SIZE - 1U] = request.data[3];
+  this->getPageBuffer()[FLASH_PAGE_SIZE - 4U] = request.data[0];
+  this->getPageBuffer()[FLASH_PAGE_SIZE - 3U] = request.data[1];
+  this->getPageBuffer()[FLASH_PAGE_SIZE - 2U] = request.data[2];
+  this->getPageBuffer()[FLASH_PAGE_SIZE - 1U] = request.data[3];
 
-  /* Erase page */
-  const auto erase_result = hwi::eraseFlashPage(page_id);
+  /* Erase page (skipped if still blank) */
+  const auto erase_result = this->eraseFlashPageIfNotBlank(page_id);
 
   if (erase_result) {
     /* Write page to flash */
-    const bool flash_result = hwi::writeDataBufferToFlash(start_address, page_id, _page_buffer.data(), FLASH_PAGE_SIZE);
+    const bool flash_result =
+        this->_hwi.writeDataBufferToFlash(start_address, page_id, getPageBuffer().data(), FLASH_PAGE_SIZE);
 
     if (flash_result) {
       this->_response.result = msg::RES_OK;
@@ -489,25 +1083,617 @@ void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqFlashWriteAppCrc(const msg::Msg&
   }
 
   /* Read CRC value from flash */
-  this->_response.data[0U] = hwi::readByteFromFlash(FLASH_APP_CRC_VALUE_ADDRESS);
-  this->_response.data[1U] = hwi::readByteFromFlash(FLASH_APP_CRC_VALUE_ADDRESS + 1U);
-  this->_response.data[2U] = hwi::readByteFromFlash(FLASH_APP_CRC_VALUE_ADDRESS + 2U);
-  this->_response.data[3U] = hwi::readByteFromFlash(FLASH_APP_CRC_VALUE_ADDRESS + 3U);
+  this->_response.data[0U] = this->_hwi.readByteFromFlash(FLASH_APP_CRC_VALUE_ADDRESS);
+  this->_response.data[1U] = this->_hwi.readByteFromFlash(FLASH_APP_CRC_VALUE_ADDRESS + 1U);
+  this->_response.data[2U] = this->_hwi.readByteFromFlash(FLASH_APP_CRC_VALUE_ADDRESS + 2U);
+  this->_response.data[3U] = this->_hwi.readByteFromFlash(FLASH_APP_CRC_VALUE_ADDRESS + 3U);
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqFlashWriteEraseRange(const Msg& request) {
+  constexpr uint32_t NUM_BITS_PER_BYTE = 8U;
+
+  this->_response = Msg(msg::REQ_FLASH_WRITE_ERASE_RANGE, msg::RES_ERR, request.packet_id);
+  this->_response.data = request.data;
+
+  /* Data: first page (u16) | number of pages (u16, 0 erases up to the last page) */
+  const uint32_t page_first = request.data[0U] | (request.data[1U] << NUM_BITS_PER_BYTE);
+  const uint32_t num_pages_req = request.data[2U] | (request.data[3U] << NUM_BITS_PER_BYTE);
+
+  const bool page_first_valid = (page_first >= FLASH_APP_FIRST_PAGE) && (page_first < FLASH_NUM_PAGES);
+  const uint32_t num_pages = (num_pages_req > 0U) ? num_pages_req : (FLASH_NUM_PAGES - page_first);
+  const bool num_pages_valid = page_first_valid && (num_pages <= (FLASH_NUM_PAGES - page_first));
+
+  if (page_first_valid && num_pages_valid) {
+    /* Erase is started by the next processBufferedCmds(), response is sent immediately */
+    this->_erase_page_first = page_first;
+    this->_erase_page_next = page_first;
+    this->_erase_page_end = page_first + num_pages;
+    this->_erase_result = msg::RES_BUSY;
+
+    this->_response.data[2U] = static_cast<uint8_t>(num_pages);
+    this->_response.data[3U] = static_cast<uint8_t>(num_pages >> NUM_BITS_PER_BYTE);
+    this->_response.result = msg::RES_OK;
+  } else {
+    this->_response.result = msg::RES_ERR_INVLD_ARG;
+  }
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::handleReqFlashWriteEraseStatus() {
+  constexpr uint32_t NUM_BITS_PER_BYTE = 8U;
+
+  this->_response = Msg(msg::REQ_FLASH_WRITE_ERASE_STATUS, this->_erase_result, 0);
+
+  /* Data: number of pages erased (u16) | number of pages of the range (u16) */
+  const uint32_t num_pages_erased = this->_erase_page_next - this->_erase_page_first;
+  const uint32_t num_pages = this->_erase_page_end - this->_erase_page_first;
+  this->_response.data[0U] = static_cast<uint8_t>(num_pages_erased);
+  this->_response.data[1U] = static_cast<uint8_t>(num_pages_erased >> NUM_BITS_PER_BYTE);
+  this->_response.data[2U] = static_cast<uint8_t>(num_pages);
+  this->_response.data[3U] = static_cast<uint8_t>(num_pages >> NUM_BITS_PER_BYTE);
+}
+
+// Background erase ---------------------------------------------------------------------------------------------------
+
+FRANKLYBOOT_HANDLER_TEMPL
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::processEraseRange() {
+  if (!isEraseRangeBusy()) {
+    return;
+  }
+
+  const uint32_t num_pages_left = this->_erase_page_end - this->_erase_page_next;
+  uint32_t num_pages_erased = 0U;
+
+  if constexpr (ASYNC_FLASH) {
+    /* Page erase is started and polled, the requests are served while the flash controller erases */
+    if (this->_flash_state == FlashState::IDLE) {
+      if (this->_hwi.startEraseFlashPage(this->_erase_page_next)) {
+        this->_flash_state = FlashState::ERASE;
+      } else {
+        this->_erase_result = msg::RES_ERR;
+      }
+      return;
+    }
+
+    const auto status = this->_hwi.pollFlash();
+    if (status == hwi::FlashStatus::BUSY) {
+      return;
+    }
+
+    this->_flash_state = FlashState::IDLE;
+    num_pages_erased = (status == hwi::FlashStatus::DONE) ? 1U : 0U;
+  } else if constexpr (hwi::HasSectorErase<HWI>::value) {
+    /* One call per cycle keeps the main loop responsive, the HWI may erase a complete sector / bank at once */
+    num_pages_erased = this->_hwi.eraseFlashPages(this->_erase_page_next, num_pages_left);
+  } else {
+    num_pages_erased = this->_hwi.eraseFlashPage(this->_erase_page_next) ? 1U : 0U;
+  }
+
+  const bool erase_valid = (num_pages_erased > 0U) && (num_pages_erased <= num_pages_left);
+  if (erase_valid) {
+    this->_erase_page_next += num_pages_erased;
+    if (this->_erase_page_next == this->_erase_page_end) {
+      this->_erase_result = msg::RES_OK;
+    }
+  } else {
+    this->_erase_result = msg::RES_ERR;
+  }
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+[[nodiscard]] bool FRANKLYBOOT_HANDLER_TEMPL_PREFIX::isEraseRangeBusy() const {
+  return (this->_erase_result == msg::RES_BUSY);
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+[[nodiscard]] bool FRANKLYBOOT_HANDLER_TEMPL_PREFIX::isFlashWriteRequest(const msg::RequestType request) {
+  switch (request) {
+    case msg::REQ_START_APP:
+    case msg::REQ_PAGE_BUFFER_WRITE_TO_FLASH:
+    case msg::REQ_FLASH_WRITE_ERASE_PAGE:
+    case msg::REQ_FLASH_WRITE_APP_CRC:
+    case msg::REQ_FLASH_WRITE_ERASE_RANGE:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+[[nodiscard]] bool FRANKLYBOOT_HANDLER_TEMPL_PREFIX::isFlashBusy(const msg::RequestType request) const {
+  /* Deferred page writes are queued by REQ_PAGE_BUFFER_WRITE_TO_FLASH itself, copies have to read the new pages */
+  const bool commit_dependent = (isFlashWriteRequest(request) && (request != msg::REQ_PAGE_BUFFER_WRITE_TO_FLASH)) ||
+                                (request == msg::REQ_PAGE_BUFFER_COPY_FROM_FLASH);
+
+  return (isEraseRangeBusy() && isFlashWriteRequest(request)) || (commit_dependent && isPageCommitPending()) ||
+         (isPageBufferWriteRequest(request) && isPageBufferLocked());
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+[[nodiscard]] bool FRANKLYBOOT_HANDLER_TEMPL_PREFIX::isPageBufferWriteRequest(const msg::RequestType request) {
+  switch (request) {
+    case msg::REQ_PAGE_BUFFER_CLEAR:
+    case msg::REQ_PAGE_BUFFER_WRITE_WORD:
+    case msg::REQ_PAGE_BUFFER_STREAM_WORD:
+    case msg::REQ_PAGE_BUFFER_WRITE_BLOCK:
+    case msg::REQ_PAGE_BUFFER_WRITE_WORD_AT:
+    case msg::REQ_PAGE_BUFFER_WRITE_BLOCK_AT:
+    case msg::REQ_PAGE_BUFFER_WRITE_COMPRESSED:
+    case msg::REQ_PAGE_BUFFER_COPY_FROM_FLASH:
+    case msg::REQ_PAGE_BUFFER_FILL:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+// Page buffer commit -------------------------------------------------------------------------------------------------
+
+FRANKLYBOOT_HANDLER_TEMPL
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::commitPageBuffer(const uint32_t buffer_idx) {
+  /* Direct write: the response carries the result, an asynchronous flash is polled until it is finished */
+  auto& commit = this->_page_commits[buffer_idx];
+  commit.result = msg::RES_BUSY;
+
+  do {
+    this->processPageCommit(buffer_idx);
+  } while (commit.result == msg::RES_BUSY);
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::processPageCommit(const uint32_t buffer_idx) {
+  const auto& commit = this->_page_commits[buffer_idx];
+  auto& page_buffer = this->_page_buffers[buffer_idx];
+  const uint32_t address = FLASH_START + FLASH_PAGE_SIZE * commit.page_id;
+  const bool compare = ((commit.flags & msg::WRITE_TO_FLASH_COMPARE) != 0U);
+
+  if constexpr (ASYNC_FLASH) {
+    /* One step per call: start erase -> erase finished, start write -> write finished */
+    switch (this->_flash_state) {
+      case FlashState::IDLE:
+        if (compare && this->isPageBufferEqualToFlash(buffer_idx, address)) {
+          this->finishPageCommit(buffer_idx, msg::RES_OK_UNCHANGED);
+        } else if (this->isFlashPageBlank(commit.page_id)) {
+          this->startPageWrite(buffer_idx);
+        } else if (this->_hwi.startEraseFlashPage(commit.page_id)) {
+          this->_flash_state = FlashState::ERASE;
+        } else {
+          this->finishPageCommit(buffer_idx, msg::RES_ERR);
+        }
+        break;
+
+      case FlashState::ERASE: {
+        const auto status = this->_hwi.pollFlash();
+        if (status == hwi::FlashStatus::DONE) {
+          this->startPageWrite(buffer_idx);
+        } else if (status == hwi::FlashStatus::ERROR) {
+          this->_flash_state = FlashState::IDLE;
+          this->finishPageCommit(buffer_idx, msg::RES_ERR);
+        }
+        break;
+      }
+
+      case FlashState::WRITE: {
+        const auto status = this->_hwi.pollFlash();
+        if (status != hwi::FlashStatus::BUSY) {
+          this->_flash_state = FlashState::IDLE;
+          this->finishPageCommit(buffer_idx, (status == hwi::FlashStatus::DONE) ? msg::RES_OK : msg::RES_ERR);
+        }
+        break;
+      }
+    }
+  } else {
+    if (compare && this->isPageBufferEqualToFlash(buffer_idx, address)) {
+      /* Page already up to date: no erase, no wear */
+      this->finishPageCommit(buffer_idx, msg::RES_OK_UNCHANGED);
+    } else {
+      const bool flash_result =
+          this->eraseFlashPageIfNotBlank(commit.page_id) &&
+          this->_hwi.writeDataBufferToFlash(address, commit.page_id, page_buffer.data(), page_buffer.size());
+      this->finishPageCommit(buffer_idx, flash_result ? msg::RES_OK : msg::RES_ERR);
+    }
+  }
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::startPageWrite(const uint32_t buffer_idx) {
+  const auto& commit = this->_page_commits[buffer_idx];
+  auto& page_buffer = this->_page_buffers[buffer_idx];
+  const uint32_t address = FLASH_START + FLASH_PAGE_SIZE * commit.page_id;
+
+  const bool write_started =
+      this->_hwi.startWriteDataBufferToFlash(address, commit.page_id, page_buffer.data(), page_buffer.size());
+
+  this->_flash_state = write_started ? FlashState::WRITE : FlashState::IDLE;
+  if (!write_started) {
+    this->finishPageCommit(buffer_idx, msg::RES_ERR);
+  }
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::finishPageCommit(const uint32_t buffer_idx, const msg::ResultType result) {
+  auto& commit = this->_page_commits[buffer_idx];
+  const uint32_t address = FLASH_START + FLASH_PAGE_SIZE * commit.page_id;
+  const bool verify = ((commit.flags & msg::WRITE_TO_FLASH_VERIFY) != 0U);
+
+  commit.result = result;
+
+  if (verify && (result == msg::RES_OK)) {
+    /* Read back on the device, the host only compares the CRC with its image */
+    commit.result = this->isPageBufferEqualToFlash(buffer_idx, address) ? msg::RES_OK : msg::RES_ERR_CRC_INVLD;
+  }
+
+  if (verify && (commit.result != msg::RES_ERR)) {
+    commit.crc = this->_hwi.calculateCRC(address, FLASH_PAGE_SIZE);
+  }
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::processPageCommits() {
+  /* Buffers are filled in turn, so the oldest deferred write is found behind the receiving buffer */
+  for (auto idx = 1U; idx <= NUM_PAGE_BUFFERS; idx++) {
+    const uint32_t buffer_idx = (this->_page_buffer_idx + idx) % NUM_PAGE_BUFFERS;
+    if (this->_page_commits[buffer_idx].result == msg::RES_BUSY) {
+      this->processPageCommit(buffer_idx);
+
+      /* Single page buffer is locked while it is written, afterwards it receives the next page */
+      const bool buffer_released = (this->_page_commits[buffer_idx].result != msg::RES_BUSY);
+      if (buffer_released && (buffer_idx == this->_page_buffer_idx)) {
+        this->clearPageBuffer();
+      }
+      return;
+    }
+  }
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+[[nodiscard]] bool FRANKLYBOOT_HANDLER_TEMPL_PREFIX::isPageCommitPending() const {
+  for (const auto& commit : this->_page_commits) {
+    if (commit.result == msg::RES_BUSY) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+[[nodiscard]] bool FRANKLYBOOT_HANDLER_TEMPL_PREFIX::isPageBufferLocked() const {
+  return (this->_page_commits[this->_page_buffer_idx].result == msg::RES_BUSY);
 }
 
 // Private utils functions --------------------------------------------------------------------------------------------
 
+FRANKLYBOOT_HANDLER_TEMPL
+[[nodiscard]] bool FRANKLYBOOT_HANDLER_TEMPL_PREFIX::receiveFlashRangeArgs(const Msg& request, uint32_t& address,
+                                                                           uint32_t& num_bytes) {
+  /* Arguments: start address and number of bytes (two frames if payload cannot carry both arguments) */
+  bool args_complete = false;
+  if constexpr (MSG_DATA_SIZE >= FLASH_RANGE_ARGS_SIZE) {
+    address = msg::convertMsgDataToU32(request.data);
+    num_bytes = msg::convertMsgDataToU32(request.data, sizeof(uint32_t));
+    args_complete = (request.packet_id == 0U);
+  } else {
+    if (request.packet_id == 0U) {
+      /* First frame contains start address -> wait for second frame without response */
+      this->_flash_range_address = msg::convertMsgDataToU32(request.data);
+      this->_flash_range_request = request.request;
+      this->_flash_range_address_avl = true;
+      this->_response_avl = false;
+      return false;
+    }
+
+    address = this->_flash_range_address;
+    num_bytes = msg::convertMsgDataToU32(request.data);
+    args_complete = (request.packet_id == 1U) && this->_flash_range_address_avl &&
+                    (this->_flash_range_request == request.request);
+    this->_flash_range_address_avl = false;
+  }
+
+  const uint32_t flash_end_address = FLASH_START + FLASH_SIZE;
+  const bool address_inside_low_limit = (address >= FLASH_START);
+  const bool address_inside_high_limit = (address < flash_end_address);
+  const bool address_valid = address_inside_low_limit && address_inside_high_limit;
+  const bool num_bytes_valid = address_valid && (num_bytes > 0U) && (num_bytes <= (flash_end_address - address));
+
+  return args_complete && num_bytes_valid;
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::createFlashReadBlockResponse() {
+  /* Packet id is the index of the response frame, last frame can be shorter than the message payload */
+  const uint32_t byte_offset = this->_response_stream_idx * MSG_DATA_SIZE;
+  const uint32_t num_bytes_left = this->_flash_read_num_bytes - byte_offset;
+  const uint32_t num_bytes = (num_bytes_left < MSG_DATA_SIZE) ? num_bytes_left : MSG_DATA_SIZE;
+  const auto packet_id = static_cast<uint8_t>(this->_response_stream_idx & std::numeric_limits<uint8_t>::max());
+
+  this->_response = Msg(msg::REQ_FLASH_READ_BLOCK, msg::RES_OK, packet_id);
+  for (auto idx = 0U; idx < num_bytes; idx++) {
+    this->_response.data[idx] = this->_hwi.readByteFromFlash(this->_flash_read_address + byte_offset + idx);
+  }
+
+  this->_response_stream_idx++;
+  this->_response_avl = true;
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::createFieldsResponse() {
+  /* Inventory fields are read on demand, capabilities are compile time constants */
+  const bool inventory = (this->_response_stream == ResponseStream::INVENTORY);
+  const auto request = inventory ? msg::REQ_DEV_INFO_INVENTORY : msg::REQ_DEV_INFO_CAPABILITIES;
+  const uint32_t num_fields = inventory ? static_cast<uint32_t>(msg::INV_NUM_FIELDS) : msg::CAP_NUM_FIELDS;
+
+  const auto packet_id = static_cast<uint8_t>(this->_response_stream_idx);
+  this->_response = Msg(request, msg::RES_OK, packet_id);
+
+  for (auto idx = 0U; idx < INVENTORY_FIELDS_PER_MSG; idx++) {
+    const uint32_t field = this->_response_stream_idx * INVENTORY_FIELDS_PER_MSG + idx;
+    if (field >= num_fields) {
+      break;
+    }
+
+    const uint32_t value = inventory ? getInventoryField(field) : CAPABILITIES[field];
+    msg::convertU32ToMsgData(value, this->_response.data, idx * sizeof(uint32_t));
+  }
+
+  this->_response_stream_idx++;
+  this->_response_avl = true;
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::createMissingWordsResponse() {
+  /* Bit n of a frame (data[n / 8], LSB first) is set if word (start + frame * bits per frame + n) is missing */
+  constexpr uint32_t NUM_BITS_PER_BYTE = 8U;
+
+  const auto packet_id = static_cast<uint8_t>(this->_response_stream_idx & std::numeric_limits<uint8_t>::max());
+  const uint32_t first_word_idx = this->_missing_words_start + this->_response_stream_idx * MISSING_WORDS_PER_MSG;
+
+  this->_response = Msg(msg::REQ_PAGE_BUFFER_MISSING_WORDS, msg::RES_OK, packet_id);
+  for (auto idx = 0U; idx < MISSING_WORDS_PER_MSG; idx++) {
+    if (this->isPageBufferWordMissing(first_word_idx + idx)) {
+      this->_response.data[idx / NUM_BITS_PER_BYTE] |= static_cast<uint8_t>(1U << (idx % NUM_BITS_PER_BYTE));
+    }
+  }
+
+  this->_response_stream_idx++;
+  this->_response_avl = true;
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+[[nodiscard]] uint32_t FRANKLYBOOT_HANDLER_TEMPL_PREFIX::getInventoryField(const uint32_t field) const {
+  constexpr uint32_t NUM_BITS_PER_BYTE = 8U;
+
+  switch (field) {
+    case msg::INV_BOOTLOADER_VERSION:
+      return version::VERSION[version::MAJOR_IDX] | (version::VERSION[version::MINOR_IDX] << NUM_BITS_PER_BYTE) |
+             (version::VERSION[version::PATCH_IDX] << (2U * NUM_BITS_PER_BYTE));
+    case msg::INV_VID:
+      return this->_hwi.getVendorID();
+    case msg::INV_PID:
+      return this->_hwi.getProductID();
+    case msg::INV_PRD:
+      return this->_hwi.getProductionDate();
+    case msg::INV_UID_1:
+      return this->_hwi.getUniqueIDWord(0);
+    case msg::INV_UID_2:
+      return this->_hwi.getUniqueIDWord(1);
+    case msg::INV_UID_3:
+      return this->_hwi.getUniqueIDWord(2);
+    case msg::INV_UID_4:
+      return this->_hwi.getUniqueIDWord(3);
+    case msg::INV_FLASH_START_ADDR:
+      return FLASH_START;
+    case msg::INV_FLASH_PAGE_SIZE:
+      return FLASH_PAGE_SIZE;
+    case msg::INV_FLASH_NUM_PAGES:
+      return FLASH_NUM_PAGES;
+    case msg::INV_APP_PAGE_IDX:
+      return FLASH_APP_FIRST_PAGE;
+    case msg::INV_APP_CRC_CALC:
+      return this->calcAppCRC();
+    case msg::INV_APP_CRC_STRD:
+      return this->readAppCRCFromFlash();
+    default:
+      return 0U;
+  }
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+[[nodiscard]] auto FRANKLYBOOT_HANDLER_TEMPL_PREFIX::getPageBuffer() -> PageBuffer& {
+  if constexpr (NUM_PAGE_BUFFERS > 1U) {
+    return this->_page_buffers[this->_page_buffer_idx];
+  } else {
+    return this->_page_buffers[0U];
+  }
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+[[nodiscard]] auto FRANKLYBOOT_HANDLER_TEMPL_PREFIX::getPageBuffer() const -> const PageBuffer& {
+  if constexpr (NUM_PAGE_BUFFERS > 1U) {
+    return this->_page_buffers[this->_page_buffer_idx];
+  } else {
+    return this->_page_buffers[0U];
+  }
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::clearPageBuffer() {
+  this->getPageBuffer().fill({std::numeric_limits<uint8_t>::max()});
+  this->_page_buffer_pos = 0U;
+  this->_page_buffer_end_pos = 0U;
+  this->_page_buffer_stream_gap = false;
+  this->_page_buffer_random_access = false;
+  this->_page_buffer_words_rcvd.reset();
+  this->_page_buffer_compressed_idx = 0U;
+
+  if constexpr (DECOMPRESSION_WINDOW_BITS > 0U) {
+    this->_page_buffer_decoder.reset(FLASH_PAGE_SIZE);
+  }
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::writeWordToPageBuffer(const uint32_t word_idx,
+                                                             const msg::BasicMsgData<MSG_DATA_SIZE>& data) {
+  /* Last word of a page can be shorter than the message payload (e.g. 60 byte CAN-FD payload) */
+  const uint32_t byte_idx = word_idx * MSG_DATA_SIZE;
+  const uint32_t num_bytes_free = static_cast<uint32_t>(this->getPageBuffer().size()) - byte_idx;
+  const uint32_t num_bytes = (num_bytes_free < MSG_DATA_SIZE) ? num_bytes_free : MSG_DATA_SIZE;
+
+  for (auto idx = 0U; idx < num_bytes; idx++) {
+    this->getPageBuffer()[byte_idx + idx] = data[idx];
+  }
+
+  this->markPageBufferWordsRcvd(byte_idx, num_bytes);
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::markPageBufferWordsRcvd(const uint32_t byte_idx, const uint32_t num_bytes) {
+  /* A word is received as soon as its last byte is written (first bytes may be written by the previous block) */
+  const auto page_size = static_cast<uint32_t>(this->getPageBuffer().size());
+  const uint32_t end_pos = byte_idx + num_bytes;
+
+  for (auto word_idx = byte_idx / MSG_DATA_SIZE; word_idx < PAGE_BUFFER_NUM_WORDS; word_idx++) {
+    const uint32_t word_end_pos = (word_idx + 1U) * MSG_DATA_SIZE;
+    if (((word_end_pos < page_size) ? word_end_pos : page_size) > end_pos) {
+      break;
+    }
+
+    this->_page_buffer_words_rcvd.set(word_idx);
+  }
+
+  if (this->_page_buffer_end_pos < end_pos) {
+    this->_page_buffer_end_pos = end_pos;
+  }
+
+  this->advancePageBufferPos();
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+void FRANKLYBOOT_HANDLER_TEMPL_PREFIX::advancePageBufferPos() {
+  /* Move the write position over all words received ahead of it */
+  const auto page_size = static_cast<uint32_t>(this->getPageBuffer().size());
+
+  while ((this->_page_buffer_pos < page_size) &&
+         this->_page_buffer_words_rcvd.test(this->_page_buffer_pos / MSG_DATA_SIZE)) {
+    const uint32_t word_end_pos = ((this->_page_buffer_pos / MSG_DATA_SIZE) + 1U) * MSG_DATA_SIZE;
+    this->_page_buffer_pos = (word_end_pos < page_size) ? word_end_pos : page_size;
+  }
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+[[nodiscard]] bool FRANKLYBOOT_HANDLER_TEMPL_PREFIX::isPageBufferEqualToFlash(const uint32_t buffer_idx,
+                                                                              const uint32_t address) const {
+  /* Stops at the first difference, a changed page costs only a few reads */
+  const auto& page_buffer = this->_page_buffers[buffer_idx];
+  for (auto byte_idx = 0U; byte_idx < page_buffer.size(); byte_idx++) {
+    if (this->_hwi.readByteFromFlash(address + byte_idx) != page_buffer[byte_idx]) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+[[nodiscard]] bool FRANKLYBOOT_HANDLER_TEMPL_PREFIX::isFlashPageBlank(const uint32_t page_id) const {
+  if constexpr (hwi::HasBlankCheck<HWI>::value) {
+    return this->_hwi.isFlashPageBlank(page_id);
+  } else {
+    /* 0xFF bytes do not prove an erased page (e.g. flash with ECC), without the hook of the HWI it is always erased */
+    (void)page_id;
+    return false;
+  }
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+bool FRANKLYBOOT_HANDLER_TEMPL_PREFIX::eraseFlashPageIfNotBlank(const uint32_t page_id) {
+  /* Erase costs 20 - 40 ms per page, pages reported blank by the HWI (hwi::HasBlankCheck) are written directly */
+  return this->isFlashPageBlank(page_id) || this->_hwi.eraseFlashPage(page_id);
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+[[nodiscard]] bool FRANKLYBOOT_HANDLER_TEMPL_PREFIX::getPageBufferWordIdx(const uint8_t packet_id,
+                                                                          uint32_t& word_idx) const {
+  /* Packet id is the 8-bit word index, it is resolved relative to the word at the write position */
+  constexpr uint32_t NUM_PACKET_IDS = std::numeric_limits<uint8_t>::max() + 1U;
+
+  const uint32_t pos_word_idx = this->_page_buffer_pos / MSG_DATA_SIZE;
+  const auto delta = static_cast<uint8_t>(packet_id - static_cast<uint8_t>(pos_word_idx));
+
+  if (delta < PACKET_ID_MAX_AHEAD) {
+    word_idx = pos_word_idx + delta;
+    return true;
+  }
+
+  const uint32_t num_words_behind = NUM_PACKET_IDS - delta;
+  word_idx = pos_word_idx - num_words_behind;
+  return (num_words_behind <= pos_word_idx);
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+[[nodiscard]] msg::ResultType FRANKLYBOOT_HANDLER_TEMPL_PREFIX::getPageBufferWordsRange(const Msg& request,
+                                                                                     uint32_t& num_bytes) const {
+  constexpr uint32_t NUM_BITS_PER_BYTE = 8U;
+
+  /* Number of words: low byte is transmitted as packet id, high byte in the result field (like WRITE_WORD_AT) */
+  const auto page_size = static_cast<uint32_t>(this->getPageBuffer().size());
+  const uint32_t num_words = request.packet_id | (static_cast<uint32_t>(request.result) << NUM_BITS_PER_BYTE);
+  const uint32_t num_words_free = PAGE_BUFFER_NUM_WORDS - (this->_page_buffer_pos / MSG_DATA_SIZE);
+  const bool pos_valid = ((this->_page_buffer_pos % MSG_DATA_SIZE) == 0U);
+
+  if (num_words > num_words_free) {
+    return msg::RES_ERR_PAGE_FULL;
+  }
+
+  if ((num_words == 0U) || !pos_valid) {
+    return msg::RES_ERR_INVLD_ARG;
+  }
+
+  /* Words start at the write position, the last word of the page may be shorter */
+  const uint32_t num_bytes_free = page_size - this->_page_buffer_pos;
+  const uint32_t num_bytes_words = num_words * MSG_DATA_SIZE;
+  num_bytes = (num_bytes_words < num_bytes_free) ? num_bytes_words : num_bytes_free;
+  return msg::RES_OK;
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+[[nodiscard]] bool FRANKLYBOOT_HANDLER_TEMPL_PREFIX::isPageBufferComplete() const {
+  /* Random access requires every word, sequential writes only must not leave a gap (e.g. shorter last page) */
+  if (this->_page_buffer_random_access) {
+    return this->_page_buffer_words_rcvd.all();
+  }
+
+  return (this->_page_buffer_end_pos <= this->_page_buffer_pos);
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+[[nodiscard]] bool FRANKLYBOOT_HANDLER_TEMPL_PREFIX::isPageBufferWordMissing(const uint32_t word_idx) const {
+  /* Missing are words below the highest word received, which are not (or only partially) written */
+  const bool word_idx_valid = (word_idx < PAGE_BUFFER_NUM_WORDS);
+  const bool word_inside_gap = ((word_idx * MSG_DATA_SIZE) < this->_page_buffer_end_pos);
+  return word_idx_valid && word_inside_gap && !this->_page_buffer_words_rcvd.test(word_idx);
+}
+
+FRANKLYBOOT_HANDLER_TEMPL
+[[nodiscard]] uint8_t FRANKLYBOOT_HANDLER_TEMPL_PREFIX::getPageBufferPacketId() const {
+  /* Packet id is the index of the next word (message payload) in the page buffer */
+  return static_cast<uint8_t>((this->_page_buffer_pos / MSG_DATA_SIZE) & std::numeric_limits<uint8_t>::max());
+}
+
 FRANKLYBOOT_HANDLER_TEMPL
 uint32_t FRANKLYBOOT_HANDLER_TEMPL_PREFIX::getPageBufferAddress() const {
   uint32_t page_buffer_address = 0U;
 
   if constexpr (is64BitSystem()) {
     /* Only used for testing on normal host pcs with 64 - bit*/
-    auto ptr_address = reinterpret_cast<uint64_t>(_page_buffer.data());
+    auto ptr_address = reinterpret_cast<uint64_t>(getPageBuffer().data());
     page_buffer_address = static_cast<uint32_t>(ptr_address);
 
   } else {
-    page_buffer_address = reinterpret_cast<uint32_t>(_page_buffer.data());
+    page_buffer_address = reinterpret_cast<uint32_t>(getPageBuffer().data());
   }
 
   return page_buffer_address;
@@ -518,7 +1704,7 @@ FRANKLYBOOT_HANDLER_TEMPL
   /* Calculate CRC value */
   const uint32_t app_flash_ptr = FLASH_APP_ADDRESS;
   const uint32_t app_flash_size = (FLASH_APP_NUM_PAGES * FLASH_PAGE_SIZE) - 4U;
-  const uint32_t crc_value_calc = hwi::calculateCRC(app_flash_ptr, app_flash_size);
+  const uint32_t crc_value_calc = this->_hwi.calculateCRC(app_flash_ptr, app_flash_size);
   return crc_value_calc;
 }
 
@@ -529,8 +1715,8 @@ FRANKLYBOOT_HANDLER_TEMPL
   /* Read CRC value from flash */
   uint32_t crc_value_stored = 0U;
   for (auto idx = 0U; idx < sizeof(uint32_t); idx++) {
-    crc_value_stored |=
-        static_cast<uint32_t>(hwi::readByteFromFlash(FLASH_APP_CRC_VALUE_ADDRESS + idx) << (idx * NUM_BITS_PER_BYTE));
+    crc_value_stored |= static_cast<uint32_t>(this->_hwi.readByteFromFlash(FLASH_APP_CRC_VALUE_ADDRESS + idx)
+                                              << (idx * NUM_BITS_PER_BYTE));
   }
 
   return crc_value_stored;
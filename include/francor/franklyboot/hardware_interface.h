@@ -14,6 +14,8 @@
 #ifdef __cplusplus
 
 #include <cstdint>
+#include <type_traits>
+#include <utility>
 
 /**
  * @brief Hardware interface / Hardware abstraction layer
@@ -53,6 +55,89 @@ bool writeDataBufferToFlash(uint32_t dst_address, uint32_t dst_page_id, uint8_t*
 /** \brief Starts the application and exits the bootloader */
 void startApp(uint32_t app_flash_address);
 
+/**
+ * @brief Default hardware interface policy of the handler, forwards to the free functions above
+ *
+ * A custom policy is passed as HWI template argument of the handler and provides the same functions as const
+ * members. Its functions are visible to the compiler (inlining) and every handler owns its policy object, so
+ * several devices with their own backends can run in one process.
+ */
+struct FreeFunctions {
+  void resetDevice() const { hwi::resetDevice(); }
+  [[nodiscard]] uint32_t getVendorID() const { return hwi::getVendorID(); }
+  [[nodiscard]] uint32_t getProductID() const { return hwi::getProductID(); }
+  [[nodiscard]] uint32_t getProductionDate() const { return hwi::getProductionDate(); }
+  [[nodiscard]] uint32_t getUniqueIDWord(uint32_t idx) const { return hwi::getUniqueIDWord(idx); }
+  [[nodiscard]] uint32_t calculateCRC(uint32_t src_address, uint32_t num_bytes) const {
+    return hwi::calculateCRC(src_address, num_bytes);
+  }
+  bool eraseFlashPage(uint32_t page_id) const { return hwi::eraseFlashPage(page_id); }
+  bool writeDataBufferToFlash(uint32_t dst_address, uint32_t dst_page_id, uint8_t* src_data_ptr,
+                              uint32_t num_bytes) const {
+    return hwi::writeDataBufferToFlash(dst_address, dst_page_id, src_data_ptr, num_bytes);
+  }
+  [[nodiscard]] uint8_t readByteFromFlash(uint32_t flash_src_address) const {
+    return hwi::readByteFromFlash(flash_src_address);
+  }
+  void startApp(uint32_t app_flash_address) const { hwi::startApp(app_flash_address); }
+};
+
+/** \brief State of an asynchronous flash operation (see IsAsyncFlash) */
+enum class FlashStatus : uint8_t {
+  BUSY,   //!< Flash controller still working
+  DONE,   //!< Operation finished successfully
+  ERROR,  //!< Operation failed
+};
+
+/**
+ * @brief Detects an HWI policy with asynchronous flash operations
+ *
+ * Besides the functions above the policy provides
+ *
+ * - bool startEraseFlashPage(uint32_t page_id) const
+ * - bool startWriteDataBufferToFlash(uint32_t dst_address, uint32_t dst_page_id, uint8_t* src_data_ptr,
+ *                                    uint32_t num_bytes) const
+ * - FlashStatus pollFlash() const
+ *
+ * The start functions return false if the operation cannot be started. Only one operation runs at a time, the
+ * handler polls it from processBufferedCmds() until it is not FlashStatus::BUSY anymore. The source data of a write
+ * stays untouched until then (e.g. DMA). The free functions do not provide asynchronous operations.
+ */
+template <typename HWI, typename = void>
+struct IsAsyncFlash : std::false_type {};
+
+template <typename HWI>
+struct IsAsyncFlash<HWI, std::void_t<decltype(std::declval<const HWI&>().pollFlash())>> : std::true_type {};
+
+/**
+ * @brief Detects an HWI policy erasing several flash pages at once (REQ_FLASH_WRITE_ERASE_RANGE)
+ *
+ * The policy provides uint32_t eraseFlashPages(uint32_t first_page_id, uint32_t max_num_pages) const, called
+ * cyclically until the range is erased. Devices with sectors / banks erase a complete sector or bank if it starts at
+ * first_page_id and fits into max_num_pages, otherwise a single page. It returns the number of erased pages
+ * (1..max_num_pages), 0 on error. Without this function the handler erases one page per cycle with eraseFlashPage().
+ */
+template <typename HWI, typename = void>
+struct HasSectorErase : std::false_type {};
+
+template <typename HWI>
+struct HasSectorErase<HWI, std::void_t<decltype(std::declval<const HWI&>().eraseFlashPages(0U, 0U))>>
+    : std::true_type {};
+
+/**
+ * @brief Detects an HWI policy with a blank check of flash pages
+ *
+ * The policy provides bool isFlashPageBlank(uint32_t page_id) const, returning true if the page is erased and can be
+ * written without erase. Without this function every page is erased before it is written, because a page reading 0xFF
+ * is not necessarily writable (e.g. flash with ECC, which cannot program a word twice).
+ */
+template <typename HWI, typename = void>
+struct HasBlankCheck : std::false_type {};
+
+template <typename HWI>
+struct HasBlankCheck<HWI, std::void_t<decltype(std::declval<const HWI&>().isFlashPageBlank(0U))>>
+    : std::true_type {};
+
 }  // namespace franklyboot::hwi
 
 #endif /* __cplusplus */
@@ -0,0 +1,215 @@
+/**
+ * @file isotp.h
+ * @author Martin Bauernschmitt (martin.bauernschmitt@francor.de)
+ * @brief ISO-TP (ISO 15765-2) segmentation layer for transfers larger than one CAN frame
+ * @version 0.1
+ * @date 2022-11-26
+ *
+ * @copyright Copyright (c) 2022 - BSD-3-clause - FRANCOR e.V.
+ *
+ */
+
+#ifndef FRANCOR_FRANKLYBOOT_ISOTP_H_
+#define FRANCOR_FRANKLYBOOT_ISOTP_H_
+
+#ifdef __cplusplus
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Groups all definitions of the frankly boot bootloader
+ */
+namespace franklyboot {
+
+/**
+ * @brief ISO-TP segmentation layer
+ *
+ * Transport agnostic implementation of the ISO 15765-2 segmentation (single frame,
+ * first frame, consecutive frame and flow control) for classic CAN frames. The layer
+ * sits between the bus driver and the Handler and allows to transfer a complete page as one
+ * logical message: [msg header + msg data | data block] (see Handler::processBlockRequest()).
+ *
+ * Node or message identification (CAN-IDs) has to be done by the bus driver.
+ */
+namespace isotp {
+
+/** \brief Size of a ISO-TP frame (classic CAN) */
+constexpr size_t FRAME_SIZE = {8U};
+
+/** \brief Definition of a ISO-TP frame */
+using Frame = std::array<uint8_t, FRAME_SIZE>;
+
+/**
+ * @brief Type of frame (upper nibble of the protocol control information)
+ */
+enum FrameType : uint8_t {
+  FRAME_SINGLE = 0x00U,        //!< Single frame (complete message with up to 7 bytes)
+  FRAME_FIRST = 0x10U,         //!< First frame of a segmented message including the message size
+  FRAME_CONSECUTIVE = 0x20U,   //!< Consecutive frame of a segmented message including the sequence number
+  FRAME_FLOW_CONTROL = 0x30U,  //!< Flow control frame send by the receiver
+};
+
+/**
+ * @brief Flow status of a flow control frame
+ */
+enum FlowStatus : uint8_t {
+  FLOW_CONTINUE = 0x00U,  //!< Continue to send (CTS)
+  FLOW_WAIT = 0x01U,      //!< Wait for next flow control frame
+  FLOW_OVERFLOW = 0x02U,  //!< Message too large, transfer aborted
+};
+
+/** \brief Mask of the frame type in the protocol control information */
+constexpr uint8_t FRAME_TYPE_MASK = {0xF0U};
+
+/** \brief Max. number of data bytes in a single frame */
+constexpr uint32_t SINGLE_FRAME_MAX_SIZE = {7U};
+
+/** \brief Number of data bytes in a first frame (12-bit length) */
+constexpr uint32_t FIRST_FRAME_DATA_SIZE = {6U};
+
+/** \brief Number of data bytes in a first frame (escaped 32-bit length) */
+constexpr uint32_t FIRST_FRAME_ESC_DATA_SIZE = {2U};
+
+/** \brief Max. message size which can be encoded with a 12-bit first frame length */
+constexpr uint32_t FIRST_FRAME_MAX_SIZE = {0xFFFU};
+
+/** \brief Number of data bytes in a consecutive frame */
+constexpr uint32_t CONSECUTIVE_FRAME_DATA_SIZE = {7U};
+
+/** \brief Byte used to pad unused bytes of a frame */
+constexpr uint8_t FRAME_PADDING = {0xCCU};
+
+/**
+ * @brief Receiver of segmented messages (bootloader side)
+ *
+ * @param MAX_MSG_SIZE Max. size of a logical message (e.g. msg + page size)
+ */
+template <uint32_t MAX_MSG_SIZE>
+class Receiver {
+ public:
+  /**
+   * @brief Construct a new Receiver object
+   *
+   * @param block_size Number of consecutive frames send without flow control (0 = unlimited)
+   * @param separation_time Min. time between consecutive frames (STmin encoding)
+   */
+  explicit Receiver(uint8_t block_size = 0U, uint8_t separation_time = 0U);
+
+  /**
+   * @brief Processes a received frame
+   *
+   * @param frame Received frame
+   * @param flow_control Flow control frame, which has to be transmitted if true is returned
+   * @return true Flow control frame has to be transmitted
+   */
+  [[nodiscard]] bool processFrame(const Frame& frame, Frame& flow_control);
+
+  /** \brief Checks if a complete message was received */
+  [[nodiscard]] bool isMsgAvl() const { return _msg_avl; }
+
+  /** \brief Get pointer to the received message */
+  [[nodiscard]] const uint8_t* getMsgData() const { return _msg_buffer.data(); }
+
+  /** \brief Get size of the received message in bytes */
+  [[nodiscard]] uint32_t getMsgSize() const { return _msg_size; }
+
+  /**
+   * @brief Releases the received message, so that the next message can be received
+   *
+   * A first frame received while the message was not released is answered with FLOW_WAIT. Its transfer is
+   * continued here, the flow control frame (FLOW_CONTINUE) has to be transmitted if true is returned.
+   *
+   * @param flow_control Flow control frame, which has to be transmitted if true is returned
+   * @return true Flow control frame has to be transmitted
+   */
+  [[nodiscard]] bool releaseMsg(Frame& flow_control);
+
+ private:
+  void createFlowControl(FlowStatus status, Frame& flow_control) const;
+
+  const uint8_t _block_size;       //!< Block size send in flow control frames
+  const uint8_t _separation_time;  //!< Separation time send in flow control frames
+
+  std::array<uint8_t, MAX_MSG_SIZE> _msg_buffer = {};  //!< Buffer of the logical message
+  uint32_t _msg_size = {0U};                            //!< Size of the logical message
+  uint32_t _msg_pos = {0U};                             //!< Number of bytes received
+  bool _msg_avl = {false};                              //!< Complete message available
+  bool _msg_active = {false};                           //!< Segmented message is received
+
+  uint8_t _sequence_number = {0U};  //!< Next expected sequence number
+  uint8_t _block_frame_cnt = {0U};  //!< Consecutive frames received in current block
+
+  Frame _first_frame = {};              //!< First frame answered with FLOW_WAIT
+  bool _first_frame_pending = {false};  //!< First frame waits for the release of the message
+};
+
+/**
+ * @brief Sender of segmented messages (host side)
+ *
+ * The sender does not copy the message, the data has to be valid until the transfer is finished.
+ */
+class Sender {
+ public:
+  Sender() = default;
+
+  /**
+   * @brief Starts the transfer of a message
+   *
+   * @return true Transfer started / false transfer still active or invalid message
+   */
+  bool startTransfer(const uint8_t* data_ptr, uint32_t num_bytes);
+
+  /**
+   * @brief Get the next frame to transmit
+   *
+   * @return true Frame has to be transmitted / false transfer finished or waiting for flow control
+   */
+  [[nodiscard]] bool getNextFrame(Frame& frame);
+
+  /** \brief Processes a received flow control frame */
+  void processFlowControl(const Frame& frame);
+
+  /** \brief Checks if a transfer is active */
+  [[nodiscard]] bool isTransferActive() const { return _state != State::IDLE; }
+
+  /** \brief Checks if the sender waits for a flow control frame */
+  [[nodiscard]] bool isWaitingForFlowControl() const { return _state == State::WAIT_FLOW_CONTROL; }
+
+  /** \brief Checks if the last transfer was aborted by the receiver */
+  [[nodiscard]] bool isTransferAborted() const { return _aborted; }
+
+  /** \brief Get the min. time between two consecutive frames requested by the receiver in us */
+  [[nodiscard]] uint32_t getSeparationTimeUs() const;
+
+ private:
+  enum class State {
+    IDLE,               //!< No transfer active
+    SINGLE_FRAME,       //!< Single frame has to be transmitted
+    FIRST_FRAME,        //!< First frame has to be transmitted
+    WAIT_FLOW_CONTROL,  //!< Waiting for flow control frame
+    CONSECUTIVE_FRAME,  //!< Consecutive frames have to be transmitted
+  };
+
+  State _state = {State::IDLE};          //!< State of the transfer
+  const uint8_t* _data_ptr = {nullptr};  //!< Pointer to message
+  uint32_t _msg_size = {0U};             //!< Size of message
+  uint32_t _msg_pos = {0U};              //!< Number of bytes transmitted
+  bool _aborted = {false};               //!< Transfer aborted by receiver
+
+  uint8_t _sequence_number = {0U};  //!< Sequence number of next consecutive frame
+  uint8_t _block_size = {0U};       //!< Block size requested by receiver
+  uint8_t _block_frame_cnt = {0U};  //!< Consecutive frames transmitted in current block
+  uint8_t _separation_time = {0U};  //!< Separation time requested by receiver (STmin encoding)
+};
+
+}; /* namespace isotp */
+
+}; /* namespace franklyboot */
+
+#include "isotp.tpp"
+
+#endif /* __cplusplus */
+
+#endif /* FRANCOR_FRANKLYBOOT_ISOTP_H_ */
@@ -0,0 +1,156 @@
+/**
+ * @file isotp.tpp
+ * @author Martin Bauernschmitt (martin.bauernschmitt@francor.de)
+ * @brief ISO-TP Receiver Class Template Deklarations
+ * @version 0.1
+ * @date 2022-11-26
+ *
+ * @copyright Copyright (c) 2022 - BSD-3-clause - FRANCOR e.V.
+ *
+ */
+
+#include "isotp.h"
+
+#ifndef FRANCOR_FRANKLYBOOT_ISOTP_TPP_H_
+#define FRANCOR_FRANKLYBOOT_ISOTP_TPP_H_
+
+namespace franklyboot::isotp {
+
+// Public Functions ---------------------------------------------------------------------------------------------------
+
+template <uint32_t MAX_MSG_SIZE>
+Receiver<MAX_MSG_SIZE>::Receiver(const uint8_t block_size, const uint8_t separation_time)
+    : _block_size(block_size), _separation_time(separation_time) {}
+
+template <uint32_t MAX_MSG_SIZE>
+[[nodiscard]] bool Receiver<MAX_MSG_SIZE>::processFrame(const Frame& frame, Frame& flow_control) {
+  constexpr uint32_t NUM_BITS_PER_BYTE = 8U;
+  constexpr uint8_t PCI_NIBBLE_MASK = 0x0FU;
+
+  const auto frame_type = static_cast<FrameType>(frame[0] & FRAME_TYPE_MASK);
+  bool flow_control_avl = false;
+
+  switch (frame_type) {
+    case FRAME_SINGLE: {
+      const uint32_t num_bytes = frame[0] & PCI_NIBBLE_MASK;
+      const bool size_valid = (num_bytes > 0U) && (num_bytes <= SINGLE_FRAME_MAX_SIZE);
+      if (size_valid && !_msg_avl) {
+        for (auto idx = 0U; idx < num_bytes; idx++) {
+          _msg_buffer[idx] = frame[1U + idx];
+        }
+        _msg_size = num_bytes;
+        _msg_active = false;
+        _msg_avl = true;
+      }
+      break;
+    }
+
+    case FRAME_FIRST: {
+      uint32_t msg_size = (static_cast<uint32_t>(frame[0] & PCI_NIBBLE_MASK) << NUM_BITS_PER_BYTE) | frame[1];
+      uint32_t data_idx = 2U;
+
+      /* Escape sequence -> 32-bit message size */
+      if (msg_size == 0U) {
+        for (auto idx = 0U; idx < sizeof(uint32_t); idx++) {
+          msg_size = (msg_size << NUM_BITS_PER_BYTE) | frame[2U + idx];
+        }
+        data_idx = 6U;
+      }
+
+      const bool size_valid = (msg_size > SINGLE_FRAME_MAX_SIZE) && (msg_size <= MAX_MSG_SIZE);
+      if (size_valid && _msg_avl) {
+        /* Buffer holds the last message -> sender waits, the transfer is continued by releaseMsg() */
+        _first_frame = frame;
+        _first_frame_pending = true;
+        _msg_active = false;
+        createFlowControl(FLOW_WAIT, flow_control);
+      } else if (size_valid) {
+        _msg_size = msg_size;
+        _msg_pos = 0U;
+        for (auto idx = data_idx; idx < FRAME_SIZE; idx++) {
+          _msg_buffer[_msg_pos] = frame[idx];
+          _msg_pos++;
+        }
+
+        _sequence_number = 1U;
+        _block_frame_cnt = 0U;
+        _msg_active = true;
+        createFlowControl(FLOW_CONTINUE, flow_control);
+      } else {
+        _msg_active = false;
+        createFlowControl(FLOW_OVERFLOW, flow_control);
+      }
+
+      flow_control_avl = true;
+      break;
+    }
+
+    case FRAME_CONSECUTIVE: {
+      const uint8_t sequence_number = frame[0] & PCI_NIBBLE_MASK;
+
+      if (!_msg_active) {
+        break;
+      }
+
+      /* Lost frame -> abort message, the sender has to restart the transfer */
+      if (sequence_number != _sequence_number) {
+        _msg_active = false;
+        break;
+      }
+
+      for (auto idx = 1U; (idx < FRAME_SIZE) && (_msg_pos < _msg_size); idx++) {
+        _msg_buffer[_msg_pos] = frame[idx];
+        _msg_pos++;
+      }
+      _sequence_number = (_sequence_number + 1U) & PCI_NIBBLE_MASK;
+
+      if (_msg_pos >= _msg_size) {
+        _msg_active = false;
+        _msg_avl = true;
+      } else if (_block_size > 0U) {
+        _block_frame_cnt++;
+        if (_block_frame_cnt >= _block_size) {
+          _block_frame_cnt = 0U;
+          createFlowControl(FLOW_CONTINUE, flow_control);
+          flow_control_avl = true;
+        }
+      }
+      break;
+    }
+
+    case FRAME_FLOW_CONTROL:
+    default:
+      /* Receiver does not transmit segmented messages */
+      break;
+  }
+
+  return flow_control_avl;
+}
+
+template <uint32_t MAX_MSG_SIZE>
+[[nodiscard]] bool Receiver<MAX_MSG_SIZE>::releaseMsg(Frame& flow_control) {
+  _msg_avl = false;
+  _msg_size = 0U;
+  _msg_pos = 0U;
+
+  if (_first_frame_pending) {
+    _first_frame_pending = false;
+    return processFrame(_first_frame, flow_control);
+  }
+
+  return false;
+}
+
+// Private Functions --------------------------------------------------------------------------------------------------
+
+template <uint32_t MAX_MSG_SIZE>
+void Receiver<MAX_MSG_SIZE>::createFlowControl(const FlowStatus status, Frame& flow_control) const {
+  flow_control.fill(FRAME_PADDING);
+  flow_control[0] = FRAME_FLOW_CONTROL | status;
+  flow_control[1] = _block_size;
+  flow_control[2] = _separation_time;
+}
+
+}; /* namespace franklyboot::isotp */
+
+#endif /* FRANCOR_FRANKLYBOOT_ISOTP_TPP_H_ */
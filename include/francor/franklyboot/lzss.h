@@ -0,0 +1,177 @@
+/**
+ * @file lzss.h
+ * @author Martin Bauernschmitt (martin.bauernschmitt@francor.de)
+ * @brief Streaming LZSS decompression (heatshrink compatible bit stream)
+ * @version 0.1
+ * @date 2022-11-26
+ *
+ * @copyright Copyright (c) 2022 - BSD-3-clause - FRANCOR e.V.
+ *
+ */
+
+#ifndef FRANCOR_FRANKLYBOOT_LZSS_H_
+#define FRANCOR_FRANKLYBOOT_LZSS_H_
+
+#ifdef __cplusplus
+
+#include <cstdint>
+
+/**
+ * @brief Groups all definitions of the LZSS decompression
+ *
+ * The compressed stream is a sequence of bits (MSB first):
+ *   - Literal:        1 | byte (8 bits)
+ *   - Back-reference: 0 | distance - 1 (WINDOW_BITS) | length - 1 (LENGTH_BITS)
+ *
+ * A back-reference copies length bytes starting distance bytes behind the current output position,
+ * source and destination may overlap (runs). Unused bits of the last byte are ignored.
+ */
+namespace franklyboot::lzss {
+
+/** \brief Default number of bits of the length of a back-reference (max. 16 bytes) */
+constexpr uint32_t LENGTH_BITS_DEFAULT = 4U;
+
+/** \brief Number of bits of a literal */
+constexpr uint32_t LITERAL_BITS = 8U;
+
+/**
+ * @brief Streaming LZSS decoder
+ *
+ * Decodes into a fixed output buffer (e.g. the page buffer). The already decoded output is used as window of
+ * the back-references, so besides the output buffer the decoder only requires a few bytes of state. The
+ * compressed stream can be passed in chunks of any size (e.g. message payloads). The output buffer is passed
+ * with every chunk and not stored, so the owner of the buffer (e.g. the handler) stays copyable and movable.
+ *
+ * @param WINDOW_BITS Number of bits of the distance of a back-reference (max. distance 2^WINDOW_BITS bytes)
+ * @param LENGTH_BITS Number of bits of the length of a back-reference (max. length 2^LENGTH_BITS bytes)
+ */
+template <uint32_t WINDOW_BITS, uint32_t LENGTH_BITS = LENGTH_BITS_DEFAULT>
+class Decoder {
+ public:
+  /**
+   * @brief Resets the decoder
+   *
+   * @param dst_size Size of the output buffer (number of bytes of the decoded stream)
+   */
+  void reset(const uint32_t dst_size) {
+    _dst_size = dst_size;
+    _dst_pos = 0U;
+    _state = State::TAG;
+    _field_value = 0U;
+    _field_num_bits = 0U;
+    _backref_distance = 0U;
+    _valid = true;
+  }
+
+  /**
+   * @brief Decodes a chunk of the compressed stream
+   *
+   * Decoding stops if the output buffer is complete, remaining bits (padding) are ignored.
+   *
+   * @param dst_ptr Output buffer (dst_size of reset()), the same buffer has to be passed for every chunk
+   * @param src_ptr Chunk of the compressed stream
+   * @param num_bytes Size of the chunk
+   * @return false Stream is invalid (back-reference in front of / behind the output buffer)
+   */
+  bool processData(uint8_t* dst_ptr, const uint8_t* src_ptr, const uint32_t num_bytes) {
+    for (auto byte_idx = 0U; (byte_idx < num_bytes) && _valid && !isComplete(); byte_idx++) {
+      for (auto bit_idx = 0U; (bit_idx < BITS_PER_BYTE) && _valid && !isComplete(); bit_idx++) {
+        processBit(dst_ptr, (src_ptr[byte_idx] >> (BITS_PER_BYTE - 1U - bit_idx)) & 1U);
+      }
+    }
+
+    return _valid;
+  }
+
+  [[nodiscard]] bool isComplete() const { return (_dst_pos >= _dst_size); }
+  [[nodiscard]] bool isValid() const { return _valid; }
+  [[nodiscard]] uint32_t getNumBytesDecoded() const { return _dst_pos; }
+
+ private:
+  enum class State : uint8_t {
+    TAG,             //!< Tag bit (literal / back-reference)
+    LITERAL,         //!< Literal byte
+    BACKREF_INDEX,   //!< Distance of back-reference
+    BACKREF_LENGTH,  //!< Length of back-reference
+  };
+
+  static constexpr uint32_t BITS_PER_BYTE = 8U;
+
+  /** \brief Reads a bit into the current field, returns true if the field is complete */
+  bool readField(const uint32_t bit, const uint32_t num_bits) {
+    _field_value = (_field_value << 1U) | bit;
+    _field_num_bits++;
+    return (_field_num_bits >= num_bits);
+  }
+
+  void processBit(uint8_t* dst_ptr, const uint32_t bit) {
+    switch (_state) {
+      case State::TAG:
+        _state = (bit != 0U) ? State::LITERAL : State::BACKREF_INDEX;
+        break;
+
+      case State::LITERAL:
+        if (readField(bit, LITERAL_BITS)) {
+          dst_ptr[_dst_pos] = static_cast<uint8_t>(_field_value);
+          _dst_pos++;
+          nextSymbol();
+        }
+        break;
+
+      case State::BACKREF_INDEX:
+        if (readField(bit, WINDOW_BITS)) {
+          _backref_distance = _field_value + 1U;
+          _field_value = 0U;
+          _field_num_bits = 0U;
+          _state = State::BACKREF_LENGTH;
+        }
+        break;
+
+      case State::BACKREF_LENGTH:
+        if (readField(bit, LENGTH_BITS)) {
+          copyBackref(dst_ptr, _field_value + 1U);
+          nextSymbol();
+        }
+        break;
+    }
+  }
+
+  void copyBackref(uint8_t* dst_ptr, const uint32_t length) {
+    const bool distance_valid = (_backref_distance <= _dst_pos);
+    const bool length_valid = (length <= (_dst_size - _dst_pos));
+    _valid = distance_valid && length_valid;
+
+    if (_valid) {
+      /* Byte by byte, source and destination may overlap */
+      for (auto idx = 0U; idx < length; idx++) {
+        dst_ptr[_dst_pos] = dst_ptr[_dst_pos - _backref_distance];
+        _dst_pos++;
+      }
+    }
+  }
+
+  void nextSymbol() {
+    _state = State::TAG;
+    _field_value = 0U;
+    _field_num_bits = 0U;
+  }
+
+  uint32_t _dst_size = {0U};  //!< Size of output buffer
+  uint32_t _dst_pos = {0U};   //!< Number of decoded bytes
+
+  State _state = {State::TAG};        //!< Field of the stream the next bit belongs to
+  uint32_t _field_value = {0U};       //!< Bits of the current field received so far
+  uint32_t _field_num_bits = {0U};    //!< Number of bits of the current field received so far
+  uint32_t _backref_distance = {0U};  //!< Distance of the current back-reference
+  bool _valid = {true};               //!< Stream valid
+
+  /* STATIC ASSERT TESTS */
+  static_assert((WINDOW_BITS > 0U) && (WINDOW_BITS <= 16U), "WINDOW_BITS has to be in range 1 ... 16!");
+  static_assert((LENGTH_BITS > 0U) && (LENGTH_BITS <= 8U), "LENGTH_BITS has to be in range 1 ... 8!");
+};
+
+};  // namespace franklyboot::lzss
+
+#endif /* __cplusplus */
+
+#endif /* FRANCOR_FRANKLYBOOT_LZSS_H_ */
@@ -33,15 +33,18 @@ namespace msg {
  * @brief Result of request send as response
  */
 enum ResultType : uint8_t {
-  RES_NONE = 0x00U,  //!< No result / not specified
-  RES_OK = 0x01U,    //!< Message was processed successfully / result ok
-
-  RES_ERR = 0xFEU,                //!< General error
-  RES_ERR_UNKNOWN_REQ = 0xFDU,    //!< Unknow request type
-  RES_ERR_NOT_SUPPORTED = 0xFCU,  //!< Error, command known but not supported
-  RES_ERR_CRC_INVLD = 0xFBU,      //!< Error, CRC check failed
-  RES_ERR_PAGE_FULL = 0xFAU,      //!< Error, word not writable page buffer is full
-  RES_ERR_INVLD_ARG = 0xF9U,      //!< Error, invalid argument (out of range, ...)
+  RES_NONE = 0x00U,          //!< No result / not specified
+  RES_OK = 0x01U,            //!< Message was processed successfully / result ok
+  RES_OK_UNCHANGED = 0x02U,  //!< Message was processed successfully, flash already up to date (nothing written)
+  RES_BUSY = 0x03U,          //!< Background operation running (request rejected, poll status and repeat)
+
+  RES_ERR = 0xFEU,                  //!< General error
+  RES_ERR_UNKNOWN_REQ = 0xFDU,      //!< Unknow request type
+  RES_ERR_NOT_SUPPORTED = 0xFCU,    //!< Error, command known but not supported
+  RES_ERR_CRC_INVLD = 0xFBU,        //!< Error, CRC check failed
+  RES_ERR_PAGE_FULL = 0xFAU,        //!< Error, word not writable page buffer is full
+  RES_ERR_INVLD_ARG = 0xF9U,        //!< Error, invalid argument (out of range, ...)
+  RES_ERR_PAGE_INCOMPLETE = 0xF8U,  //!< Error, page buffer not completely received
 };
 
 /**
@@ -66,6 +69,10 @@ enum RequestType : uint16_t {
   REQ_DEV_INFO_UID_3 = 0x0108U,  //!< Reads the device unique ID bit [64:95]
   REQ_DEV_INFO_UID_4 = 0x0109U,  //!< Reads the device unique ID bit [96:127]
 
+  /* Device inventory */
+  REQ_DEV_INFO_INVENTORY = 0x010AU,     //!< Reads all device, flash and app information / multi-frame response
+  REQ_DEV_INFO_CAPABILITIES = 0x010BU,  //!< Reads the supported features and limits / multi-frame response
+
   /* Flash information */
   REQ_FLASH_INFO_START_ADDR = 0x0201U,  //!< Get the start address of the flash area
   REQ_FLASH_INFO_PAGE_SIZE = 0x0202U,   //!< Get the size in bytes of a page
@@ -77,69 +84,197 @@ enum RequestType : uint16_t {
   REQ_APP_INFO_CRC_STRD = 0x0303U,  //!< Get the stored CRC value used for safe startup
 
   /* Flash Read commands */
-  REQ_FLASH_READ_WORD = 0x0401U,  //!< Reads a word from the flash
+  REQ_FLASH_READ_WORD = 0x0401U,      //!< Reads a word from the flash
+  REQ_FLASH_READ_BLOCK = 0x0402U,     //!< Reads a block from the flash / streamed in consecutive responses
+  REQ_FLASH_READ_PAGE_CRC = 0x0403U,  //!< Calculates the CRC over a flash page or a run of flash pages
+  REQ_FLASH_READ_CRC = 0x0404U,       //!< Calculates the CRC over an address range of the flash
 
   /* Page Buffer Commands */
-  REQ_PAGE_BUFFER_CLEAR = 0x1001U,           //!< Clears the page buffer (RAM)
-  REQ_PAGE_BUFFER_READ_WORD = 0x1002U,       //!< Reads a word to the page buffer (RAM)
-  REQ_PAGE_BUFFER_WRITE_WORD = 0x1003U,      //!< Writes a word to the page buffer (RAM)
-  REQ_PAGE_BUFFER_CALC_CRC = 0x1004U,        //!< Calculates the CRC over the page buffer
-  REQ_PAGE_BUFFER_WRITE_TO_FLASH = 0x1005U,  //!< Write the page buffer to the desired flash page
+  REQ_PAGE_BUFFER_CLEAR = 0x1001U,             //!< Clears the page buffer (RAM)
+  REQ_PAGE_BUFFER_READ_WORD = 0x1002U,         //!< Reads a word to the page buffer (RAM)
+  REQ_PAGE_BUFFER_WRITE_WORD = 0x1003U,        //!< Writes a word to the page buffer (RAM)
+  REQ_PAGE_BUFFER_CALC_CRC = 0x1004U,          //!< Calculates the CRC over the page buffer
+  REQ_PAGE_BUFFER_WRITE_TO_FLASH = 0x1005U,    //!< Write the page buffer to the desired flash page
+  REQ_PAGE_BUFFER_STREAM_WORD = 0x1006U,       //!< Writes a word to the page buffer (RAM) / acknowledged per window
+  REQ_PAGE_BUFFER_WRITE_BLOCK = 0x1007U,       //!< Writes a data block to the page buffer (RAM) / segmented transports
+  REQ_PAGE_BUFFER_MISSING_WORDS = 0x1008U,     //!< Reads a bitmap of the words missing in the page buffer (RAM)
+  REQ_PAGE_BUFFER_WRITE_WORD_AT = 0x1009U,     //!< Writes a word at a 16-bit word index to the page buffer (RAM)
+  REQ_PAGE_BUFFER_WRITE_BLOCK_AT = 0x100AU,    //!< Writes a data block at a byte offset to the page buffer (RAM)
+  REQ_PAGE_BUFFER_STATUS = 0x100BU,            //!< Reads the number of words received by the page buffer (RAM)
+  REQ_PAGE_BUFFER_WRITE_COMPRESSED = 0x100CU,  //!< Writes LZSS compressed data to the page buffer (RAM)
+  REQ_PAGE_BUFFER_COPY_FROM_FLASH = 0x100DU,   //!< Copies words from the flash to the page buffer (RAM) / delta updates
+  REQ_PAGE_BUFFER_FILL = 0x100EU,              //!< Fills words of the page buffer (RAM) with a 32-bit pattern
+  REQ_PAGE_BUFFER_COMMIT_STATUS = 0x100FU,     //!< Reads the result of the last flash write of a page buffer
 
   /* Flash Write Commands*/
-  REQ_FLASH_WRITE_ERASE_PAGE = 0x1101U,  //!< Erases an flash page
-  REQ_FLASH_WRITE_APP_CRC = 0x1102U,     //!< Writes the CRC of the app to the flash
+  REQ_FLASH_WRITE_ERASE_PAGE = 0x1101U,    //!< Erases an flash page
+  REQ_FLASH_WRITE_APP_CRC = 0x1102U,       //!< Writes the CRC of the app to the flash
+  REQ_FLASH_WRITE_ERASE_RANGE = 0x1103U,   //!< Erases a range of app pages in the background
+  REQ_FLASH_WRITE_ERASE_STATUS = 0x1104U,  //!< Reads the progress of the background erase
 
 };
 
-/** \brief Definition of the MsgData representation */
-using MsgRaw = std::array<uint8_t, 8U>;
-using MsgData = std::array<uint8_t, 4U>;
+/**
+ * @brief Fields of the REQ_DEV_INFO_INVENTORY response
+ *
+ * Every field is a 32-bit word. The fields are transmitted in this order, as many fields
+ * per response frame as fitting into the message payload (1 on CAN, 15 on CAN-FD).
+ */
+enum InventoryField : uint8_t {
+  INV_BOOTLOADER_VERSION = 0U,  //!< Bootloader version (major | minor << 8 | patch << 16)
+  INV_VID = 1U,                 //!< Vendor id
+  INV_PID = 2U,                 //!< Product id
+  INV_PRD = 3U,                 //!< Production date
+  INV_UID_1 = 4U,               //!< Unique ID bit [0:31]
+  INV_UID_2 = 5U,               //!< Unique ID bit [32:63]
+  INV_UID_3 = 6U,               //!< Unique ID bit [64:95]
+  INV_UID_4 = 7U,               //!< Unique ID bit [96:127]
+  INV_FLASH_START_ADDR = 8U,    //!< Start address of the flash
+  INV_FLASH_PAGE_SIZE = 9U,     //!< Size of a flash page
+  INV_FLASH_NUM_PAGES = 10U,    //!< Number of flash pages
+  INV_APP_PAGE_IDX = 11U,       //!< First page of the app area
+  INV_APP_CRC_CALC = 12U,       //!< Calculated CRC of the app area
+  INV_APP_CRC_STRD = 13U,       //!< Stored CRC of the app area
+  INV_NUM_FIELDS = 14U,         //!< Number of fields
+};
 
 /**
- * @brief Representation of a bootloader message
+ * @brief Fields of the REQ_DEV_INFO_CAPABILITIES response
+ *
+ * Transmitted like the inventory fields (32-bit words, as many per frame as fitting into the payload).
  */
-struct Msg {
-  Msg() = default;
-  Msg(RequestType req, ResultType res, uint8_t packet_id)
+enum CapabilityField : uint8_t {
+  CAP_FEATURES = 0U,                   //!< Bitmap of supported features (see CapabilityFeature)
+  CAP_MSG_DATA_SIZE = 1U,              //!< Payload size of a message (page buffer word size)
+  CAP_STREAM_WINDOW_SIZE = 2U,         //!< Number of streamed words acknowledged with one response
+  CAP_NUM_PAGE_BUFFERS = 3U,           //!< Number of page buffers
+  CAP_DECOMPRESSION_WINDOW_BITS = 4U,  //!< Window bits of compressed uploads (0 = not supported)
+  CAP_QUEUE_SIZE = 5U,                 //!< Number of entries of the request queue (0 = no queue)
+  CAP_NUM_FIELDS = 6U,                 //!< Number of fields
+};
+
+/**
+ * @brief Feature bits of the CAP_FEATURES field
+ */
+enum CapabilityFeature : uint32_t {
+  FEATURE_INVENTORY = 0x00000001U,         //!< REQ_DEV_INFO_INVENTORY
+  FEATURE_FLASH_READ_BLOCK = 0x00000002U,  //!< REQ_FLASH_READ_BLOCK, REQ_FLASH_READ_PAGE_CRC, REQ_FLASH_READ_CRC
+  FEATURE_STREAM_WORD = 0x00000004U,       //!< REQ_PAGE_BUFFER_STREAM_WORD
+  FEATURE_MISSING_WORDS = 0x00000008U,     //!< REQ_PAGE_BUFFER_MISSING_WORDS, REQ_PAGE_BUFFER_STATUS
+  FEATURE_RANDOM_ACCESS = 0x00000010U,     //!< REQ_PAGE_BUFFER_WRITE_WORD_AT, REQ_PAGE_BUFFER_WRITE_BLOCK_AT
+  FEATURE_COMPRESSION = 0x00000020U,       //!< REQ_PAGE_BUFFER_WRITE_COMPRESSED
+  FEATURE_COPY_FROM_FLASH = 0x00000040U,   //!< REQ_PAGE_BUFFER_COPY_FROM_FLASH
+  FEATURE_FILL = 0x00000080U,              //!< REQ_PAGE_BUFFER_FILL
+  FEATURE_WRITE_COMPARE = 0x00000100U,     //!< WRITE_TO_FLASH_COMPARE
+  FEATURE_WRITE_VERIFY = 0x00000200U,      //!< WRITE_TO_FLASH_VERIFY
+  FEATURE_REQUEST_QUEUE = 0x00000400U,     //!< Requests are queued (Handler::pushRequest())
+  FEATURE_ERASE_RANGE = 0x00000800U,       //!< REQ_FLASH_WRITE_ERASE_RANGE, REQ_FLASH_WRITE_ERASE_STATUS
+  FEATURE_WRITE_DEFER = 0x00001000U,       //!< WRITE_TO_FLASH_DEFER (more than one page buffer)
+};
+
+/**
+ * @brief Flags of REQ_PAGE_BUFFER_WRITE_TO_FLASH
+ *
+ * The flags are transmitted in the result field of the request (RES_NONE = no flags).
+ */
+enum WriteToFlashFlag : uint8_t {
+  WRITE_TO_FLASH_COMPARE = 0x01U,  //!< Compare page buffer with flash first, skip erase and write if equal
+  WRITE_TO_FLASH_VERIFY = 0x02U,   //!< Verify written page against page buffer, respond with CRC of flash page
+  WRITE_TO_FLASH_DEFER = 0x04U,    //!< Write in the background, next page buffer receives meanwhile (N page buffers)
+};
+
+/** \brief Size of the message header (request type, result type and packet id) */
+constexpr size_t MSG_HEADER_SIZE = {4U};
+
+/** \brief Payload size of a message transmitted within a classic CAN frame (8 bytes) */
+constexpr size_t MSG_DATA_SIZE_CAN = {4U};
+
+/** \brief Payload size of a message transmitted within a CAN-FD frame (64 bytes) */
+constexpr size_t MSG_DATA_SIZE_CAN_FD = {60U};
+
+/** \brief Definition of the raw message representation with variable payload size */
+template <size_t DATA_SIZE>
+using BasicMsgRaw = std::array<uint8_t, MSG_HEADER_SIZE + DATA_SIZE>;
+
+/** \brief Definition of the message payload representation with variable payload size */
+template <size_t DATA_SIZE>
+using BasicMsgData = std::array<uint8_t, DATA_SIZE>;
+
+/**
+ * @brief Representation of a bootloader message with variable payload size
+ *
+ * @param DATA_SIZE Number of payload bytes (4 for CAN, up to 60 for CAN-FD)
+ */
+template <size_t DATA_SIZE>
+struct BasicMsg {
+  BasicMsg() = default;
+  BasicMsg(RequestType req, ResultType res, uint8_t packet_id)
       : request(req), result(res), packet_id(packet_id), data({0}) {}
 
   RequestType request;
   ResultType result;
   uint8_t packet_id;
-  MsgData data;  // Maybe union and use std::array
+  BasicMsgData<DATA_SIZE> data;
+
+  static_assert(DATA_SIZE >= sizeof(uint32_t), "DATA_SIZE has to be large enough to carry a 32-bit word!");
+  static_assert(DATA_SIZE <= MSG_DATA_SIZE_CAN_FD, "DATA_SIZE cannot be larger than the payload of a CAN-FD frame!");
 };
 
+/** \brief Definition of the default (CAN) message representation */
+using MsgRaw = BasicMsgRaw<MSG_DATA_SIZE_CAN>;
+using MsgData = BasicMsgData<MSG_DATA_SIZE_CAN>;
+using Msg = BasicMsg<MSG_DATA_SIZE_CAN>;
+
 /**
  * @brief Converts a unsigned int 32-bit value to the message buffer
  *
+ * Only four bytes of the message buffer are written (starting at byte_offset).
+ *
  * @param data Data to serialzize as word
  * @param msg_data Reference to data container (bytes)
+ * @param byte_offset Position of the word in the message buffer
  */
-void convertU32ToMsgData(uint32_t data, msg::MsgData& msg_data);
+template <size_t DATA_SIZE>
+void convertU32ToMsgData(uint32_t data, msg::BasicMsgData<DATA_SIZE>& msg_data, size_t byte_offset = 0U);
 
 /**
  * @brief Converts the message buffer to a unsigned int 32-bit value
  *
+ * Only four bytes of the message buffer are read (starting at byte_offset).
+ *
  * @param msg_data msg_data Reference to data container (bytes)
+ * @param byte_offset Position of the word in the message buffer
  * @return uint32_t Deserialized word
  */
-uint32_t convertMsgDataToU32(const msg::MsgData& msg_data);
+template <size_t DATA_SIZE>
+uint32_t convertMsgDataToU32(const msg::BasicMsgData<DATA_SIZE>& msg_data, size_t byte_offset = 0U);
 
 /**
  * @brief Converts a byte array to a message struct
+ *
+ * The payload size of the message is derived from the frame size (FRAME_SIZE - MSG_HEADER_SIZE)
  */
-msg::Msg convertBytesToMsg(const msg::MsgRaw& msg_raw);
+template <size_t FRAME_SIZE>
+msg::BasicMsg<FRAME_SIZE - MSG_HEADER_SIZE> convertBytesToMsg(const std::array<uint8_t, FRAME_SIZE>& msg_raw);
 
 /**
  * @brief Converts a msg to a byte array
  */
-msg::MsgRaw convertMsgToBytes(const msg::Msg& msg);
+template <size_t DATA_SIZE>
+msg::BasicMsgRaw<DATA_SIZE> convertMsgToBytes(const msg::BasicMsg<DATA_SIZE>& msg);
+
+/* Default (CAN) message conversions are compiled into the library (see msg.cpp) */
+extern template void convertU32ToMsgData<MSG_DATA_SIZE_CAN>(uint32_t data, msg::MsgData& msg_data, size_t byte_offset);
+extern template uint32_t convertMsgDataToU32<MSG_DATA_SIZE_CAN>(const msg::MsgData& msg_data, size_t byte_offset);
+extern template msg::Msg convertBytesToMsg<MSG_HEADER_SIZE + MSG_DATA_SIZE_CAN>(const msg::MsgRaw& msg_raw);
+extern template msg::MsgRaw convertMsgToBytes<MSG_DATA_SIZE_CAN>(const msg::Msg& msg);
 
 }; /* namespace msg */
 
 }; /* namespace franklyboot */
 
+#include "msg.tpp"
+
 #endif /* __cplusplus */
 
 #endif /* FRANCOR_FRANKLYBOOT_MSG_H_ */
\ No newline at end of file
@@ -0,0 +1,79 @@
+/**
+ * @file msg.tpp
+ * @author Martin Bauernschmitt (martin.bauernschmitt@francor.de)
+ * @brief Template definitions of the message handling utilities
+ * @version 0.1
+ * @date 2022-11-26
+ *
+ * @copyright Copyright (c) 2022 - BSD-3-clause - FRANCOR e.V.
+ *
+ */
+
+#include "msg.h"
+
+#ifndef FRANCOR_FRANKLYBOOT_MSG_TPP_H_
+#define FRANCOR_FRANKLYBOOT_MSG_TPP_H_
+
+namespace franklyboot::msg {
+
+template <size_t DATA_SIZE>
+void convertU32ToMsgData(const uint32_t data, msg::BasicMsgData<DATA_SIZE>& msg_data, const size_t byte_offset) {
+  constexpr uint32_t NUM_BITS_PER_BYTE = 8U;
+
+  for (uint32_t idx = 0U; idx < sizeof(uint32_t); idx++) {
+    msg_data[byte_offset + idx] = static_cast<uint8_t>(data >> (idx * NUM_BITS_PER_BYTE));
+  }
+}
+
+template <size_t DATA_SIZE>
+uint32_t convertMsgDataToU32(const msg::BasicMsgData<DATA_SIZE>& msg_data, const size_t byte_offset) {
+  constexpr uint32_t NUM_BITS_PER_BYTE = 8U;
+
+  uint32_t value = 0;
+  for (auto idx = 0U; idx < sizeof(uint32_t); idx++) {
+    value |= (static_cast<uint32_t>(msg_data.at(byte_offset + idx)) << (idx * NUM_BITS_PER_BYTE));
+  }
+
+  return value;
+}
+
+template <size_t FRAME_SIZE>
+msg::BasicMsg<FRAME_SIZE - MSG_HEADER_SIZE> convertBytesToMsg(const std::array<uint8_t, FRAME_SIZE>& msg_raw) {
+  constexpr uint32_t NUM_BITS_PER_BYTE = 8U;
+
+  const uint16_t request_raw =
+      static_cast<uint16_t>(msg_raw.at(0)) | (static_cast<uint16_t>(msg_raw.at(1)) << NUM_BITS_PER_BYTE);
+
+  msg::BasicMsg<FRAME_SIZE - MSG_HEADER_SIZE> msg;
+  msg.request = static_cast<msg::RequestType>(request_raw);
+  msg.result = static_cast<msg::ResultType>(msg_raw.at(2));
+  msg.packet_id = static_cast<uint8_t>(msg_raw.at(3));
+
+  for (auto idx = 0U; idx < msg.data.size(); idx++) {
+    msg.data.at(idx) = msg_raw.at(MSG_HEADER_SIZE + idx);
+  }
+
+  return msg;
+}
+
+template <size_t DATA_SIZE>
+msg::BasicMsgRaw<DATA_SIZE> convertMsgToBytes(const msg::BasicMsg<DATA_SIZE>& msg) {
+  constexpr uint32_t NUM_BITS_PER_BYTE = 8U;
+
+  msg::BasicMsgRaw<DATA_SIZE> msg_raw;
+
+  msg_raw.at(0) = static_cast<uint8_t>(msg.request);
+  msg_raw.at(1) = static_cast<uint8_t>(msg.request >> NUM_BITS_PER_BYTE);
+  msg_raw.at(2) = static_cast<uint8_t>(msg.result);
+  msg_raw.at(3) = static_cast<uint8_t>(msg.packet_id);
+
+  for (auto idx = 0U; idx < msg.data.size(); idx++) {
+    msg_raw.at(MSG_HEADER_SIZE + idx) = msg.data.at(idx);
+  }
+
+  return msg_raw;
+}
+
+}; /* namespace franklyboot::msg */
+
+#endif /* FRANCOR_FRANKLYBOOT_MSG_TPP_H_ */
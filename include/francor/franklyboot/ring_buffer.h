@@ -0,0 +1,105 @@
+/**
+ * @file ring_buffer.h
+ * @author Martin Bauernschmitt (martin.bauernschmitt@francor.de)
+ * @brief Single producer / single consumer ring buffer
+ * @version 0.1
+ * @date 2022-11-26
+ *
+ * @copyright Copyright (c) 2022 - BSD-3-clause - FRANCOR e.V.
+ *
+ */
+
+#ifndef FRANCOR_FRANKLYBOOT_RING_BUFFER_H_
+#define FRANCOR_FRANKLYBOOT_RING_BUFFER_H_
+
+#ifdef __cplusplus
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Groups all definitions of the frankly boot bootloader
+ */
+namespace franklyboot {
+
+/**
+ * @brief Ring buffer with a fixed number of entries
+ *
+ * Lock free for exactly one producer and one consumer, e.g. a receive ISR pushing
+ * entries and the main loop popping them.
+ *
+ * @param T Type of an entry
+ * @param SIZE Max. number of entries (power of two, the free running indices wrap at 2^32)
+ */
+template <typename T, size_t SIZE>
+class RingBuffer {
+ public:
+  RingBuffer() = default;
+
+  /** \brief Copy the ring buffer (only allowed if producer and consumer are inactive) */
+  RingBuffer(const RingBuffer& other) : _buffer(other._buffer), _head(other._head.load()), _tail(other._tail.load()) {}
+
+  RingBuffer& operator=(const RingBuffer& other) {
+    _buffer = other._buffer;
+    _head.store(other._head.load());
+    _tail.store(other._tail.load());
+    return *this;
+  }
+
+  /**
+   * @brief Pushes an entry to the buffer (producer)
+   *
+   * @return true Entry stored / false buffer is full
+   */
+  bool push(const T& entry) {
+    const uint32_t head = _head.load(std::memory_order_relaxed);
+    if ((head - _tail.load(std::memory_order_acquire)) >= SIZE) {
+      return false;
+    }
+
+    _buffer[head % SIZE] = entry;
+    _head.store(head + 1U, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Pops the oldest entry from the buffer (consumer)
+   *
+   * @return true Entry available / false buffer is empty
+   */
+  bool pop(T& entry) {
+    const uint32_t tail = _tail.load(std::memory_order_relaxed);
+    if (tail == _head.load(std::memory_order_acquire)) {
+      return false;
+    }
+
+    entry = _buffer[tail % SIZE];
+    _tail.store(tail + 1U, std::memory_order_release);
+    return true;
+  }
+
+  /** \brief Removes all entries (only allowed if producer and consumer are inactive) */
+  void clear() { _tail.store(_head.load()); }
+
+  [[nodiscard]] bool isEmpty() const { return getNumEntries() == 0U; }
+  [[nodiscard]] bool isFull() const { return getNumEntries() >= SIZE; }
+  [[nodiscard]] uint32_t getNumEntries() const { return _head.load() - _tail.load(); }
+  [[nodiscard]] static constexpr size_t getSize() { return SIZE; }
+
+ private:
+  std::array<T, SIZE> _buffer = {};    //!< Entries
+  std::atomic<uint32_t> _head = {0U};  //!< Number of pushed entries (written by producer)
+  std::atomic<uint32_t> _tail = {0U};  //!< Number of popped entries (written by consumer)
+
+  /* STATIC ASSERT TESTS */
+  static_assert((SIZE & (SIZE - 1U)) == 0U,
+                "SIZE has to be a power of two, otherwise the entry index jumps when head / tail wrap at 2^32!");
+};
+
+}; /* namespace franklyboot */
+
+#endif /* __cplusplus */
+
+#endif /* FRANCOR_FRANKLYBOOT_RING_BUFFER_H_ */
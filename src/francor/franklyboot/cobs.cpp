@@ -0,0 +1,192 @@
+/**
+ * @file cobs.cpp
+ * @author Martin Bauernschmitt (martin.bauernschmitt@francor.de)
+ * @brief Source file of the COBS framing layer
+ * @version 0.1
+ * @date 2022-11-26
+ *
+ * @copyright Copyright (c) 2022 - BSD-3-clause - FRANCOR e.V.
+ *
+ */
+
+#include "francor/franklyboot/cobs.h"
+
+namespace franklyboot::cobs {
+
+/** \brief Number of bits per byte */
+constexpr uint32_t NUM_BITS_PER_BYTE = {8U};
+
+/** \brief Code byte of a COBS block with max. size (no zero appended) */
+constexpr uint8_t COBS_CODE_MAX = {0xFFU};
+
+[[nodiscard]] uint32_t updateCRC(uint32_t crc, const uint8_t byte) {
+  /* CRC32 (reflected polynomial 0xEDB88320) nibble table */
+  static constexpr std::array<uint32_t, 16U> CRC_TABLE = {
+      0x00000000U, 0x1DB71064U, 0x3B6E20C8U, 0x26D930ACU, 0x76DC4190U, 0x6B6B51F4U, 0x4DB26158U, 0x5005713CU,
+      0xEDB88320U, 0xF00F9344U, 0xD6D6A3E8U, 0xCB61B38CU, 0x9B64C2B0U, 0x86D3D2D4U, 0xA00AE278U, 0xBDBDF21CU,
+  };
+  constexpr uint32_t NIBBLE_MASK = 0x0FU;
+  constexpr uint32_t NIBBLE_SHIFT = 4U;
+
+  crc = CRC_TABLE[(crc ^ byte) & NIBBLE_MASK] ^ (crc >> NIBBLE_SHIFT);
+  crc = CRC_TABLE[(crc ^ (byte >> NIBBLE_SHIFT)) & NIBBLE_MASK] ^ (crc >> NIBBLE_SHIFT);
+  return crc;
+}
+
+[[nodiscard]] uint32_t encodeFrame(const msg::Msg &msg, const uint8_t *block_ptr, const uint32_t block_size,
+                                   uint8_t *dst_ptr, const uint32_t dst_size) {
+  const bool block_valid = (block_size == 0U) || (block_ptr != nullptr);
+  const bool dst_valid = (dst_ptr != nullptr) && (dst_size >= getMaxEncodedSize(block_size));
+  if (!block_valid || !dst_valid) {
+    return 0U;
+  }
+
+  /* Calculate CRC over message and block */
+  const auto msg_raw = msg::convertMsgToBytes(msg);
+  uint32_t crc = CRC_INIT_VALUE;
+  for (const auto byte : msg_raw) {
+    crc = updateCRC(crc, byte);
+  }
+  for (auto idx = 0U; idx < block_size; idx++) {
+    crc = updateCRC(crc, block_ptr[idx]);
+  }
+  crc = finalizeCRC(crc);
+
+  /* Encode [CRC | msg | block] */
+  uint32_t code_idx = 0U;
+  uint32_t dst_idx = 1U;
+  uint8_t code = 1U;
+
+  const uint32_t decoded_size = FRAME_HEADER_SIZE + block_size;
+  for (auto pos = 0U; pos < decoded_size; pos++) {
+    uint8_t byte = 0U;
+    if (pos < FRAME_CRC_SIZE) {
+      byte = static_cast<uint8_t>(crc >> (pos * NUM_BITS_PER_BYTE));
+    } else if (pos < FRAME_HEADER_SIZE) {
+      byte = msg_raw[pos - FRAME_CRC_SIZE];
+    } else {
+      byte = block_ptr[pos - FRAME_HEADER_SIZE];
+    }
+
+    if (byte == FRAME_DELIMITER) {
+      dst_ptr[code_idx] = code;
+      code_idx = dst_idx++;
+      code = 1U;
+    } else {
+      dst_ptr[dst_idx++] = byte;
+      code++;
+
+      if (code == COBS_CODE_MAX) {
+        dst_ptr[code_idx] = code;
+        code_idx = dst_idx++;
+        code = 1U;
+      }
+    }
+  }
+
+  dst_ptr[code_idx] = code;
+  dst_ptr[dst_idx++] = FRAME_DELIMITER;
+
+  return dst_idx;
+}
+
+// Decoder ------------------------------------------------------------------------------------------------------------
+
+void Decoder::setBlockBuffer(uint8_t *block_ptr, const uint32_t block_size) {
+  _block_buffer_ptr = block_ptr;
+  _block_buffer_size = (block_ptr != nullptr) ? block_size : 0U;
+}
+
+bool Decoder::processByte(const uint8_t byte) {
+  if (byte == FRAME_DELIMITER) {
+    finishFrame();
+    return _msg_avl;
+  }
+
+  _frame_started = true;
+
+  /* Previous frame not released -> drop frame, otherwise block of previous frame is overwritten */
+  if (_msg_avl || _frame_error) {
+    _frame_error = true;
+    return false;
+  }
+
+  if (_code_remaining == 0U) {
+    /* Code byte: a zero has to be inserted between two blocks, except after a block with max. size */
+    if ((_code != 0U) && (_code != COBS_CODE_MAX)) {
+      addDecodedByte(0U);
+    }
+
+    _code = byte;
+    _code_remaining = byte - 1U;
+  } else {
+    addDecodedByte(byte);
+    _code_remaining--;
+  }
+
+  return false;
+}
+
+[[nodiscard]] msg::Msg Decoder::getMsg() const { return msg::convertBytesToMsg(_msg_raw); }
+
+[[nodiscard]] const uint8_t *Decoder::getBlockPtr() const {
+  const bool block_stored = (_block_size > 0U) && (_block_size <= _block_buffer_size);
+  return (block_stored) ? _block_buffer_ptr : nullptr;
+}
+
+void Decoder::releaseMsg() {
+  _msg_avl = false;
+  _block_size = 0U;
+}
+
+// Private Functions --------------------------------------------------------------------------------------------------
+
+void Decoder::resetFrame() {
+  _frame_crc = 0U;
+  _frame_calc_crc = CRC_INIT_VALUE;
+  _frame_pos = 0U;
+  _frame_block_size = 0U;
+  _frame_error = false;
+  _frame_started = false;
+  _code = 0U;
+  _code_remaining = 0U;
+}
+
+void Decoder::addDecodedByte(const uint8_t byte) {
+  if (_frame_pos < FRAME_CRC_SIZE) {
+    _frame_crc |= static_cast<uint32_t>(byte) << (_frame_pos * NUM_BITS_PER_BYTE);
+  } else {
+    _frame_calc_crc = updateCRC(_frame_calc_crc, byte);
+
+    if (_frame_pos < FRAME_HEADER_SIZE) {
+      _msg_raw[_frame_pos - FRAME_CRC_SIZE] = byte;
+    } else {
+      /* Blocks not fitting into the buffer are only used for CRC calculation */
+      if (_frame_block_size < _block_buffer_size) {
+        _block_buffer_ptr[_frame_block_size] = byte;
+      }
+      _frame_block_size++;
+    }
+  }
+
+  _frame_pos++;
+}
+
+void Decoder::finishFrame() {
+  /* Ignore empty frames (e.g. delimiter send by host to synchronize) */
+  if (_frame_started) {
+    const bool frame_complete = (_code_remaining == 0U) && (_frame_pos >= FRAME_HEADER_SIZE);
+    const bool crc_valid = (finalizeCRC(_frame_calc_crc) == _frame_crc);
+
+    if (!_frame_error && frame_complete && crc_valid) {
+      _block_size = _frame_block_size;
+      _msg_avl = true;
+    } else {
+      _num_dropped_frames++;
+    }
+  }
+
+  resetFrame();
+}
+
+}; /* namespace franklyboot::cobs */
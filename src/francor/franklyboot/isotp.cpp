@@ -0,0 +1,141 @@
+/**
+ * @file isotp.cpp
+ * @author Martin Bauernschmitt (martin.bauernschmitt@francor.de)
+ * @brief Source file of the ISO-TP sender
+ * @version 0.1
+ * @date 2022-11-26
+ *
+ * @copyright Copyright (c) 2022 - BSD-3-clause - FRANCOR e.V.
+ *
+ */
+
+#include "francor/franklyboot/isotp.h"
+
+namespace franklyboot::isotp {
+
+bool Sender::startTransfer(const uint8_t *data_ptr, const uint32_t num_bytes) {
+  const bool transfer_possible = (_state == State::IDLE) && (data_ptr != nullptr) && (num_bytes > 0U);
+
+  if (transfer_possible) {
+    _data_ptr = data_ptr;
+    _msg_size = num_bytes;
+    _msg_pos = 0U;
+    _aborted = false;
+    _state = (num_bytes <= SINGLE_FRAME_MAX_SIZE) ? State::SINGLE_FRAME : State::FIRST_FRAME;
+  }
+
+  return transfer_possible;
+}
+
+[[nodiscard]] bool Sender::getNextFrame(Frame &frame) {
+  constexpr uint32_t NUM_BITS_PER_BYTE = 8U;
+  constexpr uint8_t PCI_NIBBLE_MASK = 0x0FU;
+
+  frame.fill(FRAME_PADDING);
+
+  switch (_state) {
+    case State::SINGLE_FRAME:
+      frame[0] = static_cast<uint8_t>(FRAME_SINGLE | _msg_size);
+      for (auto idx = 0U; idx < _msg_size; idx++) {
+        frame[1U + idx] = _data_ptr[idx];
+      }
+      _msg_pos = _msg_size;
+      _state = State::IDLE;
+      return true;
+
+    case State::FIRST_FRAME: {
+      uint32_t data_idx = 2U;
+      if (_msg_size <= FIRST_FRAME_MAX_SIZE) {
+        frame[0] = static_cast<uint8_t>(FRAME_FIRST | (_msg_size >> NUM_BITS_PER_BYTE));
+        frame[1] = static_cast<uint8_t>(_msg_size);
+      } else {
+        /* Escape sequence -> 32-bit message size */
+        frame[0] = FRAME_FIRST;
+        frame[1] = 0U;
+        for (auto idx = 0U; idx < sizeof(uint32_t); idx++) {
+          frame[2U + idx] = static_cast<uint8_t>(_msg_size >> ((3U - idx) * NUM_BITS_PER_BYTE));
+        }
+        data_idx = 6U;
+      }
+
+      for (auto idx = data_idx; idx < FRAME_SIZE; idx++) {
+        frame[idx] = _data_ptr[_msg_pos];
+        _msg_pos++;
+      }
+
+      _sequence_number = 1U;
+      _state = State::WAIT_FLOW_CONTROL;
+      return true;
+    }
+
+    case State::CONSECUTIVE_FRAME:
+      frame[0] = static_cast<uint8_t>(FRAME_CONSECUTIVE | _sequence_number);
+      for (auto idx = 1U; (idx < FRAME_SIZE) && (_msg_pos < _msg_size); idx++) {
+        frame[idx] = _data_ptr[_msg_pos];
+        _msg_pos++;
+      }
+      _sequence_number = (_sequence_number + 1U) & PCI_NIBBLE_MASK;
+
+      if (_msg_pos >= _msg_size) {
+        _state = State::IDLE;
+      } else if (_block_size > 0U) {
+        _block_frame_cnt++;
+        if (_block_frame_cnt >= _block_size) {
+          _state = State::WAIT_FLOW_CONTROL;
+        }
+      }
+      return true;
+
+    case State::IDLE:
+    case State::WAIT_FLOW_CONTROL:
+    default:
+      return false;
+  }
+}
+
+void Sender::processFlowControl(const Frame &frame) {
+  constexpr uint8_t PCI_NIBBLE_MASK = 0x0FU;
+
+  const bool is_flow_control = ((frame[0] & FRAME_TYPE_MASK) == FRAME_FLOW_CONTROL);
+  if (!is_flow_control || (_state != State::WAIT_FLOW_CONTROL)) {
+    return;
+  }
+
+  switch (static_cast<FlowStatus>(frame[0] & PCI_NIBBLE_MASK)) {
+    case FLOW_CONTINUE:
+      _block_size = frame[1];
+      _separation_time = frame[2];
+      _block_frame_cnt = 0U;
+      _state = State::CONSECUTIVE_FRAME;
+      break;
+
+    case FLOW_WAIT:
+      break;
+
+    case FLOW_OVERFLOW:
+    default:
+      _aborted = true;
+      _state = State::IDLE;
+      break;
+  }
+}
+
+[[nodiscard]] uint32_t Sender::getSeparationTimeUs() const {
+  constexpr uint32_t US_PER_MS = 1000U;
+  constexpr uint8_t STMIN_MAX_MS = 0x7FU;
+  constexpr uint8_t STMIN_US_FIRST = 0xF1U;
+  constexpr uint8_t STMIN_US_LAST = 0xF9U;
+  constexpr uint32_t STMIN_US_STEP = 100U;
+
+  uint32_t separation_time_us = STMIN_MAX_MS * US_PER_MS;
+
+  if (_separation_time <= STMIN_MAX_MS) {
+    separation_time_us = _separation_time * US_PER_MS;
+  } else if ((_separation_time >= STMIN_US_FIRST) && (_separation_time <= STMIN_US_LAST)) {
+    separation_time_us = (_separation_time - STMIN_US_FIRST + 1U) * STMIN_US_STEP;
+  }
+
+  return separation_time_us;
+}
+
+}; /* namespace franklyboot::isotp */
@@ -12,9 +12,11 @@
 // Includes -----------------------------------------------------------------------------------------------------------
 #include <francor/franklyboot/franklyboot.h>
 #include <francor/franklyboot/handler.h>
+#include <francor/franklyboot/lzss.h>
 #include <gtest/gtest.h>
 
 #include <limits>
+#include <vector>
 
 namespace franklyboot::test_utils {
 
@@ -26,6 +28,41 @@ constexpr uint32_t FLASH_PAGE_SIZE = 1024U;
 constexpr uint32_t FLASH_NUM_PAGES = 16;
 constexpr uint32_t FLASH_SIZE = FLASH_NUM_PAGES * FLASH_PAGE_SIZE;
 
+// Hardware Interface -------------------------------------------------------------------------------------------------
+
+class TestHelper;
+
+/**
+ * @brief Hardware interface policy of the test handlers, forwards the calls to the simulation of a TestHelper
+ */
+class TestHWI {
+ public:
+  explicit TestHWI(TestHelper& helper) : _helper(&helper) {}
+
+  void resetDevice() const;
+  [[nodiscard]] uint32_t getVendorID() const;
+  [[nodiscard]] uint32_t getProductID() const;
+  [[nodiscard]] uint32_t getProductionDate() const;
+  [[nodiscard]] uint32_t getUniqueIDWord(uint32_t idx) const;
+  [[nodiscard]] uint32_t calculateCRC(uint32_t src_address, uint32_t num_bytes) const;
+  bool eraseFlashPage(uint32_t page_id) const;
+  [[nodiscard]] uint32_t eraseFlashPages(uint32_t first_page_id, uint32_t max_num_pages) const;
+  bool writeDataBufferToFlash(uint32_t dst_address, uint32_t dst_page_id, uint8_t* src_data_ptr,
+                              uint32_t num_bytes) const;
+  [[nodiscard]] uint8_t readByteFromFlash(uint32_t flash_src_address) const;
+  void startApp(uint32_t app_flash_address) const;
+
+ private:
+  TestHelper* _helper;
+};
+
+/** \brief Handler with the flash layout of the tests using the simulation of a TestHelper */
+template <uint32_t STREAM_WINDOW_SIZE = 16U, size_t MSG_DATA_SIZE = msg::MSG_DATA_SIZE_CAN, size_t QUEUE_SIZE = 0U,
+          uint32_t DECOMPRESSION_WINDOW_BITS = 0U, uint32_t NUM_PAGE_BUFFERS = 1U, typename... REQUEST_EXTENSIONS>
+using TestHandler =
+    Handler<FLASH_START, FLASH_APP_FIRST_PAGE, FLASH_SIZE, FLASH_PAGE_SIZE, STREAM_WINDOW_SIZE, MSG_DATA_SIZE,
+            QUEUE_SIZE, DECOMPRESSION_WINDOW_BITS, NUM_PAGE_BUFFERS, TestHWI, REQUEST_EXTENSIONS...>;
+
 // Test Fixture Class -------------------------------------------------------------------------------------------------
 
 class TestHelper : public ::testing::Test {
@@ -39,6 +76,9 @@ class TestHelper : public ::testing::Test {
 
   [[nodiscard]] auto& getHandle() { return _handle; }
 
+  /** \brief Hardware interface of the simulation, passed to handlers created by the tests */
+  [[nodiscard]] TestHWI getHWI() { return TestHWI(*this); }
+
   /** \brief Set functions */
   void setVendorID(uint32_t value);
   void setProductID(uint32_t value);
@@ -50,7 +90,9 @@ class TestHelper : public ::testing::Test {
   [[nodiscard]] auto readByteFromFlash(uint32_t address) const;
 
   void setWriteToFlashResult(bool result);
+  void setWriteToFlashCorrupt(bool corrupt);
   void setErasePageResult(bool result);
+  void setEraseSectorNumPages(uint32_t num_pages);
 
   /* Help functions */
   void clearPageBuffer();
@@ -62,8 +104,9 @@ class TestHelper : public ::testing::Test {
   [[nodiscard]] uint32_t getCalcCRCNumBytes() const;
   [[nodiscard]] bool writeToFlashCalled() const;
   [[nodiscard]] bool erasePageCalled() const;
+  [[nodiscard]] uint32_t getEraseNumCalls() const;
 
-  /* Hardware interface simulation -> called by hwi:: functions */
+  /* Hardware interface simulation -> called by TestHWI */
   void resetDevice();
   [[nodiscard]] uint32_t getVendorID() const;
   [[nodiscard]] uint32_t getProductID() const;
@@ -71,6 +114,7 @@ class TestHelper : public ::testing::Test {
   [[nodiscard]] uint32_t getUniqueIDWord(uint32_t idx) const;
   [[nodiscard]] uint32_t calculateCRC(const uint32_t src_address, uint32_t num_bytes);  // NOLINT
   bool eraseFlashPage(uint32_t page_id);
+  [[nodiscard]] uint32_t eraseFlashPages(uint32_t first_page_id, uint32_t max_num_pages);
   bool writeDataBufferToFlash(uint32_t dst_address, uint32_t dst_page_id, uint8_t* src_data_ptr, uint32_t num_bytes);
   [[nodiscard]] uint8_t readByteFromFlash(uint32_t flash_src_address);
   void startApp(uint32_t app_flash_address);
@@ -78,7 +122,7 @@ class TestHelper : public ::testing::Test {
  private:
   void initFlashSim();
 
-  Handler<FLASH_START, FLASH_APP_FIRST_PAGE, FLASH_SIZE, FLASH_PAGE_SIZE> _handle;
+  TestHandler<> _handle{TestHWI(*this)};
 
   bool _resetDeviceCalled = {false};
   uint32_t _vendor_id = {0U};
@@ -93,12 +137,69 @@ class TestHelper : public ::testing::Test {
   bool _startAppCalled = {false};
 
   bool _write_to_flash_result = {false};
+  bool _write_to_flash_corrupt = {false};
   bool _write_to_flash_called = {false};
 
   bool _erase_page_called = {false};
   bool _erase_page_result = {false};
+  uint32_t _erase_sector_num_pages = {1U};
+  uint32_t _erase_num_calls = {0U};
 
   std::map<uint32_t, uint8_t> _flash_simulation;
 };
 
+// Host Tools ---------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Compresses data to the stream format of lzss::Decoder (greedy longest match search)
+ *
+ * @param src Uncompressed data
+ * @param window_bits Number of bits of the distance of a back-reference
+ * @param length_bits Number of bits of the length of a back-reference
+ * @return Compressed stream, unused bits of the last byte are 0
+ */
+[[nodiscard]] std::vector<uint8_t> compressLzss(const std::vector<uint8_t>& src, uint32_t window_bits,
+                                                uint32_t length_bits = lzss::LENGTH_BITS_DEFAULT);
+
+/** \brief Type of a page patch operation */
+enum class PagePatchOpType : uint8_t {
+  LITERAL,  //!< Literal words (REQ_PAGE_BUFFER_STREAM_WORD)
+  COPY,     //!< Words copied from flash (REQ_PAGE_BUFFER_COPY_FROM_FLASH)
+  FILL,     //!< Words filled with a pattern (REQ_PAGE_BUFFER_FILL)
+};
+
+/**
+ * @brief Operation of a page patch, writes the next words of the page buffer
+ */
+struct PagePatchOp {
+  PagePatchOpType type = {PagePatchOpType::LITERAL};  //!< Type of the operation
+  uint32_t num_words = {0U};                          //!< Number of words of the page buffer written
+  uint32_t src_offset = {0U};                         //!< Copy: byte offset of the source relative to the flash start
+  uint32_t pattern = {0U};                            //!< Fill: 32-bit pattern (aligned to the page)
+  std::vector<uint8_t> literal;                       //!< Literal: data of the words
+};
+
+/**
+ * @brief Creates the delta patch of a page against the current flash contents (greedy longest match search)
+ *
+ * Copies are read by the device before the page is written, so the page itself is a valid source. Pages written
+ * before have to be passed with their new contents (host tracks the flash while generating the patch page by page).
+ * Runs of a repeated 32-bit pattern (padding, zeroed tables) are filled if at least as long as the best copy.
+ *
+ * @param flash Current flash contents (complete flash, offset 0 = flash start)
+ * @param page New contents of the page
+ * @param word_size Size of a page buffer word (message payload)
+ * @param min_op_words Minimum number of words of a copy / fill (costs a request and a response)
+ * @return Operations in page order
+ */
+[[nodiscard]] std::vector<PagePatchOp> createDeltaPatch(const std::vector<uint8_t>& flash,
+                                                        const std::vector<uint8_t>& page, uint32_t word_size,
+                                                        uint32_t min_op_words = 3U);
+
+/**
+ * @brief Creates the upload of a page without flash contents (literal words and fills of repeated patterns)
+ */
+[[nodiscard]] std::vector<PagePatchOp> createFillPatch(const std::vector<uint8_t>& page, uint32_t word_size,
+                                                       uint32_t min_op_words = 3U);
+
 };  // namespace franklyboot::test_utils
\ No newline at end of file
@@ -11,24 +11,17 @@
 
 #include <francor/frankly_test_utils.h>
 
+#include <algorithm>
 #include <limits>
+#include <unordered_map>
 
 namespace franklyboot::test_utils {
 
-// Global Variable for HWI --------------------------------------------------------------------------------------------
-static TestHelper* testInstance = {nullptr};  // NOLINT
-
 // GTest SetUp / Teardown ---------------------------------------------------------------------------------------------
 
-void TestHelper::SetUp() {
-  testInstance = this;
-  initFlashSim();
-}
+void TestHelper::SetUp() { initFlashSim(); }
 
-void TestHelper::TearDown() {
-  _flash_simulation.clear();
-  testInstance = nullptr;
-}
+void TestHelper::TearDown() { _flash_simulation.clear(); }
 
 // Set Functions ------------------------------------------------------------------------------------------------------
 
@@ -55,7 +48,9 @@ void TestHelper::setByteInFlash(uint32_t address, uint8_t value) {
 }
 
 void TestHelper::setWriteToFlashResult(bool result) { _write_to_flash_result = result; }
+void TestHelper::setWriteToFlashCorrupt(bool corrupt) { _write_to_flash_corrupt = corrupt; }
 void TestHelper::setErasePageResult(bool result) { _erase_page_result = result; }
+void TestHelper::setEraseSectorNumPages(uint32_t num_pages) { _erase_sector_num_pages = num_pages; }
 
 // Help Functions -----------------------------------------------------------------------------------------------------
 
@@ -73,6 +68,7 @@ void TestHelper::clearPageBuffer() {
 [[nodiscard]] uint32_t TestHelper::getCalcCRCNumBytes() const { return _crc_calc_num_bytes; }
 [[nodiscard]] bool TestHelper::writeToFlashCalled() const { return _write_to_flash_called; }
 [[nodiscard]] bool TestHelper::erasePageCalled() const { return _erase_page_called; }
+[[nodiscard]] uint32_t TestHelper::getEraseNumCalls() const { return _erase_num_calls; }
 
 // HWI abstraction ----------------------------------------------------------------------------------------------------
 
@@ -98,6 +94,20 @@ void TestHelper::resetDevice() { _resetDeviceCalled = true; }
   return _erase_page_result;
 }
 
+[[nodiscard]] uint32_t TestHelper::eraseFlashPages(const uint32_t first_page_id, const uint32_t max_num_pages) {
+  /* Simulates sectors of _erase_sector_num_pages pages, erased completely if the range covers them */
+  const bool sector_start = ((first_page_id % _erase_sector_num_pages) == 0U);
+  const bool sector_erase = sector_start && (_erase_sector_num_pages <= max_num_pages);
+  const uint32_t num_pages = sector_erase ? _erase_sector_num_pages : 1U;
+
+  for (auto idx = 0U; idx < num_pages; idx++) {
+    (void)eraseFlashPage(first_page_id + idx);
+  }
+
+  _erase_num_calls++;
+  return _erase_page_result ? num_pages : 0U;
+}
+
 bool TestHelper::writeDataBufferToFlash(const uint32_t dst_address, const uint32_t dst_page_id, uint8_t* src_data_ptr,
                                         const uint32_t num_bytes) {
   (void)dst_page_id;
@@ -106,6 +116,11 @@ bool TestHelper::writeDataBufferToFlash(const uint32_t dst_address, const uint32
     setByteInFlash(dst_address + idx, src_data_ptr[idx]);
   }
 
+  /* Simulates a programming error not reported by the flash controller */
+  if (_write_to_flash_corrupt && (num_bytes > 0U)) {
+    setByteInFlash(dst_address, static_cast<uint8_t>(~src_data_ptr[0U]));
+  }
+
   _write_to_flash_called = true;
 
   return _write_to_flash_result;
@@ -124,106 +139,198 @@ void TestHelper::startApp(uint32_t app_flash_address) {
   _startAppCalled = true;
 }
 
-// Private functions --------------------------------------------------------------------------------------------------
+// Test HWI -----------------------------------------------------------------------------------------------------------
 
-void TestHelper::initFlashSim() {
-  uint32_t flash_address = _handle.getFlashStartAddress();
-  const uint32_t flash_size = _handle.getFlashSize();
-  for (uint32_t idx = 0U; idx < flash_size; idx++) {
-    _flash_simulation.insert({flash_address, std::numeric_limits<uint32_t>::max()});
-    flash_address++;
-  }
+void TestHWI::resetDevice() const { _helper->resetDevice(); }
+[[nodiscard]] uint32_t TestHWI::getVendorID() const { return _helper->getVendorID(); }
+[[nodiscard]] uint32_t TestHWI::getProductID() const { return _helper->getProductID(); }
+[[nodiscard]] uint32_t TestHWI::getProductionDate() const { return _helper->getProductionDate(); }
+[[nodiscard]] uint32_t TestHWI::getUniqueIDWord(const uint32_t idx) const { return _helper->getUniqueIDWord(idx); }
+[[nodiscard]] uint32_t TestHWI::calculateCRC(const uint32_t src_address, const uint32_t num_bytes) const {
+  return _helper->calculateCRC(src_address, num_bytes);
 }
 
-};  // namespace franklyboot::test_utils
-
-// HWI calls ----------------------------------------------------------------------------------------------------------
-
-namespace franklyboot {
+bool TestHWI::eraseFlashPage(const uint32_t page_id) const { return _helper->eraseFlashPage(page_id); }
 
-void hwi::resetDevice() {
-  if (test_utils::testInstance != nullptr) {
-    test_utils::testInstance->resetDevice();
-  }
+[[nodiscard]] uint32_t TestHWI::eraseFlashPages(const uint32_t first_page_id, const uint32_t max_num_pages) const {
+  return _helper->eraseFlashPages(first_page_id, max_num_pages);
 }
 
-[[nodiscard]] uint32_t hwi::getVendorID() {
-  uint32_t value = 0U;
-  if (test_utils::testInstance != nullptr) {
-    value = test_utils::testInstance->getVendorID();
-  }
-
-  return value;
+bool TestHWI::writeDataBufferToFlash(const uint32_t dst_address, const uint32_t dst_page_id, uint8_t* src_data_ptr,
+                                     const uint32_t num_bytes) const {
+  return _helper->writeDataBufferToFlash(dst_address, dst_page_id, src_data_ptr, num_bytes);
 }
 
-[[nodiscard]] uint32_t hwi::getProductID() {
-  uint32_t value = 0U;
-  if (test_utils::testInstance != nullptr) {
-    value = test_utils::testInstance->getProductID();
-  }
-
-  return value;
+[[nodiscard]] uint8_t TestHWI::readByteFromFlash(const uint32_t flash_src_address) const {
+  return _helper->readByteFromFlash(flash_src_address);
 }
 
-[[nodiscard]] uint32_t hwi::getProductionDate() {
-  uint32_t value = 0U;
-  if (test_utils::testInstance != nullptr) {
-    value = test_utils::testInstance->getProductionDate();
-  }
-
-  return value;
-}
-
-[[nodiscard]] uint32_t hwi::getUniqueIDWord(uint32_t idx) {
-  uint32_t value = 0U;
-  if (test_utils::testInstance != nullptr) {
-    value = test_utils::testInstance->getUniqueIDWord(idx);
-  }
+void TestHWI::startApp(const uint32_t app_flash_address) const { _helper->startApp(app_flash_address); }
 
-  return value;
-}
+// Private functions --------------------------------------------------------------------------------------------------
 
-[[nodiscard]] uint32_t hwi::calculateCRC(const uint32_t src_address, const uint32_t num_bytes) {
-  uint32_t value = 0U;
-  if (test_utils::testInstance != nullptr) {
-    value = test_utils::testInstance->calculateCRC(src_address, num_bytes);
+void TestHelper::initFlashSim() {
+  uint32_t flash_address = _handle.getFlashStartAddress();
+  const uint32_t flash_size = _handle.getFlashSize();
+  for (uint32_t idx = 0U; idx < flash_size; idx++) {
+    _flash_simulation.insert({flash_address, std::numeric_limits<uint32_t>::max()});
+    flash_address++;
   }
-
-  return value;
 }
 
-[[nodiscard]] bool hwi::eraseFlashPage(const uint32_t page_id) {
-  bool value = false;
-  if (test_utils::testInstance != nullptr) {
-    value = test_utils::testInstance->eraseFlashPage(page_id);
+// Host Tools ---------------------------------------------------------------------------------------------------------
+
+[[nodiscard]] std::vector<uint8_t> compressLzss(const std::vector<uint8_t>& src, const uint32_t window_bits,
+                                                const uint32_t length_bits) {
+  constexpr uint32_t BITS_PER_BYTE = 8U;
+
+  std::vector<uint8_t> dst;
+  uint32_t num_bits = 0U;
+  auto write_bits = [&](const uint32_t value, const uint32_t count) {
+    for (auto bit_idx = count; bit_idx-- > 0U;) {
+      if ((num_bits % BITS_PER_BYTE) == 0U) {
+        dst.push_back(0U);
+      }
+      const uint32_t dst_bit_idx = BITS_PER_BYTE - 1U - (num_bits % BITS_PER_BYTE);
+      dst.back() |= static_cast<uint8_t>(((value >> bit_idx) & 1U) << dst_bit_idx);
+      num_bits++;
+    }
+  };
+
+  /* Back-reference is only used if it is shorter than the literals it replaces */
+  const uint32_t max_distance = (1U << window_bits);
+  const uint32_t max_length = (1U << length_bits);
+  const uint32_t backref_bits = 1U + window_bits + length_bits;
+
+  uint32_t pos = 0U;
+  while (pos < src.size()) {
+    uint32_t best_length = 0U;
+    uint32_t best_distance = 0U;
+
+    for (uint32_t distance = 1U; (distance <= max_distance) && (distance <= pos); distance++) {
+      uint32_t length = 0U;
+      while ((length < max_length) && ((pos + length) < src.size()) &&
+             (src[pos + length] == src[pos + length - distance])) {
+        length++;
+      }
+
+      if (length > best_length) {
+        best_length = length;
+        best_distance = distance;
+      }
+    }
+
+    if ((best_length * (1U + lzss::LITERAL_BITS)) > backref_bits) {
+      write_bits(0U, 1U);
+      write_bits(best_distance - 1U, window_bits);
+      write_bits(best_length - 1U, length_bits);
+      pos += best_length;
+    } else {
+      write_bits(1U, 1U);
+      write_bits(src[pos], lzss::LITERAL_BITS);
+      pos++;
+    }
   }
 
-  return value;
+  return dst;
 }
 
-bool hwi::writeDataBufferToFlash(const uint32_t dst_address, const uint32_t dst_page_id, uint8_t* src_data_ptr,
-                                 const uint32_t num_bytes) {
-  bool value = false;
-  if (test_utils::testInstance != nullptr) {
-    value = test_utils::testInstance->writeDataBufferToFlash(dst_address, dst_page_id, src_data_ptr, num_bytes);
+[[nodiscard]] std::vector<PagePatchOp> createDeltaPatch(const std::vector<uint8_t>& flash,
+                                                        const std::vector<uint8_t>& page, const uint32_t word_size,
+                                                        const uint32_t min_op_words) {
+  constexpr uint32_t KEY_SIZE = 4U;
+  constexpr uint32_t PATTERN_SIZE = 4U;
+  constexpr uint32_t BITS_PER_BYTE = 8U;
+
+  /* Index of the flash by the first bytes of a match */
+  auto get_key = [](const std::vector<uint8_t>& data, const uint32_t pos) {
+    uint32_t key = 0U;
+    for (auto idx = 0U; idx < KEY_SIZE; idx++) {
+      key |= static_cast<uint32_t>(data[pos + idx]) << (idx * BITS_PER_BYTE);
+    }
+    return key;
+  };
+
+  std::unordered_map<uint32_t, std::vector<uint32_t>> flash_index;
+  for (uint32_t src_offset = 0U; (src_offset + KEY_SIZE) <= flash.size(); src_offset++) {
+    flash_index[get_key(flash, src_offset)].push_back(src_offset);
   }
 
-  return value;
-}
-
-[[nodiscard]] uint8_t hwi::readByteFromFlash(uint32_t flash_src_address) {
-  uint8_t value = 0U;
-  if (test_utils::testInstance != nullptr) {
-    value = test_utils::testInstance->readByteFromFlash(flash_src_address);
+  std::vector<PagePatchOp> ops;
+  const auto page_size = static_cast<uint32_t>(page.size());
+  const uint32_t num_words = (page_size + word_size - 1U) / word_size;
+
+  /* Only complete words are written, except for a shorter last word of the page */
+  auto get_num_words = [&](const uint32_t word_idx, const uint32_t length) {
+    return ((word_idx * word_size + length) == page_size) ? (num_words - word_idx) : (length / word_size);
+  };
+
+  uint32_t word_idx = 0U;
+  while (word_idx < num_words) {
+    const uint32_t pos = word_idx * word_size;
+    PagePatchOp op;
+
+    const auto search = ((pos + KEY_SIZE) <= page_size) ? flash_index.find(get_key(page, pos)) : flash_index.end();
+    if (search != flash_index.end()) {
+      for (const auto src_offset : search->second) {
+        uint32_t length = 0U;
+        while (((pos + length) < page_size) && ((src_offset + length) < flash.size()) &&
+               (page[pos + length] == flash[src_offset + length])) {
+          length++;
+        }
+
+        if (get_num_words(word_idx, length) > op.num_words) {
+          op.type = PagePatchOpType::COPY;
+          op.num_words = get_num_words(word_idx, length);
+          op.src_offset = src_offset;
+        }
+      }
+    }
+
+    if ((pos + PATTERN_SIZE) <= page_size) {
+      /* Byte n of the page is byte n % 4 of the pattern */
+      uint32_t pattern = 0U;
+      for (auto idx = pos; idx < (pos + PATTERN_SIZE); idx++) {
+        pattern |= static_cast<uint32_t>(page[idx]) << ((idx % PATTERN_SIZE) * BITS_PER_BYTE);
+      }
+
+      auto get_pattern_byte = [&](const uint32_t idx) {
+        return static_cast<uint8_t>(pattern >> ((idx % PATTERN_SIZE) * BITS_PER_BYTE));
+      };
+
+      uint32_t length = 0U;
+      while (((pos + length) < page_size) && (page[pos + length] == get_pattern_byte(pos + length))) {
+        length++;
+      }
+
+      if (get_num_words(word_idx, length) >= op.num_words) {
+        op.type = PagePatchOpType::FILL;
+        op.num_words = get_num_words(word_idx, length);
+        op.pattern = pattern;
+      }
+    }
+
+    if (op.num_words >= min_op_words) {
+      ops.push_back(op);
+      word_idx += op.num_words;
+    } else {
+      if (ops.empty() || (ops.back().type != PagePatchOpType::LITERAL)) {
+        ops.emplace_back();
+      }
+
+      const uint32_t end_pos = std::min(pos + word_size, page_size);
+      ops.back().literal.insert(ops.back().literal.end(), page.begin() + pos, page.begin() + end_pos);
+      ops.back().num_words++;
+      word_idx++;
+    }
   }
 
-  return value;
+  return ops;
 }
 
-void hwi::startApp(uint32_t app_flash_address) {
-  if (test_utils::testInstance != nullptr) {
-    test_utils::testInstance->startApp(app_flash_address);
-  }
+[[nodiscard]] std::vector<PagePatchOp> createFillPatch(const std::vector<uint8_t>& page, const uint32_t word_size,
+                                                       const uint32_t min_op_words) {
+  return createDeltaPatch({}, page, word_size, min_op_words);
 }
 
-}  // namespace franklyboot
\ No newline at end of file
+};  // namespace franklyboot::test_utils
@@ -0,0 +1,384 @@
+/**
+ * @file tests.cpp
+ * @author Martin Bauernschmitt (martin.bauernschmitt@francor.de)
+ * @brief Unit Tests of FRANCORs Frankly Bootloader - Asynchronous Flash Operations
+ * @version 0.1
+ * @date 2022-11-26
+ *
+ * @copyright Copyright (c) 2022 - BSD-3-clause - FRANCOR e.V.
+ *
+ */
+
+#include <francor/frankly_test_utils.h>
+
+#include <array>
+#include <limits>
+
+using namespace franklyboot;              // NOLINT
+using namespace franklyboot::test_utils;  // NOLINT
+
+// Asynchronous Hardware Interface ------------------------------------------------------------------------------------
+
+/**
+ * @brief Simulation of a flash controller, an operation is executed after a number of busy polls
+ */
+struct AsyncFlashSim {
+  uint32_t num_busy_polls = {3U};  //!< Polls answered with FlashStatus::BUSY per operation
+  uint32_t num_started = {0U};     //!< Number of operations started
+
+  bool running = {false};
+  bool erase = {false};
+  uint32_t busy_polls_left = {0U};
+  uint32_t page_id = {0U};
+  uint32_t dst_address = {0U};
+  uint8_t* src_data_ptr = {nullptr};
+  uint32_t num_bytes = {0U};
+};
+
+/**
+ * @brief Hardware interface with asynchronous flash operations, erases / writes the test flash when finished
+ */
+class AsyncHWI : public TestHWI {
+ public:
+  AsyncHWI(TestHelper& helper, AsyncFlashSim& sim) : TestHWI(helper), _sim(&sim) {}
+
+  [[nodiscard]] bool startEraseFlashPage(const uint32_t page_id) const {
+    return start(true, page_id, 0U, nullptr, 0U);
+  }
+
+  [[nodiscard]] bool startWriteDataBufferToFlash(const uint32_t dst_address, const uint32_t dst_page_id,
+                                                 uint8_t* src_data_ptr, const uint32_t num_bytes) const {
+    return start(false, dst_page_id, dst_address, src_data_ptr, num_bytes);
+  }
+
+  [[nodiscard]] hwi::FlashStatus pollFlash() const {
+    if (!_sim->running) {
+      return hwi::FlashStatus::ERROR;
+    }
+
+    if (_sim->busy_polls_left > 0U) {
+      _sim->busy_polls_left--;
+      return hwi::FlashStatus::BUSY;
+    }
+
+    /* Source data is read when the operation finishes, changes of the page buffer meanwhile are detected */
+    _sim->running = false;
+    const bool result = _sim->erase ? eraseFlashPage(_sim->page_id)
+                                    : writeDataBufferToFlash(_sim->dst_address, _sim->page_id, _sim->src_data_ptr,
+                                                             _sim->num_bytes);
+    return result ? hwi::FlashStatus::DONE : hwi::FlashStatus::ERROR;
+  }
+
+ private:
+  [[nodiscard]] bool start(const bool erase, const uint32_t page_id, const uint32_t dst_address,
+                           uint8_t* src_data_ptr, const uint32_t num_bytes) const {
+    if (_sim->running) {
+      return false;
+    }
+
+    _sim->running = true;
+    _sim->erase = erase;
+    _sim->busy_polls_left = _sim->num_busy_polls;
+    _sim->page_id = page_id;
+    _sim->dst_address = dst_address;
+    _sim->src_data_ptr = src_data_ptr;
+    _sim->num_bytes = num_bytes;
+    _sim->num_started++;
+    return true;
+  }
+
+  AsyncFlashSim* _sim;
+};
+
+/**
+ * @brief Asynchronous hardware interface reporting the blank state of a page (simulated by reading the page)
+ */
+class AsyncBlankCheckHWI : public AsyncHWI {
+ public:
+  using AsyncHWI::AsyncHWI;
+
+  [[nodiscard]] bool isFlashPageBlank(const uint32_t page_id) const {
+    bool page_blank = true;
+    for (auto idx = 0U; idx < FLASH_PAGE_SIZE; idx++) {
+      page_blank = page_blank && (readByteFromFlash(FLASH_START + page_id * FLASH_PAGE_SIZE + idx) ==
+                                  std::numeric_limits<uint8_t>::max());
+    }
+
+    return page_blank;
+  }
+};
+
+// Defines / Constexpr ------------------------------------------------------------------------------------------------
+
+/** \brief Handler with one page buffer and asynchronous flash operations */
+using AsyncHandler = Handler<FLASH_START, FLASH_APP_FIRST_PAGE, FLASH_SIZE, FLASH_PAGE_SIZE, 16U,
+                             msg::MSG_DATA_SIZE_CAN, 0U, 0U, 1U, AsyncHWI>;
+
+/** \brief Handler with two page buffers and asynchronous flash operations */
+using AsyncDoubleBufferHandler = Handler<FLASH_START, FLASH_APP_FIRST_PAGE, FLASH_SIZE, FLASH_PAGE_SIZE, 16U,
+                                         msg::MSG_DATA_SIZE_CAN, 0U, 0U, 2U, AsyncHWI>;
+
+/** \brief Handler with one page buffer, asynchronous flash operations and blank check */
+using AsyncBlankCheckHandler = Handler<FLASH_START, FLASH_APP_FIRST_PAGE, FLASH_SIZE, FLASH_PAGE_SIZE, 16U,
+                                       msg::MSG_DATA_SIZE_CAN, 0U, 0U, 1U, AsyncBlankCheckHWI>;
+
+static_assert(hwi::IsAsyncFlash<AsyncHWI>::value, "AsyncHWI has to be detected as asynchronous!");
+static_assert(!hwi::IsAsyncFlash<TestHWI>::value, "TestHWI has to be detected as synchronous!");
+static_assert(!hwi::IsAsyncFlash<hwi::FreeFunctions>::value, "Free functions have to be detected as synchronous!");
+
+// Test Fixture Class -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Test class for asynchronous flash operations
+ */
+class AsyncFlashTests : public TestHelper {
+ public:
+  AsyncFlashTests() = default;
+
+  [[nodiscard]] AsyncHWI getAsyncHWI() { return AsyncHWI(*this, _sim); }
+  [[nodiscard]] AsyncBlankCheckHWI getAsyncBlankCheckHWI() { return AsyncBlankCheckHWI(*this, _sim); }
+  [[nodiscard]] AsyncFlashSim& getSim() { return _sim; }
+
+  /**
+   * @brief Fills the complete receiving page buffer with a pattern (REQ_PAGE_BUFFER_FILL)
+   */
+  template <typename HANDLER>
+  static msg::ResultType fillPage(HANDLER& handler, const uint32_t pattern) {
+    constexpr uint32_t NUM_WORDS = FLASH_PAGE_SIZE / msg::MSG_DATA_SIZE_CAN;
+
+    auto request = msg::Msg(msg::REQ_PAGE_BUFFER_FILL, static_cast<msg::ResultType>(NUM_WORDS >> 8U),
+                            static_cast<uint8_t>(NUM_WORDS));
+    msg::convertU32ToMsgData(pattern, request.data);
+    handler.processRequest(request);
+    return handler.getResponse().result;
+  }
+
+  /**
+   * @brief Creates a write request of the page buffer
+   */
+  [[nodiscard]] static msg::Msg createWriteRequest(const uint32_t page_id, const uint8_t flags) {
+    auto request = msg::Msg(msg::REQ_PAGE_BUFFER_WRITE_TO_FLASH, static_cast<msg::ResultType>(flags), 0U);
+    msg::convertU32ToMsgData(page_id, request.data);
+    return request;
+  }
+
+  template <typename HANDLER>
+  [[nodiscard]] static msg::Msg readCommitStatus(HANDLER& handler, const uint32_t buffer_idx) {
+    auto request = msg::Msg(msg::REQ_PAGE_BUFFER_COMMIT_STATUS, msg::RES_NONE, 0U);
+    msg::convertU32ToMsgData(buffer_idx, request.data);
+    handler.processRequest(request);
+    return handler.getResponse();
+  }
+
+  /**
+   * @brief Calls processBufferedCmds() until the write of the page buffer finished
+   *
+   * @return Number of calls
+   */
+  template <typename HANDLER>
+  [[nodiscard]] static uint32_t processCommit(HANDLER& handler, const uint32_t buffer_idx) {
+    constexpr uint32_t MAX_NUM_CALLS = 100U;
+
+    uint32_t num_calls = 0U;
+    while ((readCommitStatus(handler, buffer_idx).result == msg::RES_BUSY) && (num_calls < MAX_NUM_CALLS)) {
+      handler.processBufferedCmds();
+      num_calls++;
+    }
+
+    return num_calls;
+  }
+
+  /**
+   * @brief Simulates a page programmed by a previous update, it has to be erased before it is written
+   */
+  void programPage(const uint32_t page_id) { setByteInFlash(FLASH_START + page_id * FLASH_PAGE_SIZE, 0x00U); }
+
+  [[nodiscard]] bool isPageEqual(const uint32_t page_id, const uint32_t pattern) {
+    const uint32_t address = FLASH_START + page_id * FLASH_PAGE_SIZE;
+    for (auto idx = 0U; idx < FLASH_PAGE_SIZE; idx++) {
+      if (readByteFromFlash(address + idx) != static_cast<uint8_t>(pattern >> ((idx % 4U) * 8U))) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+ private:
+  AsyncFlashSim _sim;
+};
+
+// Tests --------------------------------------------------------------------------------------------------------------
+
+TEST_F(AsyncFlashTests, Capabilities) {  // NOLINT
+  const auto capabilities = AsyncHandler::getCapabilities();
+  EXPECT_EQ(capabilities.at(msg::CAP_NUM_PAGE_BUFFERS), 1U);
+  EXPECT_NE(capabilities.at(msg::CAP_FEATURES) & msg::FEATURE_WRITE_DEFER, 0U);
+}
+
+TEST_F(AsyncFlashTests, DeferredWriteSingleBuffer) {  // NOLINT
+  constexpr uint32_t PATTERN = 0xA1A2A3A4U;
+  constexpr uint32_t CRC_VALUE = 0xDEADBEEFU;
+  constexpr uint8_t FLAGS = msg::WRITE_TO_FLASH_DEFER | msg::WRITE_TO_FLASH_VERIFY;
+
+  AsyncHandler handler(getAsyncHWI());
+  programPage(FLASH_APP_FIRST_PAGE);
+  setErasePageResult(true);
+  setWriteToFlashResult(true);
+  setCRCResult(CRC_VALUE);
+
+  /* Response is sent before the flash is touched */
+  EXPECT_EQ(fillPage(handler, PATTERN), msg::RES_OK);
+  handler.processRequest(createWriteRequest(FLASH_APP_FIRST_PAGE, FLAGS));
+  EXPECT_EQ(handler.getResponse().result, msg::RES_OK);
+  EXPECT_EQ(handler.getResponse().packet_id, 0U);
+  EXPECT_EQ(getSim().num_started, 0U);
+
+  /* Requests are served while the flash controller works, the locked page buffer is not modified */
+  handler.processBufferedCmds();
+  EXPECT_TRUE(getSim().running);
+
+  handler.processRequest(msg::Msg(msg::REQ_PING, msg::RES_NONE, 0U));
+  EXPECT_EQ(handler.getResponse().result, msg::RES_OK);
+  EXPECT_EQ(fillPage(handler, 0x12345678U), msg::RES_BUSY);
+  handler.processRequest(msg::Msg(msg::REQ_PAGE_BUFFER_CLEAR, msg::RES_NONE, 0U));
+  EXPECT_EQ(handler.getResponse().result, msg::RES_BUSY);
+  handler.processRequest(createWriteRequest(FLASH_APP_FIRST_PAGE + 1U, FLAGS));
+  EXPECT_EQ(handler.getResponse().result, msg::RES_BUSY);
+
+  /* Erase and write take several cycles each */
+  EXPECT_GT(processCommit(handler, 0U), 2U * getSim().num_busy_polls);
+  EXPECT_EQ(getSim().num_started, 2U);
+  EXPECT_TRUE(isPageEqual(FLASH_APP_FIRST_PAGE, PATTERN));
+
+  const auto status = readCommitStatus(handler, 0U);
+  EXPECT_EQ(status.result, msg::RES_OK);
+  EXPECT_EQ(msg::convertMsgDataToU32(status.data), CRC_VALUE);
+
+  /* Page buffer is released for the next page */
+  EXPECT_EQ(handler.getByteFromPageBuffer(0U), std::numeric_limits<uint8_t>::max());
+  EXPECT_EQ(fillPage(handler, 0x12345678U), msg::RES_OK);
+}
+
+TEST_F(AsyncFlashTests, DeferredWriteError) {  // NOLINT
+  AsyncHandler handler(getAsyncHWI());
+  programPage(FLASH_APP_FIRST_PAGE);
+  setErasePageResult(false);
+
+  EXPECT_EQ(fillPage(handler, 0x12345678U), msg::RES_OK);
+  handler.processRequest(createWriteRequest(FLASH_APP_FIRST_PAGE, msg::WRITE_TO_FLASH_DEFER));
+  EXPECT_EQ(handler.getResponse().result, msg::RES_OK);
+
+  (void)processCommit(handler, 0U);
+  EXPECT_EQ(getSim().num_started, 1U);
+  EXPECT_FALSE(writeToFlashCalled());
+
+  const auto status = readCommitStatus(handler, 0U);
+  EXPECT_EQ(status.result, msg::RES_ERR);
+  EXPECT_EQ(msg::convertMsgDataToU32(status.data), FLASH_APP_FIRST_PAGE);
+}
+
+TEST_F(AsyncFlashTests, DirectWrite) {  // NOLINT
+  constexpr uint32_t PATTERN = 0x9ABCDEF0U;
+
+  AsyncHandler handler(getAsyncHWI());
+  programPage(FLASH_APP_FIRST_PAGE);
+  setErasePageResult(true);
+  setWriteToFlashResult(true);
+
+  /* Without defer flag the request waits for the flash controller, the response carries the result */
+  EXPECT_EQ(fillPage(handler, PATTERN), msg::RES_OK);
+  handler.processRequest(createWriteRequest(FLASH_APP_FIRST_PAGE, 0U));
+  EXPECT_EQ(handler.getResponse().result, msg::RES_OK);
+  EXPECT_EQ(msg::convertMsgDataToU32(handler.getResponse().data), FLASH_APP_FIRST_PAGE);
+  EXPECT_EQ(getSim().num_started, 2U);
+  EXPECT_FALSE(getSim().running);
+  EXPECT_TRUE(isPageEqual(FLASH_APP_FIRST_PAGE, PATTERN));
+
+  /* Page buffer is kept for a repeated write */
+  EXPECT_EQ(handler.getByteFromPageBuffer(0U), 0xF0U);
+}
+
+TEST_F(AsyncFlashTests, BlankPageWithoutErase) {  // NOLINT
+  constexpr uint32_t PATTERN = 0x9ABCDEF0U;
+
+  AsyncBlankCheckHandler handler(getAsyncBlankCheckHWI());
+  setWriteToFlashResult(true);
+
+  /* Page of a factory blank device is written directly */
+  EXPECT_EQ(fillPage(handler, PATTERN), msg::RES_OK);
+  handler.processRequest(createWriteRequest(FLASH_APP_FIRST_PAGE, msg::WRITE_TO_FLASH_DEFER));
+  EXPECT_EQ(handler.getResponse().result, msg::RES_OK);
+
+  /* Start write, busy polls, write finished */
+  EXPECT_EQ(processCommit(handler, 0U), getSim().num_busy_polls + 2U);
+  EXPECT_EQ(getSim().num_started, 1U);
+  EXPECT_FALSE(erasePageCalled());
+  EXPECT_TRUE(isPageEqual(FLASH_APP_FIRST_PAGE, PATTERN));
+  EXPECT_EQ(readCommitStatus(handler, 0U).result, msg::RES_OK);
+}
+
+TEST_F(AsyncFlashTests, DeferredWriteDoubleBuffer) {  // NOLINT
+  constexpr uint32_t PATTERN_A = 0xA1A2A3A4U;
+  constexpr uint32_t PATTERN_B = 0xB1B2B3B4U;
+
+  AsyncDoubleBufferHandler handler(getAsyncHWI());
+  programPage(FLASH_APP_FIRST_PAGE);
+  programPage(FLASH_APP_FIRST_PAGE + 1U);
+  setErasePageResult(true);
+  setWriteToFlashResult(true);
+
+  EXPECT_EQ(fillPage(handler, PATTERN_A), msg::RES_OK);
+  handler.processRequest(createWriteRequest(FLASH_APP_FIRST_PAGE, msg::WRITE_TO_FLASH_DEFER));
+  EXPECT_EQ(handler.getResponse().result, msg::RES_OK);
+
+  /* Next page is received into the second page buffer while the first one is written */
+  handler.processBufferedCmds();
+  EXPECT_TRUE(getSim().running);
+  EXPECT_EQ(fillPage(handler, PATTERN_B), msg::RES_OK);
+  handler.processRequest(createWriteRequest(FLASH_APP_FIRST_PAGE + 1U, msg::WRITE_TO_FLASH_DEFER));
+  EXPECT_EQ(handler.getResponse().result, msg::RES_BUSY);
+
+  (void)processCommit(handler, 0U);
+  handler.processRequest(createWriteRequest(FLASH_APP_FIRST_PAGE + 1U, msg::WRITE_TO_FLASH_DEFER));
+  EXPECT_EQ(handler.getResponse().result, msg::RES_OK);
+  EXPECT_EQ(handler.getResponse().packet_id, 1U);
+
+  (void)processCommit(handler, 1U);
+  EXPECT_EQ(getSim().num_started, 4U);
+  EXPECT_TRUE(isPageEqual(FLASH_APP_FIRST_PAGE, PATTERN_A));
+  EXPECT_TRUE(isPageEqual(FLASH_APP_FIRST_PAGE + 1U, PATTERN_B));
+  EXPECT_EQ(readCommitStatus(handler, 0U).result, msg::RES_OK);
+  EXPECT_EQ(readCommitStatus(handler, 1U).result, msg::RES_OK);
+}
+
+TEST_F(AsyncFlashTests, EraseRange) {  // NOLINT
+  constexpr uint32_t NUM_PAGES = 3U;
+  constexpr uint32_t MAX_NUM_CALLS = 100U;
+
+  AsyncHandler handler(getAsyncHWI());
+  setErasePageResult(true);
+  setEraseSectorNumPages(NUM_PAGES);
+
+  auto request = msg::Msg(msg::REQ_FLASH_WRITE_ERASE_RANGE, msg::RES_NONE, 0U);
+  request.data = {FLASH_APP_FIRST_PAGE, 0U, NUM_PAGES, 0U};
+  handler.processRequest(request);
+  EXPECT_EQ(handler.getResponse().result, msg::RES_OK);
+
+  /* Pages are erased one by one, the status is answered in between */
+  uint32_t num_calls = 0U;
+  for (; num_calls < MAX_NUM_CALLS; num_calls++) {
+    handler.processRequest(msg::Msg(msg::REQ_FLASH_WRITE_ERASE_STATUS, msg::RES_NONE, 0U));
+    if (handler.getResponse().result != msg::RES_BUSY) {
+      break;
+    }
+
+    handler.processBufferedCmds();
+  }
+
+  EXPECT_EQ(handler.getResponse().result, msg::RES_OK);
+  EXPECT_EQ(handler.getResponse().data, (msg::MsgData{NUM_PAGES, 0U, NUM_PAGES, 0U}));
+  EXPECT_EQ(getSim().num_started, NUM_PAGES);
+  EXPECT_EQ(getEraseNumCalls(), 0U);
+  EXPECT_GT(num_calls, NUM_PAGES * getSim().num_busy_polls);
+}
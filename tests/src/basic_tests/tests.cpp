@@ -134,3 +134,33 @@ TEST(BasicTests, convertRawDataToMsg) {
   EXPECT_EQ(msg.data.at(2), 3);
   EXPECT_EQ(msg.data.at(3), 4);
 }
+
+/**
+ * @brief Check if a CAN-FD msg is correctly converted to a raw byte string and back
+ */
+TEST(BasicTests, convertCanFdMsgRoundTrip) {
+  constexpr auto REQUEST = msg::RequestType::REQ_PAGE_BUFFER_WRITE_WORD;
+  constexpr auto RESULT = msg::ResultType::RES_OK;
+  constexpr auto PACKET_ID = 42;
+
+  auto msg = msg::BasicMsg<msg::MSG_DATA_SIZE_CAN_FD>(REQUEST, RESULT, PACKET_ID);
+  for (auto idx = 0U; idx < msg.data.size(); idx++) {
+    msg.data.at(idx) = static_cast<uint8_t>(idx + 1U);
+  }
+
+  const auto raw_data = msg::convertMsgToBytes(msg);
+  EXPECT_EQ(raw_data.size(), 64U);
+  EXPECT_EQ(raw_data.at(0), static_cast<uint8_t>(REQUEST));
+  EXPECT_EQ(raw_data.at(1), static_cast<uint8_t>(REQUEST >> 8));
+  EXPECT_EQ(raw_data.at(2), static_cast<uint8_t>(RESULT));
+  EXPECT_EQ(raw_data.at(3), static_cast<uint8_t>(PACKET_ID));
+  EXPECT_EQ(raw_data.at(63), msg.data.at(59));
+
+  const auto msg_converted = msg::convertBytesToMsg(raw_data);
+  EXPECT_EQ(msg_converted.request, REQUEST);
+  EXPECT_EQ(msg_converted.result, RESULT);
+  EXPECT_EQ(msg_converted.packet_id, PACKET_ID);
+  for (auto idx = 0U; idx < msg.data.size(); idx++) {
+    EXPECT_EQ(msg_converted.data.at(idx), msg.data.at(idx));
+  }
+}
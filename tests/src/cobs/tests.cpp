@@ -0,0 +1,310 @@
+/**
+ * @file tests.cpp
+ * @author Martin Bauernschmitt (martin.bauernschmitt@francor.de)
+ * @brief Unit Tests of FRANCORs Frankly Bootloader - COBS Framing Layer
+ * @version 0.1
+ * @date 2022-11-26
+ *
+ * @copyright Copyright (c) 2022 - BSD-3-clause - FRANCOR e.V.
+ *
+ */
+
+#include <francor/frankly_test_utils.h>
+#include <francor/franklyboot/cobs.h>
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+using namespace franklyboot;              // NOLINT
+using namespace franklyboot::test_utils;  // NOLINT
+
+// Defines / Constexpr ------------------------------------------------------------------------------------------------
+
+/** \brief Number of bits transmitted per byte on UART (8N1) */
+constexpr uint32_t UART_BITS_PER_BYTE = 10U;
+
+// Test Fixture Class -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Test class for simulation of device connected via byte stream
+ */
+class CobsTests : public TestHelper {
+ public:
+  CobsTests() = default;
+
+  /**
+   * @brief Transmits an encoded frame byte by byte to the device and returns the encoded response
+   */
+  std::vector<uint8_t> transmitToDevice(const std::vector<uint8_t>& frame) {
+    std::vector<uint8_t> response(cobs::getMaxEncodedSize(0U));
+
+    _decoder.setBlockBuffer(_block_buffer.data(), _block_buffer.size());
+    for (const auto byte : frame) {
+      if (_decoder.processByte(byte)) {
+        getHandle().processBlockRequest(_decoder.getMsg(), _decoder.getBlockPtr(), _decoder.getBlockSize());
+        _decoder.releaseMsg();
+
+        const auto num_bytes =
+            cobs::encodeFrame(getHandle().getResponse(), nullptr, 0U, response.data(), response.size());
+        response.resize(num_bytes);
+        return response;
+      }
+    }
+
+    return {};
+  }
+
+  /**
+   * @brief Encodes a request
+   */
+  static std::vector<uint8_t> encode(const msg::Msg& request, const uint8_t* block_ptr = nullptr,
+                                     const uint32_t block_size = 0U) {
+    std::vector<uint8_t> frame(cobs::getMaxEncodedSize(block_size));
+    frame.resize(cobs::encodeFrame(request, block_ptr, block_size, frame.data(), frame.size()));
+    return frame;
+  }
+
+  /**
+   * @brief Decodes a response
+   */
+  static msg::Msg decode(const std::vector<uint8_t>& frame) {
+    cobs::Decoder decoder;
+    for (const auto byte : frame) {
+      if (decoder.processByte(byte)) {
+        return decoder.getMsg();
+      }
+    }
+
+    return msg::Msg();
+  }
+
+ private:
+  cobs::Decoder _decoder;
+  std::vector<uint8_t> _block_buffer = std::vector<uint8_t>(FLASH_PAGE_SIZE);  //!< Staging buffer of data blocks
+};
+
+// Tests --------------------------------------------------------------------------------------------------------------
+
+TEST(CobsBasicTests, CRCCheckValue) {  // NOLINT
+  const std::string check_str = "123456789";
+
+  uint32_t crc = cobs::CRC_INIT_VALUE;
+  for (const auto chr : check_str) {
+    crc = cobs::updateCRC(crc, static_cast<uint8_t>(chr));
+  }
+
+  EXPECT_EQ(cobs::finalizeCRC(crc), 0xCBF43926U);
+}
+
+TEST(CobsBasicTests, EncodeDecodeBlock) {  // NOLINT
+  /* Block with zeros and runs longer than a COBS block */
+  std::vector<uint8_t> block(1000U);
+  for (auto idx = 0U; idx < block.size(); idx++) {
+    block[idx] = (idx < 600U) ? static_cast<uint8_t>(idx % 7U) : 0x55U;
+  }
+
+  auto request = msg::Msg(msg::REQ_PAGE_BUFFER_WRITE_BLOCK, msg::RES_NONE, 0U);
+  msg::convertU32ToMsgData(0U, request.data);
+
+  std::vector<uint8_t> frame(cobs::getMaxEncodedSize(block.size()));
+  const auto num_bytes = cobs::encodeFrame(request, block.data(), block.size(), frame.data(), frame.size());
+  ASSERT_GT(num_bytes, 0U);
+
+  /* Delimiter only at end of frame */
+  for (auto idx = 0U; idx < (num_bytes - 1U); idx++) {
+    ASSERT_NE(frame[idx], cobs::FRAME_DELIMITER);
+  }
+  EXPECT_EQ(frame[num_bytes - 1U], cobs::FRAME_DELIMITER);
+
+  /* Decode into separate buffer */
+  std::vector<uint8_t> block_rx(block.size());
+  cobs::Decoder decoder;
+  decoder.setBlockBuffer(block_rx.data(), block_rx.size());
+
+  for (auto idx = 0U; idx < num_bytes; idx++) {
+    const bool msg_avl = decoder.processByte(frame[idx]);
+    EXPECT_EQ(msg_avl, idx == (num_bytes - 1U));
+  }
+
+  ASSERT_TRUE(decoder.isMsgAvl());
+  EXPECT_EQ(decoder.getMsg().request, msg::REQ_PAGE_BUFFER_WRITE_BLOCK);
+  EXPECT_EQ(decoder.getBlockPtr(), block_rx.data());
+  EXPECT_EQ(decoder.getBlockSize(), block.size());
+  EXPECT_EQ(block_rx, block);
+}
+
+TEST(CobsBasicTests, DropCorruptedFrame) {  // NOLINT
+  const auto request = msg::Msg(msg::REQ_PING, msg::RES_NONE, 0U);
+
+  std::vector<uint8_t> frame(cobs::getMaxEncodedSize(0U));
+  frame.resize(cobs::encodeFrame(request, nullptr, 0U, frame.data(), frame.size()));
+
+  /* Modify first CRC byte (first byte after code byte, must not become a delimiter) */
+  ASSERT_GT(frame[0U], 1U);
+  auto corrupted_frame = frame;
+  corrupted_frame[1U] = (frame[1U] == std::numeric_limits<uint8_t>::max()) ? 1U : frame[1U] + 1U;
+
+  cobs::Decoder decoder;
+  for (const auto byte : corrupted_frame) {
+    EXPECT_FALSE(decoder.processByte(byte));
+  }
+  EXPECT_EQ(decoder.getNumDroppedFrames(), 1U);
+
+  /* Next frame is received again (decoder resynchronizes on delimiter) */
+  bool msg_avl = false;
+  for (const auto byte : frame) {
+    msg_avl = decoder.processByte(byte);
+  }
+  EXPECT_TRUE(msg_avl);
+  EXPECT_EQ(decoder.getMsg().request, msg::REQ_PING);
+}
+
+TEST(CobsBasicTests, DropFrameNotReleased) {  // NOLINT
+  const auto request = msg::Msg(msg::REQ_PING, msg::RES_NONE, 0U);
+
+  std::vector<uint8_t> frame(cobs::getMaxEncodedSize(0U));
+  frame.resize(cobs::encodeFrame(request, nullptr, 0U, frame.data(), frame.size()));
+
+  cobs::Decoder decoder;
+  for (auto cnt = 0U; cnt < 2U; cnt++) {
+    for (const auto byte : frame) {
+      (void)decoder.processByte(byte);
+    }
+  }
+
+  EXPECT_TRUE(decoder.isMsgAvl());
+  EXPECT_EQ(decoder.getNumDroppedFrames(), 1U);
+}
+
+TEST_F(CobsTests, WritePage) {  // NOLINT
+  std::vector<uint8_t> page(getHandle().getFlashPageSize());
+  for (auto& entry : page) {
+    entry = rand() % std::numeric_limits<uint8_t>::max();
+  }
+
+  auto request = msg::Msg(msg::REQ_PAGE_BUFFER_WRITE_BLOCK, msg::RES_NONE, 0U);
+  msg::convertU32ToMsgData(0U, request.data);
+
+  const auto response = decode(transmitToDevice(encode(request, page.data(), page.size())));
+
+  EXPECT_EQ(response.request, msg::REQ_PAGE_BUFFER_WRITE_BLOCK);
+  EXPECT_EQ(response.result, msg::RES_OK);
+  EXPECT_EQ(msg::convertMsgDataToU32(response.data), page.size());
+
+  EXPECT_EQ(getHandle().getPageBufferNumBytesFree(), 0U);
+  for (auto idx = 0U; idx < page.size(); idx++) {
+    EXPECT_EQ(getHandle().getByteFromPageBuffer(idx), page.at(idx));
+  }
+}
+
+TEST_F(CobsTests, CorruptedFrameKeepsPageBuffer) {  // NOLINT
+  constexpr uint32_t BLOCK_AT_IDX = 512U;
+
+  /* Second half of the page received first (random access) */
+  const std::vector<uint8_t> block_at(FLASH_PAGE_SIZE - BLOCK_AT_IDX, 0xA5U);
+  auto request_at = msg::Msg(msg::REQ_PAGE_BUFFER_WRITE_BLOCK_AT, msg::RES_NONE, 0U);
+  msg::convertU32ToMsgData(BLOCK_AT_IDX, request_at.data);
+  EXPECT_EQ(decode(transmitToDevice(encode(request_at, block_at.data(), block_at.size()))).result, msg::RES_OK);
+
+  /* Complete page with a corrupted byte in the second half -> dropped without response */
+  const std::vector<uint8_t> page(FLASH_PAGE_SIZE, 0x3CU);
+  auto request = msg::Msg(msg::REQ_PAGE_BUFFER_WRITE_BLOCK, msg::RES_NONE, 0U);
+  msg::convertU32ToMsgData(0U, request.data);
+
+  auto frame = encode(request, page.data(), page.size());
+  frame[frame.size() - 10U] ^= 0x01U;
+  ASSERT_NE(frame[frame.size() - 10U], cobs::FRAME_DELIMITER);
+  EXPECT_TRUE(transmitToDevice(frame).empty());
+
+  for (auto idx = 0U; idx < FLASH_PAGE_SIZE; idx++) {
+    const uint8_t expected = (idx < BLOCK_AT_IDX) ? std::numeric_limits<uint8_t>::max() : 0xA5U;
+    EXPECT_EQ(getHandle().getByteFromPageBuffer(idx), expected);
+  }
+}
+
+TEST_F(CobsTests, WriteBlockOverflow) {  // NOLINT
+  const std::vector<uint8_t> block(getHandle().getFlashPageSize() + 1U);
+
+  auto request = msg::Msg(msg::REQ_PAGE_BUFFER_WRITE_BLOCK, msg::RES_NONE, 0U);
+  msg::convertU32ToMsgData(0U, request.data);
+
+  const auto response = decode(transmitToDevice(encode(request, block.data(), block.size())));
+
+  EXPECT_EQ(response.result, msg::RES_ERR_PAGE_FULL);
+  EXPECT_EQ(msg::convertMsgDataToU32(response.data), 0U);
+}
+
+/**
+ * @brief Loopback benchmark: page upload with COBS frames vs. word by word with 8 byte messages
+ *
+ * Time on the wire is calculated from the number of transmitted bytes (8N1), the processing time of the
+ * decoder and handler is measured.
+ */
+TEST_F(CobsTests, ThroughputBenchmark) {  // NOLINT
+  constexpr std::array<uint32_t, 3U> BAUDRATES = {115200U, 1000000U, 3000000U};
+  constexpr uint32_t NUM_PAGES = 16U;
+
+  const uint32_t page_size = getHandle().getFlashPageSize();
+  std::vector<uint8_t> page(page_size);
+  for (auto& entry : page) {
+    entry = rand() % std::numeric_limits<uint8_t>::max();
+  }
+
+  /* Word by word: 8 byte request and 8 byte response per word */
+  uint64_t word_num_bytes = 0U;
+  auto word_start = std::chrono::steady_clock::now();
+  for (auto page_idx = 0U; page_idx < NUM_PAGES; page_idx++) {
+    getHandle().processRequest(msg::Msg(msg::REQ_PAGE_BUFFER_CLEAR, msg::RES_NONE, 0U));
+    for (auto word_idx = 0U; word_idx < (page_size / 4U); word_idx++) {
+      auto request = msg::Msg(msg::REQ_PAGE_BUFFER_WRITE_WORD, msg::RES_NONE, static_cast<uint8_t>(word_idx));
+      for (auto idx = 0U; idx < request.data.size(); idx++) {
+        request.data[idx] = page[word_idx * 4U + idx];
+      }
+
+      getHandle().processRequest(msg::convertBytesToMsg(msg::convertMsgToBytes(request)));
+      ASSERT_EQ(msg::convertMsgToBytes(getHandle().getResponse())[2U], msg::RES_OK);
+      word_num_bytes += 2U * msg::convertMsgToBytes(request).size();
+    }
+  }
+  const double word_cpu_s =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - word_start).count() / NUM_PAGES;
+
+  /* COBS: one frame per page and one response frame */
+  uint64_t cobs_num_bytes = 0U;
+  auto cobs_start = std::chrono::steady_clock::now();
+  for (auto page_idx = 0U; page_idx < NUM_PAGES; page_idx++) {
+    getHandle().processRequest(msg::Msg(msg::REQ_PAGE_BUFFER_CLEAR, msg::RES_NONE, 0U));
+
+    auto request = msg::Msg(msg::REQ_PAGE_BUFFER_WRITE_BLOCK, msg::RES_NONE, 0U);
+    msg::convertU32ToMsgData(0U, request.data);
+
+    const auto frame = encode(request, page.data(), page.size());
+    const auto response_frame = transmitToDevice(frame);
+    ASSERT_EQ(decode(response_frame).result, msg::RES_OK);
+    cobs_num_bytes += frame.size() + response_frame.size();
+  }
+  const double cobs_cpu_s =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - cobs_start).count() / NUM_PAGES;
+
+  std::cout << "[ PAGE     ] " << page_size << " bytes" << std::endl;
+  std::cout << "[ WORD     ] " << word_num_bytes / NUM_PAGES << " bytes on wire per page" << std::endl;
+  std::cout << "[ COBS     ] " << cobs_num_bytes / NUM_PAGES << " bytes on wire per page" << std::endl;
+
+  for (const auto baudrate : BAUDRATES) {
+    const double word_time_s =
+        static_cast<double>(word_num_bytes / NUM_PAGES * UART_BITS_PER_BYTE) / baudrate + word_cpu_s;
+    const double cobs_time_s =
+        static_cast<double>(cobs_num_bytes / NUM_PAGES * UART_BITS_PER_BYTE) / baudrate + cobs_cpu_s;
+
+    const double word_throughput = page_size / word_time_s / 1024.0;
+    const double cobs_throughput = page_size / cobs_time_s / 1024.0;
+
+    std::cout << "[ " << std::setw(7) << baudrate << "  ] word: " << std::fixed << std::setprecision(1)
+              << word_throughput << " KiB/s / cobs: " << cobs_throughput << " KiB/s" << std::endl;
+
+    EXPECT_GT(cobs_throughput, word_throughput);
+  }
+}
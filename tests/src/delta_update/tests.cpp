@@ -0,0 +1,259 @@
+/**
+ * @file tests.cpp
+ * @author Martin Bauernschmitt (martin.bauernschmitt@francor.de)
+ * @brief Unit Tests of FRANCORs Frankly Bootloader - Delta Update
+ * @version 0.1
+ * @date 2022-11-26
+ *
+ * @copyright Copyright (c) 2022 - BSD-3-clause - FRANCOR e.V.
+ *
+ */
+
+#include <francor/frankly_test_utils.h>
+
+#include <iostream>
+#include <limits>
+#include <vector>
+
+using namespace franklyboot;              // NOLINT
+using namespace franklyboot::test_utils;  // NOLINT
+
+// Defines / Constexpr ------------------------------------------------------------------------------------------------
+
+/** \brief Number of pages of the app image */
+constexpr uint32_t APP_NUM_PAGES = 6U;
+
+/** \brief Size of a page buffer word */
+constexpr uint32_t WORD_SIZE = msg::MSG_DATA_SIZE_CAN;
+
+// Test Fixture Class -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Test class for delta updates
+ */
+class DeltaUpdateTests : public TestHelper {
+ public:
+  DeltaUpdateTests() = default;
+
+  /**
+   * @brief Creates an app image (code, repeated tables, padding)
+   */
+  [[nodiscard]] static std::vector<uint8_t> createAppImage() {
+    std::vector<uint8_t> image;
+
+    while (image.size() < ((APP_NUM_PAGES - 1U) * FLASH_PAGE_SIZE)) {
+      for (auto idx = 0U; idx < 300U; idx++) {
+        image.push_back(static_cast<uint8_t>(rand() % std::numeric_limits<uint8_t>::max()));
+      }
+      for (auto idx = 0U; idx < 64U; idx++) {
+        image.push_back(static_cast<uint8_t>(idx * 7U));
+      }
+    }
+
+    image.resize(APP_NUM_PAGES * FLASH_PAGE_SIZE, std::numeric_limits<uint8_t>::max());
+    return image;
+  }
+
+  /**
+   * @brief Creates the new release: function inserted (shifts the following code) and constants changed
+   */
+  [[nodiscard]] static std::vector<uint8_t> createNewAppImage(const std::vector<uint8_t>& old_image) {
+    constexpr uint32_t INSERT_OFFSET = 1500U;
+    constexpr uint32_t INSERT_SIZE = 37U;
+    constexpr uint32_t CHANGE_OFFSET = 4000U;
+
+    auto image = old_image;
+    for (auto idx = 0U; idx < INSERT_SIZE; idx++) {
+      image.insert(image.begin() + INSERT_OFFSET, static_cast<uint8_t>(rand() % std::numeric_limits<uint8_t>::max()));
+    }
+    for (auto idx = 0U; idx < 8U; idx++) {
+      image[CHANGE_OFFSET + idx] ^= 0x5AU;
+    }
+
+    image.resize(old_image.size());
+    return image;
+  }
+
+  /**
+   * @brief Writes the app image to the simulated flash
+   */
+  void writeAppImageToFlash(const std::vector<uint8_t>& image) {
+    for (auto idx = 0U; idx < image.size(); idx++) {
+      setByteInFlash(FLASH_START + FLASH_APP_FIRST_PAGE * FLASH_PAGE_SIZE + idx, image[idx]);
+    }
+  }
+
+  /**
+   * @brief Sends the patch of a page to the page buffer
+   *
+   * @return Number of frames on the bus (requests and responses)
+   */
+  uint32_t sendPagePatch(const std::vector<PagePatchOp>& ops) {
+    uint32_t num_frames = 0U;
+    uint32_t word_idx = 0U;
+
+    for (const auto& op : ops) {
+      if (op.type != PagePatchOpType::LITERAL) {
+        const bool copy = (op.type == PagePatchOpType::COPY);
+        const auto request_type = copy ? msg::REQ_PAGE_BUFFER_COPY_FROM_FLASH : msg::REQ_PAGE_BUFFER_FILL;
+        auto request = msg::Msg(request_type, static_cast<msg::ResultType>(op.num_words >> 8U),
+                                static_cast<uint8_t>(op.num_words));
+        msg::convertU32ToMsgData(copy ? op.src_offset : op.pattern, request.data);
+        getHandle().processRequest(request);
+        EXPECT_EQ(getHandle().getResponse().result, msg::RES_OK);
+        num_frames += 2U;
+      } else {
+        for (auto idx = 0U; idx < op.num_words; idx++) {
+          const auto packet_id = static_cast<uint8_t>(word_idx + idx);
+          auto request = msg::Msg(msg::REQ_PAGE_BUFFER_STREAM_WORD, msg::RES_NONE, packet_id);
+          for (auto byte_idx = 0U; byte_idx < WORD_SIZE; byte_idx++) {
+            request.data[byte_idx] = op.literal.at(idx * WORD_SIZE + byte_idx);
+          }
+          getHandle().processRequest(request);
+          num_frames++;
+
+          if (getHandle().isResponseAvl()) {
+            EXPECT_EQ(getHandle().getResponse().result, msg::RES_OK);
+            num_frames++;
+          }
+        }
+      }
+
+      word_idx += op.num_words;
+    }
+
+    EXPECT_EQ(getHandle().getPageBufferNumBytesFree(), 0U);
+    return num_frames;
+  }
+};
+
+// Tests --------------------------------------------------------------------------------------------------------------
+
+TEST_F(DeltaUpdateTests, CopyFromFlash) {  // NOLINT
+  constexpr uint32_t SRC_OFFSET = 3U * FLASH_PAGE_SIZE + 5U;
+  constexpr uint32_t NUM_WORDS = 10U;
+
+  for (auto idx = 0U; idx < (NUM_WORDS * WORD_SIZE); idx++) {
+    setByteInFlash(FLASH_START + SRC_OFFSET + idx, static_cast<uint8_t>(idx));
+  }
+
+  auto request = msg::Msg(msg::REQ_PAGE_BUFFER_COPY_FROM_FLASH, msg::RES_NONE, NUM_WORDS);
+  msg::convertU32ToMsgData(SRC_OFFSET, request.data);
+  getHandle().processRequest(request);
+
+  EXPECT_TRUE(getHandle().isResponseAvl());
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_OK);
+  EXPECT_EQ(getHandle().getResponse().packet_id, NUM_WORDS);
+  EXPECT_EQ(msg::convertMsgDataToU32(getHandle().getResponse().data), NUM_WORDS * WORD_SIZE);
+
+  for (auto idx = 0U; idx < (NUM_WORDS * WORD_SIZE); idx++) {
+    EXPECT_EQ(getHandle().getByteFromPageBuffer(idx), static_cast<uint8_t>(idx));
+  }
+
+  /* Literal words continue behind the copied words */
+  auto stream_request = msg::Msg(msg::REQ_PAGE_BUFFER_STREAM_WORD, msg::RES_NONE, NUM_WORDS);
+  stream_request.data = {0xAA, 0xBB, 0xCC, 0xDD};
+  getHandle().processRequest(stream_request);
+  EXPECT_EQ(getHandle().getByteFromPageBuffer(NUM_WORDS * WORD_SIZE), 0xAA);
+  EXPECT_EQ(getHandle().getPageBufferNumBytesFree(), FLASH_PAGE_SIZE - (NUM_WORDS + 1U) * WORD_SIZE);
+}
+
+TEST_F(DeltaUpdateTests, CopyFromFlashInvldArgs) {  // NOLINT
+  /* No words */
+  getHandle().processRequest(msg::Msg(msg::REQ_PAGE_BUFFER_COPY_FROM_FLASH, msg::RES_NONE, 0U));
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_ERR_INVLD_ARG);
+
+  /* Source behind the end of the flash */
+  auto request = msg::Msg(msg::REQ_PAGE_BUFFER_COPY_FROM_FLASH, msg::RES_NONE, 2U);
+  msg::convertU32ToMsgData(FLASH_SIZE - WORD_SIZE, request.data);
+  getHandle().processRequest(request);
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_ERR_INVLD_ARG);
+
+  msg::convertU32ToMsgData(std::numeric_limits<uint32_t>::max(), request.data);
+  getHandle().processRequest(request);
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_ERR_INVLD_ARG);
+
+  /* More words than the page buffer */
+  request = msg::Msg(msg::REQ_PAGE_BUFFER_COPY_FROM_FLASH, static_cast<msg::ResultType>(1U), 1U);
+  msg::convertU32ToMsgData(0U, request.data);
+  getHandle().processRequest(request);
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_ERR_PAGE_FULL);
+  EXPECT_EQ(getHandle().getPageBufferNumBytesFree(), FLASH_PAGE_SIZE);
+
+  /* Complete page in one copy */
+  request = msg::Msg(msg::REQ_PAGE_BUFFER_COPY_FROM_FLASH, static_cast<msg::ResultType>(1U), 0U);
+  getHandle().processRequest(request);
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_OK);
+  EXPECT_EQ(getHandle().getPageBufferNumBytesFree(), 0U);
+}
+
+TEST_F(DeltaUpdateTests, DeltaUpdateApp) {  // NOLINT
+  setErasePageResult(true);
+  setWriteToFlashResult(true);
+
+  const auto old_image = createAppImage();
+  const auto new_image = createNewAppImage(old_image);
+  writeAppImageToFlash(old_image);
+
+  /* Host model of the flash: pages already written contain the new release */
+  std::vector<uint8_t> flash(FLASH_SIZE, std::numeric_limits<uint8_t>::max());
+  for (auto idx = 0U; idx < flash.size(); idx++) {
+    flash[idx] = readByteFromFlash(FLASH_START + idx);
+  }
+
+  uint32_t num_frames = 0U;
+  for (auto page_idx = 0U; page_idx < APP_NUM_PAGES; page_idx++) {
+    const auto page_begin = new_image.begin() + page_idx * FLASH_PAGE_SIZE;
+    const std::vector<uint8_t> page(page_begin, page_begin + FLASH_PAGE_SIZE);
+    const uint32_t page_id = FLASH_APP_FIRST_PAGE + page_idx;
+
+    getHandle().processRequest(msg::Msg(msg::REQ_PAGE_BUFFER_CLEAR, msg::RES_NONE, 0U));
+    num_frames += 2U;
+    num_frames += sendPagePatch(createDeltaPatch(flash, page, WORD_SIZE));
+
+    auto request = msg::Msg(msg::REQ_PAGE_BUFFER_WRITE_TO_FLASH, msg::RES_NONE, 0U);
+    msg::convertU32ToMsgData(page_id, request.data);
+    getHandle().processRequest(request);
+    EXPECT_EQ(getHandle().getResponse().result, msg::RES_OK);
+    num_frames += 2U;
+
+    std::copy(page.begin(), page.end(), flash.begin() + page_id * FLASH_PAGE_SIZE);
+  }
+
+  for (auto idx = 0U; idx < new_image.size(); idx++) {
+    EXPECT_EQ(readByteFromFlash(FLASH_START + FLASH_APP_FIRST_PAGE * FLASH_PAGE_SIZE + idx), new_image[idx]);
+  }
+
+  /* Full upload: clear, streamed words with one response per window, write to flash */
+  const uint32_t num_words = FLASH_PAGE_SIZE / WORD_SIZE;
+  const uint32_t num_frames_full = APP_NUM_PAGES * (2U + num_words + num_words / 16U + 2U);
+  std::cout << "Delta update: " << num_frames << " frames, full upload " << num_frames_full << " frames" << std::endl;
+  EXPECT_LT(num_frames * 4U, num_frames_full);
+}
+
+TEST_F(DeltaUpdateTests, FillPaddingPage) {  // NOLINT
+  /* Code, zero initialized table, erased padding */
+  std::vector<uint8_t> page;
+  for (auto idx = 0U; idx < 200U; idx++) {
+    page.push_back(static_cast<uint8_t>(rand() % std::numeric_limits<uint8_t>::max()));
+  }
+  page.resize(400U, 0U);
+  page.resize(FLASH_PAGE_SIZE, std::numeric_limits<uint8_t>::max());
+
+  const auto ops = createFillPatch(page, WORD_SIZE);
+  ASSERT_EQ(ops.size(), 3U);
+  EXPECT_EQ(ops.at(1U).type, PagePatchOpType::FILL);
+  EXPECT_EQ(ops.at(1U).pattern, 0U);
+  EXPECT_EQ(ops.at(2U).type, PagePatchOpType::FILL);
+  EXPECT_EQ(ops.at(2U).pattern, std::numeric_limits<uint32_t>::max());
+
+  const uint32_t num_frames = sendPagePatch(ops);
+  for (auto idx = 0U; idx < FLASH_PAGE_SIZE; idx++) {
+    EXPECT_EQ(getHandle().getByteFromPageBuffer(idx), page[idx]);
+  }
+
+  const uint32_t num_words = FLASH_PAGE_SIZE / WORD_SIZE;
+  std::cout << "Padded page: " << num_frames << " frames, full upload " << num_words + num_words / 16U << " frames"
+            << std::endl;
+  EXPECT_LT(num_frames * 3U, num_words);
+}
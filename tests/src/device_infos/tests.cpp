@@ -25,6 +25,20 @@ class DeviceInfoTests : public TestHelper {
  public:
   DeviceInfoTests() = default;
 };
+
+/**
+ * @brief Backend of a node sharing the simulation of the test, but reporting its own unique ID
+ */
+class NodeHWI : public TestHWI {
+ public:
+  NodeHWI(TestHelper& helper, const uint32_t node_id) : TestHWI(helper), _node_id(node_id) {}
+
+  [[nodiscard]] uint32_t getUniqueIDWord(const uint32_t idx) const { return (idx == 0U) ? _node_id : 0U; }
+
+ private:
+  uint32_t _node_id;
+};
+
 // Tests --------------------------------------------------------------------------------------------------------------
 
 TEST_F(DeviceInfoTests, BootloaderVersion) {
@@ -226,4 +240,157 @@ TEST_F(DeviceInfoTests, UniqueID4) {
     const auto expected_val = static_cast<uint8_t>(this->getUniqueIDWord(3) >> (8U * idx));
     EXPECT_EQ(response.data.at(idx), expected_val);
   }
-}
\ No newline at end of file
+}
+
+TEST_F(DeviceInfoTests, Inventory) {
+  constexpr msg::RequestType REQUEST = msg::REQ_DEV_INFO_INVENTORY;
+  constexpr uint32_t VID = 0x12345678U;
+  constexpr uint32_t PID = 0x9ABCDEF0U;
+  constexpr uint32_t PRD = 0x20221126U;
+  constexpr uint32_t CRC_VALUE = 0x1AC0BAAFU;
+
+  setVendorID(VID);
+  setProductID(PID);
+  setProductionDate(PRD);
+  setCRCResult(CRC_VALUE);
+
+  const std::array<uint32_t, msg::INV_NUM_FIELDS> expected_fields = {
+      version::VERSION[0] | (version::VERSION[1] << 8U) | (version::VERSION[2] << 16U),
+      VID,
+      PID,
+      PRD,
+      0x11U,
+      0x22U,
+      0x33U,
+      0x44U,
+      FLASH_START,
+      FLASH_PAGE_SIZE,
+      FLASH_NUM_PAGES,
+      FLASH_APP_FIRST_PAGE,
+      CRC_VALUE,
+      0xFFFFFFFFU,
+  };
+
+  /* Process request -> one frame per field */
+  getHandle().processRequest(msg::Msg(REQUEST, msg::RES_NONE, 0U));
+
+  uint32_t field = 0U;
+  while (getHandle().isResponseAvl()) {
+    const auto response = getHandle().getResponse();
+    EXPECT_EQ(response.request, REQUEST);
+    EXPECT_EQ(response.result, msg::RES_OK);
+    EXPECT_EQ(response.packet_id, field);
+    ASSERT_LT(field, expected_fields.size());
+    EXPECT_EQ(msg::convertMsgDataToU32(response.data), expected_fields.at(field));
+
+    field++;
+    getHandle().processNextResponse();
+  }
+
+  EXPECT_EQ(field, msg::INV_NUM_FIELDS);
+}
+
+TEST_F(DeviceInfoTests, InventoryCanFd) {
+  constexpr msg::RequestType REQUEST = msg::REQ_DEV_INFO_INVENTORY;
+  constexpr uint32_t VID = 0x12345678U;
+
+  using CanFdHandler = TestHandler<16U, msg::MSG_DATA_SIZE_CAN_FD>;
+  CanFdHandler handler(getHWI());
+
+  setVendorID(VID);
+
+  /* All fields fit into one CAN-FD frame */
+  handler.processRequest(CanFdHandler::Msg(REQUEST, msg::RES_NONE, 0U));
+  ASSERT_TRUE(handler.isResponseAvl());
+
+  const auto response = handler.getResponse();
+  EXPECT_EQ(response.result, msg::RES_OK);
+  EXPECT_EQ(msg::convertMsgDataToU32(response.data, msg::INV_VID * sizeof(uint32_t)), VID);
+  EXPECT_EQ(msg::convertMsgDataToU32(response.data, msg::INV_FLASH_PAGE_SIZE * sizeof(uint32_t)), FLASH_PAGE_SIZE);
+  EXPECT_EQ(msg::convertMsgDataToU32(response.data, msg::INV_UID_4 * sizeof(uint32_t)), 0x44U);
+
+  handler.processNextResponse();
+  EXPECT_FALSE(handler.isResponseAvl());
+}
+
+TEST_F(DeviceInfoTests, Capabilities) {
+  constexpr msg::RequestType REQUEST = msg::REQ_DEV_INFO_CAPABILITIES;
+
+  /* Default instantiation: no compression, no queue */
+  getHandle().processRequest(msg::Msg(REQUEST, msg::RES_NONE, 0U));
+
+  std::array<uint32_t, msg::CAP_NUM_FIELDS> fields = {0U};
+  uint32_t field = 0U;
+  while (getHandle().isResponseAvl()) {
+    const auto response = getHandle().getResponse();
+    EXPECT_EQ(response.request, REQUEST);
+    EXPECT_EQ(response.result, msg::RES_OK);
+    EXPECT_EQ(response.packet_id, field);
+    ASSERT_LT(field, fields.size());
+    fields.at(field) = msg::convertMsgDataToU32(response.data);
+
+    field++;
+    getHandle().processNextResponse();
+  }
+
+  EXPECT_EQ(field, msg::CAP_NUM_FIELDS);
+  EXPECT_EQ(fields, getHandle().getCapabilities());
+  EXPECT_NE(fields.at(msg::CAP_FEATURES) & msg::FEATURE_STREAM_WORD, 0U);
+  EXPECT_EQ(fields.at(msg::CAP_FEATURES) & msg::FEATURE_COMPRESSION, 0U);
+  EXPECT_EQ(fields.at(msg::CAP_FEATURES) & msg::FEATURE_REQUEST_QUEUE, 0U);
+  EXPECT_EQ(fields.at(msg::CAP_MSG_DATA_SIZE), msg::MSG_DATA_SIZE_CAN);
+  EXPECT_EQ(fields.at(msg::CAP_STREAM_WINDOW_SIZE), getHandle().getStreamWindowSize());
+  EXPECT_EQ(fields.at(msg::CAP_NUM_PAGE_BUFFERS), 1U);
+  EXPECT_EQ(fields.at(msg::CAP_DECOMPRESSION_WINDOW_BITS), 0U);
+  EXPECT_EQ(fields.at(msg::CAP_QUEUE_SIZE), 0U);
+}
+
+TEST_F(DeviceInfoTests, CapabilitiesCanFd) {
+  constexpr msg::RequestType REQUEST = msg::REQ_DEV_INFO_CAPABILITIES;
+
+  using CanFdHandler = TestHandler<32U, msg::MSG_DATA_SIZE_CAN_FD, 8U, 10U>;
+  CanFdHandler handler(getHWI());
+
+  /* All fields fit into one CAN-FD frame */
+  handler.processRequest(CanFdHandler::Msg(REQUEST, msg::RES_NONE, 0U));
+  ASSERT_TRUE(handler.isResponseAvl());
+
+  const auto response = handler.getResponse();
+  const uint32_t features = msg::convertMsgDataToU32(response.data, msg::CAP_FEATURES * sizeof(uint32_t));
+  EXPECT_NE(features & msg::FEATURE_COMPRESSION, 0U);
+  EXPECT_NE(features & msg::FEATURE_REQUEST_QUEUE, 0U);
+  EXPECT_EQ(msg::convertMsgDataToU32(response.data, msg::CAP_MSG_DATA_SIZE * sizeof(uint32_t)),
+            msg::MSG_DATA_SIZE_CAN_FD);
+  EXPECT_EQ(msg::convertMsgDataToU32(response.data, msg::CAP_STREAM_WINDOW_SIZE * sizeof(uint32_t)), 32U);
+  EXPECT_EQ(msg::convertMsgDataToU32(response.data, msg::CAP_DECOMPRESSION_WINDOW_BITS * sizeof(uint32_t)), 10U);
+  EXPECT_EQ(msg::convertMsgDataToU32(response.data, msg::CAP_QUEUE_SIZE * sizeof(uint32_t)), 8U);
+
+  handler.processNextResponse();
+  EXPECT_FALSE(handler.isResponseAvl());
+
+  /* Compile time constants */
+  static_assert(CanFdHandler::getCapabilities().at(msg::CAP_QUEUE_SIZE) == 8U);
+}
+
+TEST_F(DeviceInfoTests, MultipleDevices) {
+  using NodeHandler = Handler<FLASH_START, FLASH_APP_FIRST_PAGE, FLASH_SIZE, FLASH_PAGE_SIZE, 16U,
+                              msg::MSG_DATA_SIZE_CAN, 0U, 0U, 1U, NodeHWI>;
+  NodeHandler node_a(NodeHWI(*this, 0xA0A0A0A0U));
+  NodeHandler node_b(NodeHWI(*this, 0xB0B0B0B0U));
+  setUniqueIDWord(0U, 0x11U);
+
+  /* Every handler calls its own backend */
+  const auto request = msg::Msg(msg::REQ_DEV_INFO_UID_1, msg::RES_NONE, 0U);
+  node_a.processRequest(request);
+  node_b.processRequest(request);
+  getHandle().processRequest(request);
+
+  EXPECT_EQ(msg::convertMsgDataToU32(node_a.getResponse().data), 0xA0A0A0A0U);
+  EXPECT_EQ(msg::convertMsgDataToU32(node_b.getResponse().data), 0xB0B0B0B0U);
+  EXPECT_EQ(msg::convertMsgDataToU32(getHandle().getResponse().data), 0x11U);
+
+  /* Functions not replaced by the policy are forwarded to the simulation */
+  setVendorID(0x12345678U);
+  node_a.processRequest(msg::Msg(msg::REQ_DEV_INFO_VID, msg::RES_NONE, 0U));
+  EXPECT_EQ(msg::convertMsgDataToU32(node_a.getResponse().data), 0x12345678U);
+}
@@ -0,0 +1,183 @@
+/**
+ * @file tests.cpp
+ * @author Martin Bauernschmitt (martin.bauernschmitt@francor.de)
+ * @brief Unit Tests of FRANCORs Frankly Bootloader - Device Simulation
+ * @version 0.1
+ * @date 2023-01-17
+ *
+ * @copyright Copyright (c) 2023 - BSD-3-clause - FRANCOR e.V.
+ *
+ */
+
+#include <francor/franklyboot/device_sim_api.h>
+#include <francor/franklyboot/msg.h>
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <map>
+#include <vector>
+
+using namespace franklyboot;  // NOLINT
+
+// Tests --------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Enumerates a fleet of simulated devices with one broadcast inventory request
+ */
+TEST(DeviceSimTests, BroadcastInventory) {  // NOLINT
+  constexpr uint8_t NUM_DEVICES = 100U;
+
+  SIM_reset();
+  for (uint8_t node_id = 1U; node_id <= NUM_DEVICES; node_id++) {
+    ASSERT_TRUE(SIM_addDevice(node_id));
+  }
+
+  auto raw_msg = msg::convertMsgToBytes(msg::Msg(msg::REQ_DEV_INFO_INVENTORY, msg::RES_NONE, 0U));
+  SIM_sendBroadcastMsg(raw_msg.data());
+  SIM_updateDevices();
+
+  /* Collect all response frames of all devices */
+  std::map<uint8_t, std::vector<uint32_t>> inventory_lst;
+  uint8_t node_id = 0U;
+  while (SIM_getBroadcastResponseMsg(&node_id, raw_msg.data())) {
+    const auto response = msg::convertBytesToMsg(raw_msg);
+    ASSERT_EQ(response.request, msg::REQ_DEV_INFO_INVENTORY);
+    ASSERT_EQ(response.result, msg::RES_OK);
+
+    auto& fields = inventory_lst[node_id];
+    ASSERT_EQ(response.packet_id, fields.size());
+    fields.push_back(msg::convertMsgDataToU32(response.data));
+  }
+
+  ASSERT_EQ(inventory_lst.size(), NUM_DEVICES);
+  for (const auto& [id, fields] : inventory_lst) {
+    ASSERT_EQ(fields.size(), msg::INV_NUM_FIELDS);
+    EXPECT_EQ(fields.at(msg::INV_VID), sim_device::VENDOR_ID);
+    EXPECT_EQ(fields.at(msg::INV_PID), sim_device::PRODUCT_ID);
+    EXPECT_EQ(fields.at(msg::INV_FLASH_PAGE_SIZE), sim_device::FLASH_PAGE_SIZE);
+    EXPECT_EQ(fields.at(msg::INV_APP_PAGE_IDX), sim_device::FLASH_APP_FIRST_PAGE);
+  }
+
+  SIM_reset();
+}
+
+/**
+ * @brief Fills the page buffer of a fleet of simulated devices with broadcast messages and repairs lost words node
+ *        specific
+ */
+TEST(DeviceSimTests, BroadcastPageUpload) {  // NOLINT
+  constexpr uint8_t NUM_DEVICES = 32U;
+  constexpr uint32_t NUM_WORDS = sim_device::FLASH_PAGE_SIZE / msg::MSG_DATA_SIZE_CAN;
+  constexpr uint32_t NUM_LOST_WORDS_PER_DEVICE = 3U;
+
+  SIM_reset();
+  for (uint8_t node_id = 1U; node_id <= NUM_DEVICES; node_id++) {
+    ASSERT_TRUE(SIM_addDevice(node_id));
+  }
+
+  auto get_word_msg = [](const uint32_t word_idx) {
+    auto request = msg::Msg(msg::REQ_PAGE_BUFFER_WRITE_WORD_AT, static_cast<msg::ResultType>(word_idx >> 8U),
+                            static_cast<uint8_t>(word_idx & 0xFF));
+    msg::convertU32ToMsgData(word_idx * 0x01010101U, request.data);
+    return request;
+  };
+
+  auto is_word_lost = [](const uint8_t node_id, const uint32_t word_idx) {
+    return ((word_idx * 7U + node_id) % (NUM_WORDS / NUM_LOST_WORDS_PER_DEVICE)) == 0U;
+  };
+
+  auto node_request = [](const uint8_t node_id, const msg::Msg& request) {
+    auto raw_msg = msg::convertMsgToBytes(request);
+    SIM_sendNodeMsg(node_id, raw_msg.data());
+    SIM_updateDevices();
+    EXPECT_TRUE(SIM_getNodeResponseMsg(node_id, raw_msg.data()));
+    return msg::convertBytesToMsg(raw_msg);
+  };
+
+  /* Broadcast clear and all words, every device misses some words */
+  uint32_t num_frames = 0U;
+  auto raw_msg = msg::convertMsgToBytes(msg::Msg(msg::REQ_PAGE_BUFFER_CLEAR, msg::RES_NONE, 0U));
+  SIM_sendBroadcastMsg(raw_msg.data());
+  num_frames++;
+
+  for (auto word_idx = 0U; word_idx < NUM_WORDS; word_idx++) {
+    for (uint8_t node_id = 1U; node_id <= NUM_DEVICES; node_id++) {
+      if (is_word_lost(node_id, word_idx)) {
+        SIM_dropNextBroadcastMsg(node_id);
+      }
+    }
+
+    raw_msg = msg::convertMsgToBytes(get_word_msg(word_idx));
+    SIM_sendBroadcastMsg(raw_msg.data());
+    num_frames++;
+  }
+
+  SIM_updateDevices();
+
+  /* Page buffer fills are not acknowledged */
+  uint8_t node_id = 0U;
+  EXPECT_FALSE(SIM_getBroadcastResponseMsg(&node_id, raw_msg.data()));
+
+  /* Read completion of every device and repeat missing words */
+  for (node_id = 1U; node_id <= NUM_DEVICES; node_id++) {
+    auto response = node_request(node_id, msg::Msg(msg::REQ_PAGE_BUFFER_STATUS, msg::RES_NONE, 0U));
+    num_frames += 2U;
+    EXPECT_EQ(msg::convertMsgDataToU32(response.data), NUM_WORDS - NUM_LOST_WORDS_PER_DEVICE);
+
+    raw_msg = msg::convertMsgToBytes(msg::Msg(msg::REQ_PAGE_BUFFER_MISSING_WORDS, msg::RES_NONE, 0U));
+    SIM_sendNodeMsg(node_id, raw_msg.data());
+    SIM_updateDevices();
+    num_frames++;
+
+    std::vector<uint32_t> missing_word_idx_lst;
+    while (SIM_getNodeResponseMsg(node_id, raw_msg.data())) {
+      response = msg::convertBytesToMsg(raw_msg);
+      num_frames++;
+
+      for (auto bit_idx = 0U; bit_idx < 32U; bit_idx++) {
+        if ((response.data.at(bit_idx / 8U) & (1U << (bit_idx % 8U))) != 0U) {
+          missing_word_idx_lst.push_back(response.packet_id * 32U + bit_idx);
+        }
+      }
+    }
+
+    ASSERT_EQ(missing_word_idx_lst.size(), NUM_LOST_WORDS_PER_DEVICE);
+    for (const auto word_idx : missing_word_idx_lst) {
+      EXPECT_TRUE(is_word_lost(node_id, word_idx));
+      EXPECT_EQ(node_request(node_id, get_word_msg(word_idx)).result, msg::RES_OK);
+      num_frames += 2U;
+    }
+
+    response = node_request(node_id, msg::Msg(msg::REQ_PAGE_BUFFER_STATUS, msg::RES_NONE, 0U));
+    num_frames += 2U;
+    EXPECT_EQ(msg::convertMsgDataToU32(response.data), NUM_WORDS);
+
+    /* Spot check page buffer content */
+    auto read_request = msg::Msg(msg::REQ_PAGE_BUFFER_READ_WORD, msg::RES_NONE, 0U);
+    msg::convertU32ToMsgData(missing_word_idx_lst.front() * msg::MSG_DATA_SIZE_CAN, read_request.data);
+    response = node_request(node_id, read_request);
+    EXPECT_EQ(msg::convertMsgDataToU32(response.data), missing_word_idx_lst.front() * 0x01010101U);
+  }
+
+  /* Program page on all devices at once */
+  auto flash_request = msg::Msg(msg::REQ_PAGE_BUFFER_WRITE_TO_FLASH, msg::RES_NONE, 0U);
+  msg::convertU32ToMsgData(sim_device::FLASH_APP_FIRST_PAGE, flash_request.data);
+  raw_msg = msg::convertMsgToBytes(flash_request);
+  SIM_sendBroadcastMsg(raw_msg.data());
+  SIM_updateDevices();
+
+  uint32_t num_flash_responses = 0U;
+  while (SIM_getBroadcastResponseMsg(&node_id, raw_msg.data())) {
+    EXPECT_EQ(msg::convertBytesToMsg(raw_msg).result, msg::RES_OK);
+    num_flash_responses++;
+  }
+  EXPECT_EQ(num_flash_responses, NUM_DEVICES);
+
+  /* Bus load compared to word-by-word upload of every device (request + response per word) */
+  const uint32_t num_frames_node_upload = NUM_DEVICES * NUM_WORDS * 2U;
+  std::cout << "Broadcast upload: " << num_frames << " frames / node specific upload: " << num_frames_node_upload
+            << " frames (" << static_cast<uint32_t>(NUM_DEVICES) << " devices)" << std::endl;
+  EXPECT_LT(num_frames * 10U, num_frames_node_upload);
+
+  SIM_reset();
+}
@@ -0,0 +1,254 @@
+/**
+ * @file tests.cpp
+ * @author Martin Bauernschmitt (martin.bauernschmitt@francor.de)
+ * @brief Unit Tests of FRANCORs Frankly Bootloader - Request Dispatch
+ * @version 0.1
+ * @date 2022-11-26
+ *
+ * @copyright Copyright (c) 2022 - BSD-3-clause - FRANCOR e.V.
+ *
+ */
+
+#include <francor/frankly_test_utils.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <limits>
+
+using namespace franklyboot;              // NOLINT
+using namespace franklyboot::test_utils;  // NOLINT
+
+// Defines / Constexpr ------------------------------------------------------------------------------------------------
+
+/** \brief All built-in requests */
+constexpr std::array BUILTIN_REQUESTS = {
+    msg::REQ_PING,
+    msg::REQ_RESET_DEVICE,
+    msg::REQ_START_APP,
+    msg::REQ_DEV_INFO_BOOTLOADER_VERSION,
+    msg::REQ_DEV_INFO_BOOTLOADER_CRC,
+    msg::REQ_DEV_INFO_VID,
+    msg::REQ_DEV_INFO_PID,
+    msg::REQ_DEV_INFO_PRD,
+    msg::REQ_DEV_INFO_UID_1,
+    msg::REQ_DEV_INFO_UID_2,
+    msg::REQ_DEV_INFO_UID_3,
+    msg::REQ_DEV_INFO_UID_4,
+    msg::REQ_DEV_INFO_INVENTORY,
+    msg::REQ_DEV_INFO_CAPABILITIES,
+    msg::REQ_FLASH_INFO_START_ADDR,
+    msg::REQ_FLASH_INFO_PAGE_SIZE,
+    msg::REQ_FLASH_INFO_NUM_PAGES,
+    msg::REQ_APP_INFO_PAGE_IDX,
+    msg::REQ_APP_INFO_CRC_CALC,
+    msg::REQ_APP_INFO_CRC_STRD,
+    msg::REQ_FLASH_READ_WORD,
+    msg::REQ_FLASH_READ_BLOCK,
+    msg::REQ_FLASH_READ_PAGE_CRC,
+    msg::REQ_FLASH_READ_CRC,
+    msg::REQ_PAGE_BUFFER_CLEAR,
+    msg::REQ_PAGE_BUFFER_READ_WORD,
+    msg::REQ_PAGE_BUFFER_WRITE_WORD,
+    msg::REQ_PAGE_BUFFER_CALC_CRC,
+    msg::REQ_PAGE_BUFFER_WRITE_TO_FLASH,
+    msg::REQ_PAGE_BUFFER_STREAM_WORD,
+    msg::REQ_PAGE_BUFFER_WRITE_BLOCK,
+    msg::REQ_PAGE_BUFFER_MISSING_WORDS,
+    msg::REQ_PAGE_BUFFER_WRITE_WORD_AT,
+    msg::REQ_PAGE_BUFFER_WRITE_BLOCK_AT,
+    msg::REQ_PAGE_BUFFER_STATUS,
+    msg::REQ_PAGE_BUFFER_WRITE_COMPRESSED,
+    msg::REQ_PAGE_BUFFER_COPY_FROM_FLASH,
+    msg::REQ_PAGE_BUFFER_FILL,
+    msg::REQ_PAGE_BUFFER_COMMIT_STATUS,
+    msg::REQ_FLASH_WRITE_ERASE_PAGE,
+    msg::REQ_FLASH_WRITE_APP_CRC,
+    msg::REQ_FLASH_WRITE_ERASE_RANGE,
+    msg::REQ_FLASH_WRITE_ERASE_STATUS,
+};
+
+/**
+ * @brief Vendor request returning the inverted data
+ */
+struct VendorInvertRequest {
+  static constexpr uint16_t REQUEST = {0x8001U};
+
+  template <typename MSG>
+  static void processRequest(const MSG& request, MSG& response) {
+    for (auto idx = 0U; idx < request.data.size(); idx++) {
+      response.data[idx] = static_cast<uint8_t>(~request.data[idx]);
+    }
+
+    response.result = msg::RES_OK;
+  }
+};
+
+/**
+ * @brief Vendor request replacing the built-in REQ_DEV_INFO_VID
+ */
+struct VendorIDRequest {
+  static constexpr msg::RequestType REQUEST = {msg::REQ_DEV_INFO_VID};
+  static constexpr uint32_t VENDOR_ID = {0xCAFEBABEU};
+
+  template <typename MSG>
+  static void processRequest(const MSG& request, MSG& response) {
+    (void)request;
+    msg::convertU32ToMsgData(VENDOR_ID, response.data);
+    response.result = msg::RES_OK;
+  }
+};
+
+/** \brief Handler with the block write requests disabled (e.g. CAN only device) */
+using NoBlockHandler = TestHandler<16U, msg::MSG_DATA_SIZE_CAN, 0U, 0U, 1U,
+                                   DisableRequest<msg::REQ_PAGE_BUFFER_WRITE_BLOCK>,
+                                   DisableRequest<msg::REQ_PAGE_BUFFER_WRITE_BLOCK_AT>>;
+
+/** \brief Handler with vendor requests and a disabled request */
+using VendorHandler = TestHandler<16U, msg::MSG_DATA_SIZE_CAN, 0U, 0U, 1U, VendorInvertRequest, VendorIDRequest,
+                                  DisableRequest<msg::REQ_FLASH_READ_BLOCK>>;
+
+// Test Fixture Class -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Test class for the request dispatch
+ */
+class DispatchTests : public TestHelper {
+ public:
+  DispatchTests() = default;
+
+  [[nodiscard]] static bool isBuiltinRequest(const uint32_t request) {
+    return std::find(BUILTIN_REQUESTS.begin(), BUILTIN_REQUESTS.end(), request) != BUILTIN_REQUESTS.end();
+  }
+};
+
+// Tests --------------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Every request id is dispatched to its handler, all other ids are unknown (no hash false positives)
+ */
+TEST_F(DispatchTests, AllRequestIds) {  // NOLINT
+  for (uint32_t request = 0U; request <= std::numeric_limits<uint16_t>::max(); request++) {
+    const auto request_type = static_cast<msg::RequestType>(request);
+
+    /* Flash modifying requests are not executed, only the dispatch is of interest */
+    const bool flash_request = (request_type == msg::REQ_START_APP) || (request_type == msg::REQ_RESET_DEVICE) ||
+                               (request_type == msg::REQ_FLASH_WRITE_ERASE_RANGE);
+    if (flash_request) {
+      continue;
+    }
+
+    getHandle().processRequest(msg::Msg(request_type, msg::RES_NONE, 0U));
+
+    const auto response = getHandle().getResponse();
+    EXPECT_EQ(response.request, request_type);
+    if (isBuiltinRequest(request)) {
+      EXPECT_NE(response.result, msg::RES_ERR_UNKNOWN_REQ) << "Request 0x" << std::hex << request;
+    } else {
+      EXPECT_EQ(response.result, msg::RES_ERR_UNKNOWN_REQ) << "Request 0x" << std::hex << request;
+    }
+  }
+}
+
+TEST_F(DispatchTests, VendorRequest) {  // NOLINT
+  VendorHandler handler(getHWI());
+
+  auto request = msg::Msg(static_cast<msg::RequestType>(VendorInvertRequest::REQUEST), msg::RES_NONE, 7U);
+  request.data = {0x00, 0x0F, 0xF0, 0xFF};
+  handler.processRequest(request);
+
+  const auto response = handler.getResponse();
+  EXPECT_TRUE(handler.isResponseAvl());
+  EXPECT_EQ(response.request, VendorInvertRequest::REQUEST);
+  EXPECT_EQ(response.result, msg::RES_OK);
+  EXPECT_EQ(response.packet_id, 7U);
+  EXPECT_EQ(response.data, (msg::MsgData{0xFF, 0xF0, 0x0F, 0x00}));
+
+  /* Built-in requests are still available */
+  handler.processRequest(msg::Msg(msg::REQ_FLASH_INFO_PAGE_SIZE, msg::RES_NONE, 0U));
+  EXPECT_EQ(handler.getResponse().result, msg::RES_OK);
+  EXPECT_EQ(msg::convertMsgDataToU32(handler.getResponse().data), FLASH_PAGE_SIZE);
+}
+
+TEST_F(DispatchTests, ReplaceRequest) {  // NOLINT
+  VendorHandler handler(getHWI());
+  setVendorID(0x12345678U);
+
+  handler.processRequest(msg::Msg(msg::REQ_DEV_INFO_VID, msg::RES_NONE, 0U));
+  EXPECT_EQ(handler.getResponse().result, msg::RES_OK);
+  EXPECT_EQ(msg::convertMsgDataToU32(handler.getResponse().data), VendorIDRequest::VENDOR_ID);
+}
+
+TEST_F(DispatchTests, DisableRequest) {  // NOLINT
+  VendorHandler handler(getHWI());
+
+  auto request = msg::Msg(msg::REQ_FLASH_READ_BLOCK, msg::RES_NONE, 0U);
+  msg::convertU32ToMsgData(FLASH_START, request.data);
+  handler.processRequest(request);
+  EXPECT_TRUE(handler.isResponseAvl());
+  EXPECT_EQ(handler.getResponse().result, msg::RES_ERR_UNKNOWN_REQ);
+
+  /* Built-in request waits for the second frame (number of bytes) without response */
+  getHandle().processRequest(request);
+  EXPECT_FALSE(getHandle().isResponseAvl());
+
+  /* Feature of the disabled request is not reported, other features are unchanged */
+  const uint32_t features = VendorHandler::getCapabilities().at(msg::CAP_FEATURES);
+  const uint32_t features_builtin = getHandle().getCapabilities().at(msg::CAP_FEATURES);
+  EXPECT_NE(features_builtin & msg::FEATURE_FLASH_READ_BLOCK, 0U);
+  EXPECT_EQ(features, features_builtin & ~static_cast<uint32_t>(msg::FEATURE_FLASH_READ_BLOCK));
+}
+
+TEST_F(DispatchTests, DisableBlockRequest) {  // NOLINT
+  NoBlockHandler handler(getHWI());
+  const std::array<uint8_t, 8U> block = {0x01U, 0x02U, 0x03U, 0x04U, 0x05U, 0x06U, 0x07U, 0x08U};
+
+  /* Disabled requests are unknown on the block path too, the page buffer is untouched */
+  for (const auto request : {msg::REQ_PAGE_BUFFER_WRITE_BLOCK, msg::REQ_PAGE_BUFFER_WRITE_BLOCK_AT}) {
+    handler.processBlockRequest(msg::Msg(request, msg::RES_NONE, 0U), block.data(), block.size());
+    EXPECT_TRUE(handler.isResponseAvl());
+    EXPECT_EQ(handler.getResponse().request, request);
+    EXPECT_EQ(handler.getResponse().result, msg::RES_ERR_UNKNOWN_REQ);
+  }
+
+  EXPECT_EQ(handler.getPageBufferNumBytesFree(), FLASH_PAGE_SIZE);
+  EXPECT_EQ(handler.getByteFromPageBuffer(0U), std::numeric_limits<uint8_t>::max());
+
+  /* Built-in handler accepts the block */
+  getHandle().processBlockRequest(msg::Msg(msg::REQ_PAGE_BUFFER_WRITE_BLOCK, msg::RES_NONE, 0U), block.data(),
+                                  block.size());
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_OK);
+}
+
+/**
+ * @brief Measures the dispatch cost of cheap requests (the handler itself does nearly nothing)
+ */
+TEST_F(DispatchTests, DispatchBenchmark) {  // NOLINT
+  constexpr uint32_t NUM_REQUESTS = 1000000U;
+  constexpr std::array<msg::RequestType, 4U> REQUESTS = {msg::REQ_PING, msg::REQ_FLASH_INFO_PAGE_SIZE,
+                                                         msg::REQ_PAGE_BUFFER_READ_WORD,
+                                                         msg::REQ_FLASH_WRITE_ERASE_STATUS};
+  const auto unknown_request = static_cast<msg::RequestType>(0xDEADU);
+
+  uint32_t num_ok = 0U;
+  const auto start_known = std::chrono::steady_clock::now();
+  for (auto idx = 0U; idx < NUM_REQUESTS; idx++) {
+    getHandle().processRequest(msg::Msg(REQUESTS.at(idx % REQUESTS.size()), msg::RES_NONE, 0U));
+    num_ok += (getHandle().getResponse().result == msg::RES_OK) ? 1U : 0U;
+  }
+
+  const auto start_unknown = std::chrono::steady_clock::now();
+  for (auto idx = 0U; idx < NUM_REQUESTS; idx++) {
+    getHandle().processRequest(msg::Msg(unknown_request, msg::RES_NONE, 0U));
+  }
+  const auto end = std::chrono::steady_clock::now();
+
+  const auto time_known_ns = std::chrono::duration<double, std::nano>(start_unknown - start_known).count();
+  const auto time_unknown_ns = std::chrono::duration<double, std::nano>(end - start_unknown).count();
+  std::cout << "Dispatch: " << time_known_ns / NUM_REQUESTS << " ns/request, unknown request "
+            << time_unknown_ns / NUM_REQUESTS << " ns/request" << std::endl;
+
+  EXPECT_EQ(num_ok, NUM_REQUESTS);
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_ERR_UNKNOWN_REQ);
+}
@@ -12,6 +12,7 @@
 #include <francor/frankly_test_utils.h>
 
 #include <limits>
+#include <vector>
 
 using namespace franklyboot;              // NOLINT
 using namespace franklyboot::test_utils;  // NOLINT
@@ -94,4 +95,280 @@ TEST_F(FlashReadTests, readByteFromFlashInvldAddress2) {
   /* Check response */
   EXPECT_EQ(response.request, REQUEST);
   EXPECT_EQ(response.result, EXPECTED_RESPONSE);
-}
\ No newline at end of file
+}
+
+TEST_F(FlashReadTests, readCanFdWordFromFlash) {
+  constexpr msg::RequestType REQUEST = msg::REQ_FLASH_READ_WORD;
+  constexpr uint8_t PACKET_ID = 0;
+  constexpr msg::ResultType EXPECTED_RESPONSE = msg::RES_OK;
+  constexpr uint32_t READ_ADDRESS = 0x08000423U;
+
+  using CanFdHandler = TestHandler<16U, msg::MSG_DATA_SIZE_CAN_FD>;
+  CanFdHandler handler(getHWI());
+
+  /* Init flash with some values */
+  for (uint32_t byte_idx = 0U; byte_idx < FLASH_SIZE; byte_idx++) {
+    const auto flash_address = FLASH_START + byte_idx;
+    const auto value = static_cast<uint8_t>(byte_idx);
+    setByteInFlash(flash_address, value);
+  }
+
+  /* Create request */
+  CanFdHandler::Msg request_msg = CanFdHandler::Msg(REQUEST, msg::RES_NONE, PACKET_ID);
+  msg::convertU32ToMsgData(READ_ADDRESS, request_msg.data);
+
+  /* Process request and get response */
+  handler.processRequest(request_msg);
+  const auto response = handler.getResponse();
+
+  /* Check response -> complete payload is filled with flash data */
+  EXPECT_EQ(response.request, REQUEST);
+  EXPECT_EQ(response.result, EXPECTED_RESPONSE);
+  EXPECT_EQ(response.data.size(), msg::MSG_DATA_SIZE_CAN_FD);
+  for (auto idx = 0U; idx < response.data.size(); idx++) {
+    const auto expected_value = static_cast<uint8_t>((READ_ADDRESS - FLASH_START) + idx);
+    EXPECT_EQ(response.data.at(idx), expected_value);
+  }
+}
+
+TEST_F(FlashReadTests, readBlockFromFlash) {
+  constexpr msg::RequestType REQUEST = msg::REQ_FLASH_READ_BLOCK;
+  constexpr uint32_t READ_ADDRESS = 0x08000423U;
+  constexpr uint32_t READ_NUM_BYTES = 37U;
+  constexpr uint32_t EXPECTED_NUM_RESPONSES = 10U;
+
+  /* Init flash with some values */
+  for (uint32_t byte_idx = 0U; byte_idx < FLASH_SIZE; byte_idx++) {
+    const auto flash_address = FLASH_START + byte_idx;
+    const auto value = static_cast<uint8_t>(byte_idx);
+    setByteInFlash(flash_address, value);
+  }
+
+  /* First frame: start address -> no response */
+  msg::Msg request_msg = msg::Msg(REQUEST, msg::RES_NONE, 0U);
+  msg::convertU32ToMsgData(READ_ADDRESS, request_msg.data);
+  getHandle().processRequest(request_msg);
+  EXPECT_FALSE(getHandle().isResponseAvl());
+
+  /* Second frame: number of bytes -> stream of responses */
+  request_msg = msg::Msg(REQUEST, msg::RES_NONE, 1U);
+  msg::convertU32ToMsgData(READ_NUM_BYTES, request_msg.data);
+  getHandle().processRequest(request_msg);
+
+  uint32_t num_responses = 0U;
+  uint32_t byte_idx = 0U;
+  while (getHandle().isResponseAvl()) {
+    const auto response = getHandle().getResponse();
+    EXPECT_EQ(response.request, REQUEST);
+    EXPECT_EQ(response.result, msg::RES_OK);
+    EXPECT_EQ(response.packet_id, num_responses);
+
+    for (auto idx = 0U; (idx < response.data.size()) && (byte_idx < READ_NUM_BYTES); idx++) {
+      const auto expected_value = static_cast<uint8_t>((READ_ADDRESS - FLASH_START) + byte_idx);
+      EXPECT_EQ(response.data.at(idx), expected_value);
+      byte_idx++;
+    }
+
+    num_responses++;
+    getHandle().processNextResponse();
+  }
+
+  EXPECT_EQ(num_responses, EXPECTED_NUM_RESPONSES);
+  EXPECT_EQ(byte_idx, READ_NUM_BYTES);
+}
+
+TEST_F(FlashReadTests, readBlockFromFlashAborted) {
+  constexpr msg::RequestType REQUEST = msg::REQ_FLASH_READ_BLOCK;
+
+  msg::Msg request_msg = msg::Msg(REQUEST, msg::RES_NONE, 0U);
+  msg::convertU32ToMsgData(FLASH_START, request_msg.data);
+  getHandle().processRequest(request_msg);
+
+  request_msg = msg::Msg(REQUEST, msg::RES_NONE, 1U);
+  msg::convertU32ToMsgData(FLASH_PAGE_SIZE, request_msg.data);
+  getHandle().processRequest(request_msg);
+  EXPECT_TRUE(getHandle().isResponseAvl());
+
+  /* New request aborts pending responses */
+  getHandle().processRequest(msg::Msg(msg::REQ_PING, msg::RES_NONE, 0U));
+  EXPECT_TRUE(getHandle().isResponseAvl());
+  EXPECT_EQ(getHandle().getResponse().request, msg::REQ_PING);
+
+  getHandle().processNextResponse();
+  EXPECT_FALSE(getHandle().isResponseAvl());
+}
+
+TEST_F(FlashReadTests, readBlockFromFlashInvldArgs) {
+  constexpr msg::RequestType REQUEST = msg::REQ_FLASH_READ_BLOCK;
+
+  /* Number of bytes without start address */
+  msg::Msg request_msg = msg::Msg(REQUEST, msg::RES_NONE, 1U);
+  msg::convertU32ToMsgData(4U, request_msg.data);
+  getHandle().processRequest(request_msg);
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_ERR_INVLD_ARG);
+
+  /* Block exceeds flash */
+  request_msg = msg::Msg(REQUEST, msg::RES_NONE, 0U);
+  msg::convertU32ToMsgData(FLASH_START + FLASH_SIZE - 3U, request_msg.data);
+  getHandle().processRequest(request_msg);
+
+  request_msg = msg::Msg(REQUEST, msg::RES_NONE, 1U);
+  msg::convertU32ToMsgData(4U, request_msg.data);
+  getHandle().processRequest(request_msg);
+
+  EXPECT_TRUE(getHandle().isResponseAvl());
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_ERR_INVLD_ARG);
+
+  getHandle().processNextResponse();
+  EXPECT_FALSE(getHandle().isResponseAvl());
+}
+
+TEST_F(FlashReadTests, readCanFdBlockFromFlash) {
+  constexpr msg::RequestType REQUEST = msg::REQ_FLASH_READ_BLOCK;
+  constexpr uint32_t READ_ADDRESS = FLASH_START + FLASH_PAGE_SIZE;
+  constexpr uint32_t READ_NUM_BYTES = FLASH_PAGE_SIZE;
+
+  using CanFdHandler = TestHandler<16U, msg::MSG_DATA_SIZE_CAN_FD>;
+  CanFdHandler handler(getHWI());
+
+  /* Init flash with some values */
+  for (uint32_t byte_idx = 0U; byte_idx < FLASH_SIZE; byte_idx++) {
+    setByteInFlash(FLASH_START + byte_idx, static_cast<uint8_t>(byte_idx * 3U));
+  }
+
+  /* Both arguments fit into one CAN-FD frame */
+  CanFdHandler::Msg request_msg = CanFdHandler::Msg(REQUEST, msg::RES_NONE, 0U);
+  msg::convertU32ToMsgData(READ_ADDRESS, request_msg.data);
+  msg::convertU32ToMsgData(READ_NUM_BYTES, request_msg.data, sizeof(uint32_t));
+  handler.processRequest(request_msg);
+
+  std::vector<uint8_t> data;
+  while (handler.isResponseAvl()) {
+    const auto response = handler.getResponse();
+    EXPECT_EQ(response.result, msg::RES_OK);
+    data.insert(data.end(), response.data.begin(), response.data.end());
+    handler.processNextResponse();
+  }
+
+  /* 1024 bytes -> 18 frames with 60 bytes, last frame is padded */
+  EXPECT_EQ(data.size(), 18U * msg::MSG_DATA_SIZE_CAN_FD);
+  for (auto idx = 0U; idx < READ_NUM_BYTES; idx++) {
+    EXPECT_EQ(data.at(idx), static_cast<uint8_t>((READ_ADDRESS - FLASH_START + idx) * 3U));
+  }
+}
+
+TEST_F(FlashReadTests, readPageCrc) {
+  constexpr msg::RequestType REQUEST = msg::REQ_FLASH_READ_PAGE_CRC;
+  constexpr uint8_t PACKET_ID = 3U;
+  constexpr uint32_t PAGE_IDX = 5U;
+  constexpr uint32_t EXPECTED_VALUE = 0xDEADBEEFU;
+
+  setCRCResult(EXPECTED_VALUE);
+
+  /* Number of pages 0 -> single page */
+  msg::Msg request_msg = msg::Msg(REQUEST, msg::RES_NONE, PACKET_ID);
+  request_msg.data = {PAGE_IDX, 0U, 0U, 0U};
+
+  getHandle().processRequest(request_msg);
+  const auto response = getHandle().getResponse();
+
+  EXPECT_EQ(response.request, REQUEST);
+  EXPECT_EQ(response.result, msg::RES_OK);
+  EXPECT_EQ(response.packet_id, PACKET_ID);
+  EXPECT_EQ(msg::convertMsgDataToU32(response.data), EXPECTED_VALUE);
+  EXPECT_EQ(getCalcCRCSrcAddress(), FLASH_START + PAGE_IDX * FLASH_PAGE_SIZE);
+  EXPECT_EQ(getCalcCRCNumBytes(), FLASH_PAGE_SIZE);
+}
+
+TEST_F(FlashReadTests, readPageRunCrc) {
+  constexpr msg::RequestType REQUEST = msg::REQ_FLASH_READ_PAGE_CRC;
+  constexpr uint32_t PAGE_IDX = FLASH_APP_FIRST_PAGE;
+  constexpr uint32_t NUM_PAGES = FLASH_NUM_PAGES - FLASH_APP_FIRST_PAGE;
+
+  msg::Msg request_msg = msg::Msg(REQUEST, msg::RES_NONE, 0U);
+  request_msg.data = {PAGE_IDX, 0U, NUM_PAGES, 0U};
+
+  getHandle().processRequest(request_msg);
+  const auto response = getHandle().getResponse();
+
+  EXPECT_EQ(response.result, msg::RES_OK);
+  EXPECT_EQ(getCalcCRCSrcAddress(), FLASH_START + PAGE_IDX * FLASH_PAGE_SIZE);
+  EXPECT_EQ(getCalcCRCNumBytes(), NUM_PAGES * FLASH_PAGE_SIZE);
+}
+
+TEST_F(FlashReadTests, readPageCrcInvldArg) {
+  constexpr msg::RequestType REQUEST = msg::REQ_FLASH_READ_PAGE_CRC;
+
+  /* Page index out of range */
+  msg::Msg request_msg = msg::Msg(REQUEST, msg::RES_NONE, 0U);
+  request_msg.data = {FLASH_NUM_PAGES, 0U, 1U, 0U};
+  getHandle().processRequest(request_msg);
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_ERR_INVLD_ARG);
+
+  /* Run of pages exceeds flash */
+  request_msg.data = {FLASH_NUM_PAGES - 1U, 0U, 2U, 0U};
+  getHandle().processRequest(request_msg);
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_ERR_INVLD_ARG);
+}
+
+TEST_F(FlashReadTests, readRangeCrc) {
+  constexpr msg::RequestType REQUEST = msg::REQ_FLASH_READ_CRC;
+  constexpr uint32_t SRC_ADDRESS = FLASH_START + 0x123U;
+  constexpr uint32_t NUM_BYTES = 0x45U;
+  constexpr uint32_t EXPECTED_VALUE = 0x12345678U;
+
+  setCRCResult(EXPECTED_VALUE);
+
+  /* First frame: start address -> no response */
+  msg::Msg request_msg = msg::Msg(REQUEST, msg::RES_NONE, 0U);
+  msg::convertU32ToMsgData(SRC_ADDRESS, request_msg.data);
+  getHandle().processRequest(request_msg);
+  EXPECT_FALSE(getHandle().isResponseAvl());
+
+  /* Second frame: number of bytes */
+  request_msg = msg::Msg(REQUEST, msg::RES_NONE, 1U);
+  msg::convertU32ToMsgData(NUM_BYTES, request_msg.data);
+  getHandle().processRequest(request_msg);
+  const auto response = getHandle().getResponse();
+
+  EXPECT_TRUE(getHandle().isResponseAvl());
+  EXPECT_EQ(response.request, REQUEST);
+  EXPECT_EQ(response.result, msg::RES_OK);
+  EXPECT_EQ(msg::convertMsgDataToU32(response.data), EXPECTED_VALUE);
+  EXPECT_EQ(getCalcCRCSrcAddress(), SRC_ADDRESS);
+  EXPECT_EQ(getCalcCRCNumBytes(), NUM_BYTES);
+}
+
+TEST_F(FlashReadTests, readRangeCrcInvldArgs) {
+  constexpr msg::RequestType REQUEST = msg::REQ_FLASH_READ_CRC;
+
+  /* Range exceeds flash */
+  msg::Msg request_msg = msg::Msg(REQUEST, msg::RES_NONE, 0U);
+  msg::convertU32ToMsgData(FLASH_START + FLASH_SIZE - 4U, request_msg.data);
+  getHandle().processRequest(request_msg);
+
+  request_msg = msg::Msg(REQUEST, msg::RES_NONE, 1U);
+  msg::convertU32ToMsgData(5U, request_msg.data);
+  getHandle().processRequest(request_msg);
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_ERR_INVLD_ARG);
+
+  /* Start address below flash */
+  request_msg = msg::Msg(REQUEST, msg::RES_NONE, 0U);
+  msg::convertU32ToMsgData(FLASH_START - 1U, request_msg.data);
+  getHandle().processRequest(request_msg);
+
+  request_msg = msg::Msg(REQUEST, msg::RES_NONE, 1U);
+  msg::convertU32ToMsgData(4U, request_msg.data);
+  getHandle().processRequest(request_msg);
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_ERR_INVLD_ARG);
+
+  /* Start address was received for a different request */
+  request_msg = msg::Msg(msg::REQ_FLASH_READ_BLOCK, msg::RES_NONE, 0U);
+  msg::convertU32ToMsgData(FLASH_START, request_msg.data);
+  getHandle().processRequest(request_msg);
+
+  request_msg = msg::Msg(REQUEST, msg::RES_NONE, 1U);
+  msg::convertU32ToMsgData(4U, request_msg.data);
+  getHandle().processRequest(request_msg);
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_ERR_INVLD_ARG);
+}
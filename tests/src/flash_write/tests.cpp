@@ -11,11 +11,43 @@
 
 #include <francor/frankly_test_utils.h>
 
+#include <array>
 #include <limits>
 
 using namespace franklyboot;              // NOLINT
 using namespace franklyboot::test_utils;  // NOLINT
 
+// Hardware Interface -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief HWI policy without sector erase (like hwi::FreeFunctions), the erase range falls back to eraseFlashPage()
+ */
+class PageEraseHWI : private TestHWI {
+ public:
+  using TestHWI::TestHWI;
+
+  using TestHWI::calculateCRC;
+  using TestHWI::eraseFlashPage;
+  using TestHWI::getProductID;
+  using TestHWI::getProductionDate;
+  using TestHWI::getUniqueIDWord;
+  using TestHWI::getVendorID;
+  using TestHWI::readByteFromFlash;
+  using TestHWI::resetDevice;
+  using TestHWI::startApp;
+  using TestHWI::writeDataBufferToFlash;
+};
+
+// Defines / Constexpr ------------------------------------------------------------------------------------------------
+
+/** \brief Handler erasing page by page */
+using PageEraseHandler = Handler<FLASH_START, FLASH_APP_FIRST_PAGE, FLASH_SIZE, FLASH_PAGE_SIZE, 16U,
+                                 msg::MSG_DATA_SIZE_CAN, 0U, 0U, 1U, PageEraseHWI>;
+
+static_assert(hwi::HasSectorErase<TestHWI>::value, "TestHWI has to be detected with sector erase!");
+static_assert(!hwi::HasSectorErase<PageEraseHWI>::value, "PageEraseHWI has to be detected without sector erase!");
+static_assert(!hwi::HasSectorErase<hwi::FreeFunctions>::value, "Free functions have to be detected without sectors!");
+
 // Test Fixture Class -------------------------------------------------------------------------------------------------
 
 /**
@@ -182,6 +214,9 @@ TEST_F(FlashWrite, WriteCRCEraseError) {
   setErasePageResult(false);
   setWriteToFlashResult(true);
 
+  /* CRC of a previous update stored -> page has to be erased */
+  setByteInFlash(getHandle().getFlashAppCRCValueAddress(), 0x00U);
+
   /* Create request */
   msg::Msg request_msg = msg::Msg(REQUEST, msg::RES_NONE, PACKET_ID);
   msg::convertU32ToMsgData(CRC_VALUE, request_msg.data);
@@ -215,4 +250,206 @@ TEST_F(FlashWrite, WriteCRCFlashError) {
   /* Check response */
   EXPECT_EQ(response.request, REQUEST);
   EXPECT_EQ(response.result, EXPECTED_RESPONSE);
-}
\ No newline at end of file
+}
+
+TEST_F(FlashWrite, EraseRange) {
+  constexpr msg::RequestType REQUEST = msg::REQ_FLASH_WRITE_ERASE_RANGE;
+  constexpr uint8_t PACKET_ID = 5;
+  constexpr uint32_t NUM_PAGES = FLASH_NUM_PAGES - FLASH_APP_FIRST_PAGE;
+
+  setErasePageResult(true);
+
+  /* Init flash with some values */
+  for (uint32_t byte_idx = 0U; byte_idx < FLASH_SIZE; byte_idx++) {
+    setByteInFlash(FLASH_START + byte_idx, static_cast<uint8_t>(byte_idx));
+  }
+
+  /* Erase complete app area (number of pages 0) */
+  msg::Msg request_msg = msg::Msg(REQUEST, msg::RES_NONE, PACKET_ID);
+  request_msg.data = {FLASH_APP_FIRST_PAGE, 0U, 0U, 0U};
+  getHandle().processRequest(request_msg);
+
+  /* Response is sent before the erase starts */
+  auto response = getHandle().getResponse();
+  EXPECT_EQ(response.request, REQUEST);
+  EXPECT_EQ(response.result, msg::RES_OK);
+  EXPECT_EQ(response.packet_id, PACKET_ID);
+  EXPECT_EQ(response.data, (msg::MsgData{FLASH_APP_FIRST_PAGE, 0U, NUM_PAGES, 0U}));
+  EXPECT_EQ(false, erasePageCalled());
+
+  /* One page per cycle, progress is reported while polling */
+  for (uint32_t page_idx = 0U; page_idx < NUM_PAGES; page_idx++) {
+    getHandle().processRequest(msg::Msg(msg::REQ_FLASH_WRITE_ERASE_STATUS, msg::RES_NONE, 0U));
+    response = getHandle().getResponse();
+    EXPECT_EQ(response.result, msg::RES_BUSY);
+    EXPECT_EQ(response.data, (msg::MsgData{static_cast<uint8_t>(page_idx), 0U, NUM_PAGES, 0U}));
+
+    getHandle().processBufferedCmds();
+  }
+
+  EXPECT_EQ(getEraseNumCalls(), NUM_PAGES);
+
+  getHandle().processRequest(msg::Msg(msg::REQ_FLASH_WRITE_ERASE_STATUS, msg::RES_NONE, 0U));
+  response = getHandle().getResponse();
+  EXPECT_EQ(response.result, msg::RES_OK);
+  EXPECT_EQ(response.data, (msg::MsgData{NUM_PAGES, 0U, NUM_PAGES, 0U}));
+
+  /* Check flash, bootloader is untouched */
+  for (uint32_t byte_idx = 0U; byte_idx < FLASH_SIZE; byte_idx++) {
+    const bool app_area = (byte_idx >= (FLASH_APP_FIRST_PAGE * FLASH_PAGE_SIZE));
+    const auto expected_value = app_area ? std::numeric_limits<uint8_t>::max() : static_cast<uint8_t>(byte_idx);
+    EXPECT_EQ(readByteFromFlash(FLASH_START + byte_idx), expected_value);
+  }
+
+  /* Further cycles do nothing */
+  getHandle().processBufferedCmds();
+  EXPECT_EQ(getEraseNumCalls(), NUM_PAGES);
+}
+
+TEST_F(FlashWrite, EraseRangeSectors) {
+  constexpr uint32_t SECTOR_NUM_PAGES = 4U;
+  constexpr uint32_t PAGE_FIRST = 3U;
+  constexpr uint32_t NUM_PAGES = 10U;
+
+  setErasePageResult(true);
+  setEraseSectorNumPages(SECTOR_NUM_PAGES);
+
+  msg::Msg request_msg = msg::Msg(msg::REQ_FLASH_WRITE_ERASE_RANGE, msg::RES_NONE, 0U);
+  request_msg.data = {PAGE_FIRST, 0U, NUM_PAGES, 0U};
+  getHandle().processRequest(request_msg);
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_OK);
+
+  /* Pages 3 | sector 4-7 | sector 8-11 | page 12 */
+  for (auto idx = 0U; idx < 8U; idx++) {
+    getHandle().processBufferedCmds();
+  }
+
+  EXPECT_EQ(getEraseNumCalls(), 4U);
+
+  getHandle().processRequest(msg::Msg(msg::REQ_FLASH_WRITE_ERASE_STATUS, msg::RES_NONE, 0U));
+  const auto response = getHandle().getResponse();
+  EXPECT_EQ(response.result, msg::RES_OK);
+  EXPECT_EQ(response.data, (msg::MsgData{NUM_PAGES, 0U, NUM_PAGES, 0U}));
+}
+
+TEST_F(FlashWrite, EraseRangePageFallback) {
+  constexpr uint32_t PAGE_FIRST = 3U;
+  constexpr uint32_t NUM_PAGES = 3U;
+
+  PageEraseHandler handler(PageEraseHWI(*this));
+  setErasePageResult(true);
+  setEraseSectorNumPages(NUM_PAGES);
+
+  for (uint32_t byte_idx = 0U; byte_idx < FLASH_SIZE; byte_idx++) {
+    setByteInFlash(FLASH_START + byte_idx, 0U);
+  }
+
+  msg::Msg request_msg = msg::Msg(msg::REQ_FLASH_WRITE_ERASE_RANGE, msg::RES_NONE, 0U);
+  request_msg.data = {PAGE_FIRST, 0U, NUM_PAGES, 0U};
+  handler.processRequest(request_msg);
+  EXPECT_EQ(handler.getResponse().result, msg::RES_OK);
+
+  /* One eraseFlashPage() per cycle, the sector erase of the simulation is not used */
+  for (uint32_t page_idx = 0U; page_idx < NUM_PAGES; page_idx++) {
+    handler.processRequest(msg::Msg(msg::REQ_FLASH_WRITE_ERASE_STATUS, msg::RES_NONE, 0U));
+    EXPECT_EQ(handler.getResponse().result, msg::RES_BUSY);
+    EXPECT_EQ(handler.getResponse().data, (msg::MsgData{static_cast<uint8_t>(page_idx), 0U, NUM_PAGES, 0U}));
+
+    handler.processBufferedCmds();
+  }
+
+  EXPECT_EQ(getEraseNumCalls(), 0U);
+  EXPECT_TRUE(erasePageCalled());
+
+  handler.processRequest(msg::Msg(msg::REQ_FLASH_WRITE_ERASE_STATUS, msg::RES_NONE, 0U));
+  EXPECT_EQ(handler.getResponse().result, msg::RES_OK);
+  EXPECT_EQ(handler.getResponse().data, (msg::MsgData{NUM_PAGES, 0U, NUM_PAGES, 0U}));
+
+  for (uint32_t byte_idx = 0U; byte_idx < FLASH_SIZE; byte_idx++) {
+    const uint32_t page_id = byte_idx / FLASH_PAGE_SIZE;
+    const bool erased = (page_id >= PAGE_FIRST) && (page_id < (PAGE_FIRST + NUM_PAGES));
+    EXPECT_EQ(readByteFromFlash(FLASH_START + byte_idx), erased ? std::numeric_limits<uint8_t>::max() : 0U);
+  }
+}
+
+TEST_F(FlashWrite, EraseRangeInvldArgs) {
+  constexpr msg::RequestType REQUEST = msg::REQ_FLASH_WRITE_ERASE_RANGE;
+
+  setErasePageResult(true);
+
+  /* Bootloader area, first page out of range, range exceeding the flash */
+  const std::array<msg::MsgData, 3U> invalid_args = {
+      msg::MsgData{FLASH_APP_FIRST_PAGE - 1U, 0U, 2U, 0U},
+      msg::MsgData{FLASH_NUM_PAGES, 0U, 0U, 0U},
+      msg::MsgData{FLASH_APP_FIRST_PAGE, 0U, FLASH_NUM_PAGES, 0U},
+  };
+
+  for (const auto& data : invalid_args) {
+    msg::Msg request_msg = msg::Msg(REQUEST, msg::RES_NONE, 0U);
+    request_msg.data = data;
+    getHandle().processRequest(request_msg);
+    EXPECT_EQ(getHandle().getResponse().result, msg::RES_ERR_INVLD_ARG);
+  }
+
+  getHandle().processBufferedCmds();
+  EXPECT_EQ(getEraseNumCalls(), 0U);
+  EXPECT_EQ(false, erasePageCalled());
+}
+
+TEST_F(FlashWrite, EraseRangeBusy) {
+  setErasePageResult(true);
+  setWriteToFlashResult(true);
+
+  msg::Msg request_msg = msg::Msg(msg::REQ_FLASH_WRITE_ERASE_RANGE, msg::RES_NONE, 0U);
+  request_msg.data = {FLASH_APP_FIRST_PAGE, 0U, 2U, 0U};
+  getHandle().processRequest(request_msg);
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_OK);
+
+  /* Requests modifying the flash are rejected while erasing */
+  const std::array<msg::RequestType, 5U> rejected_requests = {
+      msg::REQ_START_APP, msg::REQ_PAGE_BUFFER_WRITE_TO_FLASH, msg::REQ_FLASH_WRITE_ERASE_PAGE,
+      msg::REQ_FLASH_WRITE_APP_CRC, msg::REQ_FLASH_WRITE_ERASE_RANGE};
+
+  for (const auto request : rejected_requests) {
+    getHandle().processRequest(request_msg.request == request ? request_msg : msg::Msg(request, msg::RES_NONE, 0U));
+    EXPECT_EQ(getHandle().getResponse().request, request);
+    EXPECT_EQ(getHandle().getResponse().result, msg::RES_BUSY);
+  }
+
+  EXPECT_EQ(false, erasePageCalled());
+  EXPECT_EQ(false, writeToFlashCalled());
+  EXPECT_EQ(false, startAppCalled());
+
+  /* Page buffer can be filled in parallel */
+  getHandle().processRequest(msg::Msg(msg::REQ_PAGE_BUFFER_CLEAR, msg::RES_NONE, 0U));
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_OK);
+
+  getHandle().processBufferedCmds();
+  getHandle().processBufferedCmds();
+
+  getHandle().processRequest(request_msg);
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_OK);
+}
+
+TEST_F(FlashWrite, EraseRangeHWError) {
+  setErasePageResult(false);
+
+  msg::Msg request_msg = msg::Msg(msg::REQ_FLASH_WRITE_ERASE_RANGE, msg::RES_NONE, 0U);
+  request_msg.data = {FLASH_APP_FIRST_PAGE, 0U, 0U, 0U};
+  getHandle().processRequest(request_msg);
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_OK);
+
+  /* Erase stops at the first error */
+  getHandle().processBufferedCmds();
+  getHandle().processBufferedCmds();
+  EXPECT_EQ(getEraseNumCalls(), 1U);
+
+  getHandle().processRequest(msg::Msg(msg::REQ_FLASH_WRITE_ERASE_STATUS, msg::RES_NONE, 0U));
+  const auto response = getHandle().getResponse();
+  EXPECT_EQ(response.result, msg::RES_ERR);
+  EXPECT_EQ(response.data, (msg::MsgData{0U, 0U, FLASH_NUM_PAGES - FLASH_APP_FIRST_PAGE, 0U}));
+
+  /* Flash is writable again after the error */
+  getHandle().processRequest(msg::Msg(msg::REQ_FLASH_WRITE_ERASE_PAGE, msg::RES_NONE, 0U));
+  EXPECT_NE(getHandle().getResponse().result, msg::RES_BUSY);
+}
@@ -12,6 +12,7 @@
 #include <francor/frankly_test_utils.h>
 
 #include <limits>
+#include <vector>
 
 using namespace franklyboot;              // NOLINT
 using namespace franklyboot::test_utils;  // NOLINT
@@ -177,4 +178,87 @@ TEST_F(GeneralRequestTests, ReqStartAppCRCValid) {
 
   getHandle().processBufferedCmds();
   EXPECT_EQ(this->startAppCalled(), true);
-}
\ No newline at end of file
+}
+
+// Request Queue Tests ------------------------------------------------------------------------------------------------
+
+/** \brief Handler with request queue and response ring */
+using QueuedHandler = TestHandler<16U, msg::MSG_DATA_SIZE_CAN, 4U>;
+
+TEST_F(GeneralRequestTests, QueuedRequestsInOrder) {
+  QueuedHandler handler(getHWI());
+
+  /* Requests received while main loop is busy */
+  for (uint8_t word_idx = 0U; word_idx < handler.getQueueSize(); word_idx++) {
+    auto request = msg::Msg(msg::REQ_PAGE_BUFFER_WRITE_WORD, msg::RES_NONE, word_idx);
+    request.data = {word_idx, word_idx, word_idx, word_idx};
+    EXPECT_TRUE(handler.pushRequest(request));
+  }
+
+  /* Queue is full */
+  EXPECT_FALSE(handler.pushRequest(msg::Msg(msg::REQ_PING, msg::RES_NONE, 0U)));
+
+  handler.processRequestQueue();
+
+  msg::Msg response;
+  for (uint8_t word_idx = 0U; word_idx < handler.getQueueSize(); word_idx++) {
+    ASSERT_TRUE(handler.popResponse(response));
+    EXPECT_EQ(response.request, msg::REQ_PAGE_BUFFER_WRITE_WORD);
+    EXPECT_EQ(response.result, msg::RES_OK);
+    EXPECT_EQ(response.packet_id, word_idx);
+  }
+  EXPECT_FALSE(handler.popResponse(response));
+
+  for (auto idx = 0U; idx < (handler.getQueueSize() * 4U); idx++) {
+    EXPECT_EQ(handler.getByteFromPageBuffer(idx), idx / 4U);
+  }
+}
+
+TEST_F(GeneralRequestTests, QueuedMultiFrameResponse) {
+  QueuedHandler handler(getHWI());
+
+  EXPECT_TRUE(handler.pushRequest(msg::Msg(msg::REQ_DEV_INFO_INVENTORY, msg::RES_NONE, 0U)));
+  EXPECT_TRUE(handler.pushRequest(msg::Msg(msg::REQ_PING, msg::RES_NONE, 0U)));
+
+  /* Response ring is smaller than the number of inventory frames -> drained in several steps */
+  std::vector<msg::Msg> response_lst;
+  for (auto cycle = 0U; cycle < 10U; cycle++) {
+    handler.processRequestQueue();
+
+    msg::Msg response;
+    while (handler.popResponse(response)) {
+      response_lst.push_back(response);
+    }
+  }
+
+  ASSERT_EQ(response_lst.size(), msg::INV_NUM_FIELDS + 1U);
+  for (auto idx = 0U; idx < msg::INV_NUM_FIELDS; idx++) {
+    EXPECT_EQ(response_lst.at(idx).request, msg::REQ_DEV_INFO_INVENTORY);
+    EXPECT_EQ(response_lst.at(idx).packet_id, idx);
+  }
+  EXPECT_EQ(response_lst.back().request, msg::REQ_PING);
+}
+
+TEST_F(GeneralRequestTests, QueuedBufferedCommand) {
+  QueuedHandler handler(getHWI());
+
+  auto request = msg::Msg(msg::REQ_START_APP, msg::RES_NONE, 0U);
+  request.data = {0xFF, 0xFF, 0xFF, 0xFF};
+  EXPECT_TRUE(handler.pushRequest(request));
+  EXPECT_TRUE(handler.pushRequest(msg::Msg(msg::REQ_PING, msg::RES_NONE, 0U)));
+
+  /* Processing stops after the request buffering a command */
+  handler.processRequestQueue();
+
+  msg::Msg response;
+  ASSERT_TRUE(handler.popResponse(response));
+  EXPECT_EQ(response.request, msg::REQ_START_APP);
+  EXPECT_FALSE(handler.popResponse(response));
+
+  handler.processBufferedCmds();
+  EXPECT_TRUE(this->startAppCalled());
+
+  handler.processRequestQueue();
+  ASSERT_TRUE(handler.popResponse(response));
+  EXPECT_EQ(response.request, msg::REQ_PING);
+}
@@ -0,0 +1,321 @@
+/**
+ * @file tests.cpp
+ * @author Martin Bauernschmitt (martin.bauernschmitt@francor.de)
+ * @brief Unit Tests of FRANCORs Frankly Bootloader - ISO-TP Segmentation Layer
+ * @version 0.1
+ * @date 2022-11-26
+ *
+ * @copyright Copyright (c) 2022 - BSD-3-clause - FRANCOR e.V.
+ *
+ */
+
+#include <francor/franklyboot/device_sim_api.h>
+#include <francor/franklyboot/isotp.h>
+#include <francor/franklyboot/msg.h>
+#include <gtest/gtest.h>
+
+#include <iostream>
+#include <limits>
+#include <vector>
+
+using namespace franklyboot;  // NOLINT
+
+// Defines / Constexpr ------------------------------------------------------------------------------------------------
+
+constexpr uint8_t NODE_ID = 1U;
+constexpr uint32_t MAX_MSG_SIZE = 4096U;
+
+/** \brief Simulated transmission time of a classic CAN frame with 8 bytes @ 500 kBit/s (incl. stuff bits) */
+constexpr uint32_t SIM_FRAME_TIME_US = 250U;
+
+/** \brief Simulated turnaround time between host and device (e.g. USB-CAN adapter) */
+constexpr uint32_t SIM_TURNAROUND_TIME_US = 1000U;
+
+// Helper Functions ---------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Transfers a message through sender and receiver and returns the number of transmitted frames
+ */
+template <uint32_t MAX_SIZE>
+uint32_t transferMsg(isotp::Sender& sender, isotp::Receiver<MAX_SIZE>& receiver, const std::vector<uint8_t>& data) {
+  uint32_t num_frames = 0U;
+
+  EXPECT_TRUE(sender.startTransfer(data.data(), static_cast<uint32_t>(data.size())));
+
+  isotp::Frame frame;
+  isotp::Frame flow_control;
+  while (sender.isTransferActive()) {
+    while (sender.getNextFrame(frame)) {
+      num_frames++;
+      if (receiver.processFrame(frame, flow_control)) {
+        num_frames++;
+        sender.processFlowControl(flow_control);
+      }
+    }
+  }
+
+  return num_frames;
+}
+
+// Tests --------------------------------------------------------------------------------------------------------------
+
+TEST(IsoTpTests, SingleFrame) {  // NOLINT
+  isotp::Sender sender;
+  isotp::Receiver<MAX_MSG_SIZE> receiver;
+
+  const std::vector<uint8_t> data = {1U, 2U, 3U, 4U, 5U};
+  const uint32_t num_frames = transferMsg(sender, receiver, data);
+
+  EXPECT_EQ(num_frames, 1U);
+  ASSERT_TRUE(receiver.isMsgAvl());
+  ASSERT_EQ(receiver.getMsgSize(), data.size());
+  for (auto idx = 0U; idx < data.size(); idx++) {
+    EXPECT_EQ(receiver.getMsgData()[idx], data.at(idx));
+  }
+}
+
+TEST(IsoTpTests, SegmentedMsgWithBlockSize) {  // NOLINT
+  constexpr uint8_t BLOCK_SIZE = 4U;
+  constexpr uint32_t MSG_SIZE = 1000U;
+
+  isotp::Sender sender;
+  isotp::Receiver<MAX_MSG_SIZE> receiver(BLOCK_SIZE, 0xF5U);
+
+  std::vector<uint8_t> data(MSG_SIZE);
+  for (auto& entry : data) {
+    entry = rand() % std::numeric_limits<uint8_t>::max();
+  }
+
+  const uint32_t num_frames = transferMsg(sender, receiver, data);
+
+  /* First frame + consecutive frames + one flow control for every block */
+  constexpr uint32_t NUM_CF = (MSG_SIZE - isotp::FIRST_FRAME_DATA_SIZE + 6U) / isotp::CONSECUTIVE_FRAME_DATA_SIZE;
+  constexpr uint32_t NUM_FC = 1U + (NUM_CF - 1U) / BLOCK_SIZE;
+  EXPECT_EQ(num_frames, 1U + NUM_CF + NUM_FC);
+  EXPECT_EQ(sender.getSeparationTimeUs(), 500U);
+
+  ASSERT_TRUE(receiver.isMsgAvl());
+  ASSERT_EQ(receiver.getMsgSize(), data.size());
+  for (auto idx = 0U; idx < data.size(); idx++) {
+    EXPECT_EQ(receiver.getMsgData()[idx], data.at(idx));
+  }
+}
+
+TEST(IsoTpTests, SegmentedMsgEscapedLength) {  // NOLINT
+  constexpr uint32_t MSG_SIZE = 5000U;
+
+  isotp::Sender sender;
+  isotp::Receiver<MSG_SIZE> receiver;
+
+  std::vector<uint8_t> data(MSG_SIZE);
+  for (auto& entry : data) {
+    entry = rand() % std::numeric_limits<uint8_t>::max();
+  }
+
+  transferMsg(sender, receiver, data);
+
+  ASSERT_TRUE(receiver.isMsgAvl());
+  ASSERT_EQ(receiver.getMsgSize(), data.size());
+  for (auto idx = 0U; idx < data.size(); idx++) {
+    EXPECT_EQ(receiver.getMsgData()[idx], data.at(idx));
+  }
+}
+
+TEST(IsoTpTests, MsgTooLarge) {  // NOLINT
+  isotp::Sender sender;
+  isotp::Receiver<64U> receiver;
+
+  const std::vector<uint8_t> data(65U);
+  transferMsg(sender, receiver, data);
+
+  EXPECT_TRUE(sender.isTransferAborted());
+  EXPECT_FALSE(receiver.isMsgAvl());
+}
+
+TEST(IsoTpTests, SegmentedMsgWhileNotReleased) {  // NOLINT
+  isotp::Sender sender;
+  isotp::Receiver<MAX_MSG_SIZE> receiver;
+
+  std::vector<uint8_t> data_first(100U);
+  std::vector<uint8_t> data_second(200U);
+  for (auto idx = 0U; idx < data_second.size(); idx++) {
+    data_second.at(idx) = static_cast<uint8_t>(idx);
+  }
+
+  transferMsg(sender, receiver, data_first);
+  ASSERT_TRUE(receiver.isMsgAvl());
+
+  /* Second message back-to-back: sender has to wait, but the transfer is not aborted */
+  isotp::Frame frame;
+  isotp::Frame flow_control;
+  ASSERT_TRUE(sender.startTransfer(data_second.data(), static_cast<uint32_t>(data_second.size())));
+  ASSERT_TRUE(sender.getNextFrame(frame));
+  ASSERT_TRUE(receiver.processFrame(frame, flow_control));
+  EXPECT_EQ(flow_control[0], isotp::FRAME_FLOW_CONTROL | isotp::FLOW_WAIT);
+
+  sender.processFlowControl(flow_control);
+  EXPECT_TRUE(sender.isWaitingForFlowControl());
+  EXPECT_FALSE(sender.isTransferAborted());
+  EXPECT_EQ(receiver.getMsgSize(), data_first.size());
+
+  /* Release continues the waiting transfer */
+  ASSERT_TRUE(receiver.releaseMsg(flow_control));
+  EXPECT_EQ(flow_control[0], isotp::FRAME_FLOW_CONTROL | isotp::FLOW_CONTINUE);
+  sender.processFlowControl(flow_control);
+
+  while (sender.getNextFrame(frame)) {
+    if (receiver.processFrame(frame, flow_control)) {
+      sender.processFlowControl(flow_control);
+    }
+  }
+
+  EXPECT_FALSE(sender.isTransferActive());
+  EXPECT_FALSE(sender.isTransferAborted());
+  ASSERT_TRUE(receiver.isMsgAvl());
+  ASSERT_EQ(receiver.getMsgSize(), data_second.size());
+  for (auto idx = 0U; idx < data_second.size(); idx++) {
+    EXPECT_EQ(receiver.getMsgData()[idx], data_second.at(idx));
+  }
+
+  EXPECT_FALSE(receiver.releaseMsg(flow_control));
+}
+
+TEST(IsoTpTests, LostConsecutiveFrame) {  // NOLINT
+  isotp::Sender sender;
+  isotp::Receiver<MAX_MSG_SIZE> receiver;
+
+  const std::vector<uint8_t> data(100U);
+  ASSERT_TRUE(sender.startTransfer(data.data(), static_cast<uint32_t>(data.size())));
+
+  isotp::Frame frame;
+  isotp::Frame flow_control;
+
+  /* First frame */
+  ASSERT_TRUE(sender.getNextFrame(frame));
+  ASSERT_TRUE(receiver.processFrame(frame, flow_control));
+  sender.processFlowControl(flow_control);
+
+  /* Drop second consecutive frame */
+  uint32_t frame_idx = 0U;
+  while (sender.getNextFrame(frame)) {
+    if (frame_idx != 1U) {
+      EXPECT_FALSE(receiver.processFrame(frame, flow_control));
+    }
+    frame_idx++;
+  }
+
+  EXPECT_FALSE(receiver.isMsgAvl());
+}
+
+/**
+ * @brief Uploads a page to the simulated device word by word and with ISO-TP and compares frames and time
+ */
+TEST(IsoTpTests, DeviceSimPageUpload) {  // NOLINT
+  constexpr uint32_t PAGE_SIZE = sim_device::FLASH_PAGE_SIZE;
+  constexpr uint32_t NUM_WORDS = PAGE_SIZE / 4U;
+
+  SIM_reset();
+  ASSERT_TRUE(SIM_addDevice(NODE_ID));
+
+  std::vector<uint8_t> page(PAGE_SIZE);
+  for (auto& entry : page) {
+    entry = rand() % std::numeric_limits<uint8_t>::max();
+  }
+
+  /* Word by word upload (REQ_PAGE_BUFFER_WRITE_WORD) */
+  uint32_t word_num_frames = 0U;
+  uint32_t word_time_us = 0U;
+  for (auto word_idx = 0U; word_idx < NUM_WORDS; word_idx++) {
+    auto request = msg::Msg(msg::REQ_PAGE_BUFFER_WRITE_WORD, msg::RES_NONE, static_cast<uint8_t>(word_idx));
+    for (auto idx = 0U; idx < request.data.size(); idx++) {
+      request.data[idx] = page.at(word_idx * 4U + idx);
+    }
+
+    auto raw_msg = msg::convertMsgToBytes(request);
+    SIM_sendNodeMsg(NODE_ID, raw_msg.data());
+    SIM_updateDevices();
+    ASSERT_TRUE(SIM_getNodeResponseMsg(NODE_ID, raw_msg.data()));
+    ASSERT_EQ(msg::convertBytesToMsg(raw_msg).result, msg::RES_OK);
+
+    word_num_frames += 2U;
+    word_time_us += 2U * SIM_FRAME_TIME_US + SIM_TURNAROUND_TIME_US;
+  }
+
+  /* Clear page buffer */
+  {
+    auto raw_msg = msg::convertMsgToBytes(msg::Msg(msg::REQ_PAGE_BUFFER_CLEAR, msg::RES_NONE, 0U));
+    SIM_sendNodeMsg(NODE_ID, raw_msg.data());
+    SIM_updateDevices();
+    ASSERT_TRUE(SIM_getNodeResponseMsg(NODE_ID, raw_msg.data()));
+  }
+
+  /* ISO-TP upload (REQ_PAGE_BUFFER_WRITE_BLOCK) */
+  std::vector<uint8_t> logical_msg;
+  {
+    auto request = msg::Msg(msg::REQ_PAGE_BUFFER_WRITE_BLOCK, msg::RES_NONE, 0U);
+    msg::convertU32ToMsgData(0U, request.data);
+    const auto raw_msg = msg::convertMsgToBytes(request);
+    logical_msg.insert(logical_msg.end(), raw_msg.begin(), raw_msg.end());
+    logical_msg.insert(logical_msg.end(), page.begin(), page.end());
+  }
+
+  uint32_t isotp_num_frames = 0U;
+  uint32_t isotp_time_us = 0U;
+
+  isotp::Sender sender;
+  ASSERT_TRUE(sender.startTransfer(logical_msg.data(), static_cast<uint32_t>(logical_msg.size())));
+  while (sender.isTransferActive()) {
+    isotp::Frame frame;
+    while (sender.getNextFrame(frame)) {
+      SIM_sendNodeIsoTpFrame(NODE_ID, frame.data());
+      isotp_num_frames++;
+      isotp_time_us += SIM_FRAME_TIME_US + sender.getSeparationTimeUs();
+    }
+
+    if (sender.isWaitingForFlowControl()) {
+      ASSERT_TRUE(SIM_getNodeIsoTpFrame(NODE_ID, frame.data()));
+      sender.processFlowControl(frame);
+      isotp_num_frames++;
+      isotp_time_us += SIM_FRAME_TIME_US + SIM_TURNAROUND_TIME_US;
+    }
+  }
+
+  /* Final response of the request */
+  {
+    SIM_updateDevices();
+    msg::MsgRaw raw_msg;
+    ASSERT_TRUE(SIM_getNodeResponseMsg(NODE_ID, raw_msg.data()));
+    const auto response = msg::convertBytesToMsg(raw_msg);
+    EXPECT_EQ(response.request, msg::REQ_PAGE_BUFFER_WRITE_BLOCK);
+    EXPECT_EQ(response.result, msg::RES_OK);
+    EXPECT_EQ(msg::convertMsgDataToU32(response.data), PAGE_SIZE);
+
+    isotp_num_frames++;
+    isotp_time_us += SIM_FRAME_TIME_US + SIM_TURNAROUND_TIME_US;
+  }
+
+  /* Check page buffer content */
+  for (auto word_idx = 0U; word_idx < NUM_WORDS; word_idx++) {
+    auto request = msg::Msg(msg::REQ_PAGE_BUFFER_READ_WORD, msg::RES_NONE, 0U);
+    msg::convertU32ToMsgData(word_idx * 4U, request.data);
+
+    auto raw_msg = msg::convertMsgToBytes(request);
+    SIM_sendNodeMsg(NODE_ID, raw_msg.data());
+    SIM_updateDevices();
+    ASSERT_TRUE(SIM_getNodeResponseMsg(NODE_ID, raw_msg.data()));
+
+    const auto response = msg::convertBytesToMsg(raw_msg);
+    for (auto idx = 0U; idx < response.data.size(); idx++) {
+      EXPECT_EQ(response.data[idx], page.at(word_idx * 4U + idx));
+    }
+  }
+
+  std::cout << "[ PAGE     ] " << PAGE_SIZE << " bytes" << std::endl;
+  std::cout << "[ WORD     ] frames: " << word_num_frames << " / time: " << word_time_us << " us" << std::endl;
+  std::cout << "[ ISO-TP   ] frames: " << isotp_num_frames << " / time: " << isotp_time_us << " us" << std::endl;
+
+  EXPECT_LT(isotp_num_frames, word_num_frames);
+  EXPECT_LT(isotp_time_us, word_time_us);
+
+  SIM_reset();
+}
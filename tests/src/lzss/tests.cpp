@@ -0,0 +1,244 @@
+/**
+ * @file tests.cpp
+ * @author Martin Bauernschmitt (martin.bauernschmitt@francor.de)
+ * @brief Unit Tests of FRANCORs Frankly Bootloader - LZSS Compressed Upload
+ * @version 0.1
+ * @date 2022-11-26
+ *
+ * @copyright Copyright (c) 2022 - BSD-3-clause - FRANCOR e.V.
+ *
+ */
+
+#include <francor/frankly_test_utils.h>
+#include <francor/franklyboot/lzss.h>
+
+#include <iostream>
+#include <limits>
+#include <vector>
+
+using namespace franklyboot;              // NOLINT
+using namespace franklyboot::test_utils;  // NOLINT
+
+// Defines / Constexpr ------------------------------------------------------------------------------------------------
+
+/** \brief Window bits of the decompression (256 byte window) */
+constexpr uint32_t WINDOW_BITS = 8U;
+
+/** \brief Handler with compressed upload enabled */
+using CompressedHandler = TestHandler<16U, msg::MSG_DATA_SIZE_CAN, 0U, WINDOW_BITS>;
+
+// Test Fixture Class -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Test class for compressed uploads
+ */
+class LzssTests : public TestHelper {
+ public:
+  LzssTests() = default;
+
+  /**
+   * @brief Creates a page looking like a firmware image (code, repeated tables, padding)
+   */
+  [[nodiscard]] static std::vector<uint8_t> createImagePage() {
+    std::vector<uint8_t> page;
+
+    for (auto idx = 0U; idx < 256U; idx++) {
+      page.push_back(static_cast<uint8_t>(rand() % std::numeric_limits<uint8_t>::max()));
+    }
+
+    for (auto table_idx = 0U; table_idx < 8U; table_idx++) {
+      for (auto idx = 0U; idx < 32U; idx++) {
+        page.push_back(static_cast<uint8_t>(idx * 3U + table_idx));
+      }
+    }
+
+    page.resize(FLASH_PAGE_SIZE, std::numeric_limits<uint8_t>::max());
+    return page;
+  }
+
+  /**
+   * @brief Sends one compressed frame to the handler
+   */
+  static void sendFrame(CompressedHandler& handler, const std::vector<uint8_t>& compressed, const uint32_t frame_idx) {
+    auto request = msg::Msg(msg::REQ_PAGE_BUFFER_WRITE_COMPRESSED, msg::RES_NONE, static_cast<uint8_t>(frame_idx));
+    for (auto idx = 0U; idx < request.data.size(); idx++) {
+      const uint32_t byte_idx = frame_idx * msg::MSG_DATA_SIZE_CAN + idx;
+      request.data[idx] = (byte_idx < compressed.size()) ? compressed[byte_idx] : 0U;
+    }
+
+    handler.processRequest(request);
+  }
+
+  [[nodiscard]] static uint32_t getNumFrames(const std::vector<uint8_t>& compressed) {
+    return (static_cast<uint32_t>(compressed.size()) + msg::MSG_DATA_SIZE_CAN - 1U) / msg::MSG_DATA_SIZE_CAN;
+  }
+};
+
+// Tests --------------------------------------------------------------------------------------------------------------
+
+TEST_F(LzssTests, EncodeDecode) {  // NOLINT
+  const auto page = createImagePage();
+  const auto compressed = compressLzss(page, WINDOW_BITS);
+  EXPECT_LT(compressed.size() * 2U, page.size());
+
+  /* Decode in chunks of one CAN payload */
+  std::vector<uint8_t> decoded(page.size(), 0U);
+  lzss::Decoder<WINDOW_BITS> decoder;
+  decoder.reset(static_cast<uint32_t>(decoded.size()));
+
+  for (auto byte_idx = 0U; byte_idx < compressed.size(); byte_idx += msg::MSG_DATA_SIZE_CAN) {
+    const auto num_bytes = std::min<uint32_t>(msg::MSG_DATA_SIZE_CAN, compressed.size() - byte_idx);
+    EXPECT_TRUE(decoder.processData(decoded.data(), compressed.data() + byte_idx, num_bytes));
+  }
+
+  EXPECT_TRUE(decoder.isComplete());
+  EXPECT_EQ(decoded, page);
+}
+
+TEST_F(LzssTests, DecodeInvalidBackref) {  // NOLINT
+  /* Back-reference without any output decoded before */
+  const std::vector<uint8_t> compressed = {0x00, 0x00, 0x00};
+
+  std::vector<uint8_t> decoded(16U, 0U);
+  lzss::Decoder<WINDOW_BITS> decoder;
+  decoder.reset(static_cast<uint32_t>(decoded.size()));
+
+  EXPECT_FALSE(decoder.processData(decoded.data(), compressed.data(), static_cast<uint32_t>(compressed.size())));
+  EXPECT_FALSE(decoder.isValid());
+  EXPECT_EQ(decoder.getNumBytesDecoded(), 0U);
+}
+
+TEST_F(LzssTests, CompressedPageUpload) {  // NOLINT
+  constexpr uint32_t CAN_BITRATE = 125000U;
+  constexpr uint32_t CAN_FRAME_BITS = 111U;  // 8 byte frame with standard ID, without stuff bits
+
+  CompressedHandler handler(getHWI());
+  const auto page = createImagePage();
+  const auto compressed = compressLzss(page, WINDOW_BITS);
+  const uint32_t num_frames = getNumFrames(compressed);
+
+  handler.processRequest(msg::Msg(msg::REQ_PAGE_BUFFER_CLEAR, msg::RES_NONE, 0U));
+
+  uint32_t num_responses = 0U;
+  for (auto frame_idx = 0U; frame_idx < num_frames; frame_idx++) {
+    sendFrame(handler, compressed, frame_idx);
+
+    if (handler.isResponseAvl()) {
+      EXPECT_EQ(handler.getResponse().result, msg::RES_OK);
+      EXPECT_EQ(handler.getResponse().packet_id, static_cast<uint8_t>(frame_idx));
+      num_responses++;
+    }
+  }
+
+  /* Last response reports the complete page */
+  EXPECT_EQ(msg::convertMsgDataToU32(handler.getResponse().data), FLASH_PAGE_SIZE);
+  EXPECT_EQ(handler.getPageBufferNumBytesFree(), 0U);
+  for (auto byte_idx = 0U; byte_idx < FLASH_PAGE_SIZE; byte_idx++) {
+    EXPECT_EQ(handler.getByteFromPageBuffer(byte_idx), page.at(byte_idx));
+  }
+
+  /* Further frames are rejected */
+  sendFrame(handler, compressed, num_frames);
+  EXPECT_EQ(handler.getResponse().result, msg::RES_ERR_PAGE_FULL);
+
+  const uint32_t num_frames_uncompressed = FLASH_PAGE_SIZE / msg::MSG_DATA_SIZE_CAN;
+  const uint32_t time_us = (num_frames + num_responses) * CAN_FRAME_BITS * 1000U / (CAN_BITRATE / 1000U);
+  const uint32_t time_uncompressed_us = num_frames_uncompressed * 2U * CAN_FRAME_BITS * 1000U / (CAN_BITRATE / 1000U);
+  std::cout << "Compressed page: " << num_frames << " frames / " << time_us / 1000U << " ms, uncompressed "
+            << num_frames_uncompressed << " words / " << time_uncompressed_us / 1000U << " ms (125 kbit/s)"
+            << std::endl;
+  EXPECT_LT(num_frames * 2U, num_frames_uncompressed);
+}
+
+TEST_F(LzssTests, CompressedUploadCopiedHandler) {  // NOLINT
+  constexpr uint32_t NUM_FRAMES_FIRST = 8U;
+
+  const auto page = createImagePage();
+  const auto compressed = compressLzss(page, WINDOW_BITS);
+  const uint32_t num_frames = getNumFrames(compressed);
+
+  /* Handlers in a vector are moved on reallocation (e.g. device simulation) */
+  std::vector<CompressedHandler> handlers;
+  handlers.emplace_back(getHWI());
+  handlers.emplace_back(getHWI());
+
+  for (auto frame_idx = 0U; frame_idx < NUM_FRAMES_FIRST; frame_idx++) {
+    sendFrame(handlers.front(), compressed, frame_idx);
+  }
+
+  /* Copy continues the upload into its own page buffer, the original is untouched */
+  CompressedHandler handler_copy = handlers.front();
+  const uint32_t num_bytes_first = FLASH_PAGE_SIZE - handlers.front().getPageBufferNumBytesFree();
+  for (auto frame_idx = NUM_FRAMES_FIRST; frame_idx < num_frames; frame_idx++) {
+    sendFrame(handler_copy, compressed, frame_idx);
+  }
+
+  EXPECT_EQ(handler_copy.getResponse().result, msg::RES_OK);
+  EXPECT_EQ(handler_copy.getPageBufferNumBytesFree(), 0U);
+  EXPECT_EQ(handlers.front().getPageBufferNumBytesFree(), FLASH_PAGE_SIZE - num_bytes_first);
+  for (auto byte_idx = 0U; byte_idx < FLASH_PAGE_SIZE; byte_idx++) {
+    EXPECT_EQ(handler_copy.getByteFromPageBuffer(byte_idx), page.at(byte_idx));
+
+    const bool byte_decoded = (byte_idx < num_bytes_first);
+    const uint8_t expected = byte_decoded ? page.at(byte_idx) : std::numeric_limits<uint8_t>::max();
+    EXPECT_EQ(handlers.front().getByteFromPageBuffer(byte_idx), expected);
+  }
+}
+
+TEST_F(LzssTests, CompressedUploadGap) {  // NOLINT
+  constexpr uint32_t LOST_FRAME_IDX = 3U;
+
+  CompressedHandler handler(getHWI());
+  const auto page = createImagePage();
+  const auto compressed = compressLzss(page, WINDOW_BITS);
+  const uint32_t num_frames = getNumFrames(compressed);
+
+  /* Lost frame is reported once with the last frame decoded */
+  uint32_t num_gap_responses = 0U;
+  for (auto frame_idx = 0U; frame_idx < 16U; frame_idx++) {
+    if (frame_idx != LOST_FRAME_IDX) {
+      sendFrame(handler, compressed, frame_idx);
+    }
+
+    if (handler.isResponseAvl()) {
+      EXPECT_EQ(handler.getResponse().result, msg::RES_ERR);
+      EXPECT_EQ(handler.getResponse().packet_id, LOST_FRAME_IDX - 1U);
+      num_gap_responses++;
+    }
+  }
+
+  EXPECT_EQ(num_gap_responses, 1U);
+
+  /* Resend starting with the lost frame */
+  for (auto frame_idx = LOST_FRAME_IDX; frame_idx < num_frames; frame_idx++) {
+    sendFrame(handler, compressed, frame_idx);
+  }
+
+  EXPECT_EQ(handler.getResponse().result, msg::RES_OK);
+  for (auto byte_idx = 0U; byte_idx < FLASH_PAGE_SIZE; byte_idx++) {
+    EXPECT_EQ(handler.getByteFromPageBuffer(byte_idx), page.at(byte_idx));
+  }
+}
+
+TEST_F(LzssTests, CompressedUploadInvalidStream) {  // NOLINT
+  CompressedHandler handler(getHWI());
+
+  handler.processRequest(msg::Msg(msg::REQ_PAGE_BUFFER_WRITE_COMPRESSED, msg::RES_NONE, 0U));
+  EXPECT_TRUE(handler.isResponseAvl());
+  EXPECT_EQ(handler.getResponse().result, msg::RES_ERR_INVLD_ARG);
+
+  /* Decoder stays invalid until the page buffer is cleared */
+  handler.processRequest(msg::Msg(msg::REQ_PAGE_BUFFER_WRITE_COMPRESSED, msg::RES_NONE, 1U));
+  EXPECT_EQ(handler.getResponse().result, msg::RES_ERR_INVLD_ARG);
+
+  handler.processRequest(msg::Msg(msg::REQ_PAGE_BUFFER_CLEAR, msg::RES_NONE, 0U));
+  auto request = msg::Msg(msg::REQ_PAGE_BUFFER_WRITE_COMPRESSED, msg::RES_NONE, 0U);
+  request.data = {0xFF, 0xFF, 0xFF, 0xFF};
+  handler.processRequest(request);
+  EXPECT_EQ(handler.getResponse().result, msg::RES_OK);
+}
+
+TEST_F(LzssTests, CompressedUploadNotSupported) {  // NOLINT
+  getHandle().processRequest(msg::Msg(msg::REQ_PAGE_BUFFER_WRITE_COMPRESSED, msg::RES_NONE, 0U));
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_ERR_NOT_SUPPORTED);
+}
@@ -11,7 +11,10 @@
 
 #include <francor/frankly_test_utils.h>
 
+#include <algorithm>
 #include <limits>
+#include <memory>
+#include <vector>
 
 using namespace franklyboot;              // NOLINT
 using namespace franklyboot::test_utils;  // NOLINT
@@ -409,4 +412,620 @@ TEST_F(PageBufferTests, PageBufferWriteToFlashHWError) {  // NOLINT
   for (auto idx = 0U; idx < response.data.size(); idx++) {
     EXPECT_EQ(response.data.at(idx), EXPECTED_DATA.at(idx));
   }
-}
\ No newline at end of file
+}
+
+TEST_F(PageBufferTests, PageBufferWriteToFlashCompare) {  // NOLINT
+  constexpr uint32_t PAGE_ID = 4U;
+  constexpr uint32_t PAGE_ADDRESS = FLASH_START + PAGE_ID * FLASH_PAGE_SIZE;
+  setErasePageResult(true);
+  setWriteToFlashResult(true);
+
+  msg::Msg request_msg = msg::Msg(msg::REQ_PAGE_BUFFER_WRITE_TO_FLASH, msg::RES_NONE, 0U);
+  request_msg.result = static_cast<msg::ResultType>(msg::WRITE_TO_FLASH_COMPARE);
+  msg::convertU32ToMsgData(PAGE_ID, request_msg.data);
+
+  /* Erased page buffer equals erased flash -> not touched */
+  getHandle().processRequest(request_msg);
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_OK_UNCHANGED);
+  EXPECT_EQ(msg::convertMsgDataToU32(getHandle().getResponse().data), PAGE_ID);
+  EXPECT_FALSE(erasePageCalled());
+  EXPECT_FALSE(writeToFlashCalled());
+
+  /* Last word differs -> page is written */
+  setByteInFlash(PAGE_ADDRESS + FLASH_PAGE_SIZE - 1U, 0x00U);
+  getHandle().processRequest(request_msg);
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_OK);
+  EXPECT_TRUE(erasePageCalled());
+  EXPECT_TRUE(writeToFlashCalled());
+  EXPECT_EQ(readByteFromFlash(PAGE_ADDRESS + FLASH_PAGE_SIZE - 1U), std::numeric_limits<uint8_t>::max());
+
+  /* Written again: unchanged */
+  getHandle().processRequest(request_msg);
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_OK_UNCHANGED);
+}
+
+TEST_F(PageBufferTests, PageBufferWriteToFlashBlankPage) {  // NOLINT
+  constexpr uint32_t PAGE_ID = 4U;
+  constexpr uint32_t PAGE_ADDRESS = FLASH_START + PAGE_ID * FLASH_PAGE_SIZE;
+  static_assert(!hwi::HasBlankCheck<TestHWI>::value, "TestHWI has to be detected without blank check!");
+  setErasePageResult(true);
+  setWriteToFlashResult(true);
+
+  msg::Msg request_msg = msg::Msg(msg::REQ_PAGE_BUFFER_WRITE_TO_FLASH, msg::RES_NONE, 0U);
+  msg::convertU32ToMsgData(PAGE_ID, request_msg.data);
+
+  /* Page reads 0xFF, but without blank check of the HWI it is erased anyway (e.g. flash with ECC) */
+  for (auto idx = 0U; idx < FLASH_PAGE_SIZE; idx++) {
+    ASSERT_EQ(readByteFromFlash(PAGE_ADDRESS + idx), std::numeric_limits<uint8_t>::max());
+  }
+
+  getHandle().processRequest(request_msg);
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_OK);
+  EXPECT_TRUE(erasePageCalled());
+  EXPECT_TRUE(writeToFlashCalled());
+}
+
+TEST_F(PageBufferTests, PageBufferWriteToFlashBlankCheckHook) {  // NOLINT
+  constexpr uint32_t PAGE_ID = 4U;
+  constexpr uint32_t PAGE_ADDRESS = FLASH_START + PAGE_ID * FLASH_PAGE_SIZE;
+
+  /** \brief Flash controller reporting the blank state of a page (simulated by reading the page) */
+  class BlankCheckHWI : public TestHWI {
+   public:
+    using TestHWI::TestHWI;
+
+    [[nodiscard]] bool isFlashPageBlank(const uint32_t page_id) const {
+      bool page_blank = true;
+      for (auto idx = 0U; idx < FLASH_PAGE_SIZE; idx++) {
+        page_blank = page_blank && (readByteFromFlash(FLASH_START + page_id * FLASH_PAGE_SIZE + idx) ==
+                                    std::numeric_limits<uint8_t>::max());
+      }
+
+      return page_blank;
+    }
+  };
+
+  using BlankCheckHandler = Handler<FLASH_START, FLASH_APP_FIRST_PAGE, FLASH_SIZE, FLASH_PAGE_SIZE, 16U,
+                                    msg::MSG_DATA_SIZE_CAN, 0U, 0U, 1U, BlankCheckHWI>;
+  BlankCheckHandler handler{BlankCheckHWI(*this)};
+  setErasePageResult(true);
+  setWriteToFlashResult(true);
+
+  msg::Msg request_msg = msg::Msg(msg::REQ_PAGE_BUFFER_WRITE_TO_FLASH, msg::RES_NONE, 0U);
+  msg::convertU32ToMsgData(PAGE_ID, request_msg.data);
+
+  /* Blank page (factory blank / mass erased) -> written without erase */
+  handler.processRequest(request_msg);
+  EXPECT_EQ(handler.getResponse().result, msg::RES_OK);
+  EXPECT_FALSE(erasePageCalled());
+  EXPECT_TRUE(writeToFlashCalled());
+
+  /* Programmed page -> erased before write */
+  setByteInFlash(PAGE_ADDRESS + FLASH_PAGE_SIZE - 1U, 0x00U);
+  handler.processRequest(request_msg);
+  EXPECT_EQ(handler.getResponse().result, msg::RES_OK);
+  EXPECT_TRUE(erasePageCalled());
+}
+
+TEST_F(PageBufferTests, PageBufferWriteToFlashVerify) {  // NOLINT
+  constexpr uint32_t PAGE_ID = 4U;
+  constexpr uint32_t PAGE_ADDRESS = FLASH_START + PAGE_ID * FLASH_PAGE_SIZE;
+  constexpr uint32_t CRC_VALUE = 0xDEADBEEFU;
+  setErasePageResult(true);
+  setWriteToFlashResult(true);
+  setCRCResult(CRC_VALUE);
+
+  auto word_request = msg::Msg(msg::REQ_PAGE_BUFFER_WRITE_WORD, msg::RES_NONE, 0U);
+  word_request.data = {0x01, 0x02, 0x03, 0x04};
+  getHandle().processRequest(word_request);
+
+  msg::Msg request_msg = msg::Msg(msg::REQ_PAGE_BUFFER_WRITE_TO_FLASH, msg::RES_NONE, 0U);
+  request_msg.result = static_cast<msg::ResultType>(msg::WRITE_TO_FLASH_VERIFY);
+  msg::convertU32ToMsgData(PAGE_ID, request_msg.data);
+
+  /* Written, verified and proven by the CRC of the flash page */
+  getHandle().processRequest(request_msg);
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_OK);
+  EXPECT_EQ(msg::convertMsgDataToU32(getHandle().getResponse().data), CRC_VALUE);
+  EXPECT_EQ(getCalcCRCSrcAddress(), PAGE_ADDRESS);
+  EXPECT_EQ(getCalcCRCNumBytes(), FLASH_PAGE_SIZE);
+  EXPECT_EQ(readByteFromFlash(PAGE_ADDRESS), 0x01);
+
+  /* Unchanged page is proven as well */
+  request_msg.result = static_cast<msg::ResultType>(msg::WRITE_TO_FLASH_COMPARE | msg::WRITE_TO_FLASH_VERIFY);
+  getHandle().processRequest(request_msg);
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_OK_UNCHANGED);
+  EXPECT_EQ(msg::convertMsgDataToU32(getHandle().getResponse().data), CRC_VALUE);
+
+  /* Programming error not reported by the flash */
+  setWriteToFlashCorrupt(true);
+  request_msg.result = static_cast<msg::ResultType>(msg::WRITE_TO_FLASH_VERIFY);
+  getHandle().processRequest(request_msg);
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_ERR_CRC_INVLD);
+  EXPECT_EQ(msg::convertMsgDataToU32(getHandle().getResponse().data), CRC_VALUE);
+
+  /* Without verify the error is not detected */
+  request_msg.result = msg::RES_NONE;
+  getHandle().processRequest(request_msg);
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_OK);
+  EXPECT_EQ(msg::convertMsgDataToU32(getHandle().getResponse().data), PAGE_ID);
+}
+
+TEST_F(PageBufferTests, PageBufferStreamPage) {  // NOLINT
+  constexpr msg::RequestType REQUEST = msg::REQ_PAGE_BUFFER_STREAM_WORD;
+  constexpr uint32_t NUM_MSGS = (FLASH_PAGE_SIZE / 4U);
+  const uint32_t window_size = getHandle().getStreamWindowSize();
+
+  /* Create random data for one page */
+  std::array<uint8_t, FLASH_PAGE_SIZE> data_lst;
+  for (auto& entry : data_lst) {
+    entry = rand() % std::numeric_limits<uint8_t>::max();
+  }
+
+  uint32_t num_responses = 0U;
+  for (auto data_word_idx = 0U; data_word_idx < NUM_MSGS; data_word_idx++) {
+    const auto packet_id = static_cast<uint8_t>(data_word_idx & 0xFF);
+    msg::Msg request = msg::Msg(REQUEST, msg::RES_NONE, packet_id);
+
+    request.data[0] = data_lst.at((data_word_idx * 4) + 0U);
+    request.data[1] = data_lst.at((data_word_idx * 4) + 1U);
+    request.data[2] = data_lst.at((data_word_idx * 4) + 2U);
+    request.data[3] = data_lst.at((data_word_idx * 4) + 3U);
+
+    getHandle().processRequest(request);
+
+    /* Only the last word of every window is acknowledged */
+    const bool expect_response = (((data_word_idx + 1U) % window_size) == 0U) || ((data_word_idx + 1U) == NUM_MSGS);
+    EXPECT_EQ(getHandle().isResponseAvl(), expect_response);
+
+    if (getHandle().isResponseAvl()) {
+      const msg::Msg response = getHandle().getResponse();
+      EXPECT_EQ(response.request, REQUEST);
+      EXPECT_EQ(response.result, msg::RES_OK);
+      EXPECT_EQ(response.packet_id, packet_id);
+      EXPECT_EQ(msg::convertMsgDataToU32(response.data), (data_word_idx + 1U) * 4U);
+      num_responses++;
+    }
+  }
+
+  EXPECT_EQ(num_responses, NUM_MSGS / window_size);
+
+  /* Check if data is written correctly to buffer */
+  for (auto byte_idx = 0U; byte_idx < FLASH_PAGE_SIZE; byte_idx++) {
+    EXPECT_EQ(getHandle().getByteFromPageBuffer(byte_idx), data_lst.at(byte_idx));
+  }
+}
+
+TEST_F(PageBufferTests, PageBufferStreamGap) {  // NOLINT
+  constexpr msg::RequestType REQUEST = msg::REQ_PAGE_BUFFER_STREAM_WORD;
+  constexpr uint32_t LOST_WORD_IDX = 5U;
+  const uint32_t window_size = getHandle().getStreamWindowSize();
+
+  /* Send first window with one lost word */
+  uint32_t num_gap_responses = 0U;
+  for (auto data_word_idx = 0U; data_word_idx < window_size; data_word_idx++) {
+    if (data_word_idx == LOST_WORD_IDX) {
+      continue;
+    }
+
+    const auto packet_id = static_cast<uint8_t>(data_word_idx & 0xFF);
+    getHandle().processRequest(msg::Msg(REQUEST, msg::RES_NONE, packet_id));
+
+    if (getHandle().isResponseAvl()) {
+      const msg::Msg response = getHandle().getResponse();
+      EXPECT_EQ(response.request, REQUEST);
+      EXPECT_EQ(response.result, msg::RES_ERR);
+      EXPECT_EQ(response.packet_id, LOST_WORD_IDX - 1U);
+      EXPECT_EQ(msg::convertMsgDataToU32(response.data), LOST_WORD_IDX * 4U);
+      num_gap_responses++;
+    }
+  }
+
+  /* Gap shall be reported exactly once */
+  EXPECT_EQ(num_gap_responses, 1U);
+
+  /* Retransmit window starting at the lost word */
+  for (auto data_word_idx = LOST_WORD_IDX; data_word_idx < window_size; data_word_idx++) {
+    const auto packet_id = static_cast<uint8_t>(data_word_idx & 0xFF);
+    getHandle().processRequest(msg::Msg(REQUEST, msg::RES_NONE, packet_id));
+  }
+
+  ASSERT_TRUE(getHandle().isResponseAvl());
+  const msg::Msg response = getHandle().getResponse();
+  EXPECT_EQ(response.result, msg::RES_OK);
+  EXPECT_EQ(response.packet_id, window_size - 1U);
+  EXPECT_EQ(msg::convertMsgDataToU32(response.data), window_size * 4U);
+}
+
+TEST_F(PageBufferTests, PageBufferStreamOverflow) {  // NOLINT
+  constexpr msg::RequestType REQUEST = msg::REQ_PAGE_BUFFER_STREAM_WORD;
+  constexpr uint32_t NUM_MSGS = (FLASH_PAGE_SIZE / 4U);
+
+  for (auto data_word_idx = 0U; data_word_idx < NUM_MSGS; data_word_idx++) {
+    const auto packet_id = static_cast<uint8_t>(data_word_idx & 0xFF);
+    getHandle().processRequest(msg::Msg(REQUEST, msg::RES_NONE, packet_id));
+  }
+
+  /* Page buffer is full -> every further word is answered */
+  const auto packet_id = static_cast<uint8_t>(NUM_MSGS & 0xFF);
+  getHandle().processRequest(msg::Msg(REQUEST, msg::RES_NONE, packet_id));
+
+  EXPECT_TRUE(getHandle().isResponseAvl());
+  const msg::Msg response = getHandle().getResponse();
+  EXPECT_EQ(response.request, REQUEST);
+  EXPECT_EQ(response.result, msg::RES_ERR_PAGE_FULL);
+}
+
+TEST_F(PageBufferTests, PageBufferStreamSelectiveRepeat) {  // NOLINT
+  constexpr msg::RequestType REQUEST = msg::REQ_PAGE_BUFFER_STREAM_WORD;
+  constexpr uint32_t NUM_MSGS = 40U;
+  constexpr std::array<uint32_t, 3U> LOST_WORD_IDX_LST = {3U, 9U, 37U};
+
+  /* Create random data */
+  std::array<uint8_t, NUM_MSGS * 4U> data_lst;
+  for (auto& entry : data_lst) {
+    entry = rand() % std::numeric_limits<uint8_t>::max();
+  }
+
+  auto send_word = [&](const uint32_t data_word_idx) {
+    msg::Msg request = msg::Msg(REQUEST, msg::RES_NONE, static_cast<uint8_t>(data_word_idx & 0xFF));
+    for (auto idx = 0U; idx < 4U; idx++) {
+      request.data[idx] = data_lst.at((data_word_idx * 4U) + idx);
+    }
+    getHandle().processRequest(request);
+  };
+
+  /* Send all words, three are lost */
+  for (auto data_word_idx = 0U; data_word_idx < NUM_MSGS; data_word_idx++) {
+    if (std::find(LOST_WORD_IDX_LST.begin(), LOST_WORD_IDX_LST.end(), data_word_idx) == LOST_WORD_IDX_LST.end()) {
+      send_word(data_word_idx);
+    }
+  }
+
+  /* Read bitmap of missing words starting at the write position (two frames with 32 words each) */
+  msg::Msg request = msg::Msg(msg::REQ_PAGE_BUFFER_MISSING_WORDS, msg::RES_NONE, 0U);
+  msg::convertU32ToMsgData(LOST_WORD_IDX_LST[0], request.data);
+  getHandle().processRequest(request);
+
+  std::vector<uint32_t> missing_word_idx_lst;
+  uint32_t num_frames = 0U;
+  while (getHandle().isResponseAvl()) {
+    const msg::Msg response = getHandle().getResponse();
+    EXPECT_EQ(response.request, msg::REQ_PAGE_BUFFER_MISSING_WORDS);
+    EXPECT_EQ(response.result, msg::RES_OK);
+    EXPECT_EQ(response.packet_id, num_frames);
+
+    for (auto bit_idx = 0U; bit_idx < 32U; bit_idx++) {
+      if ((response.data.at(bit_idx / 8U) & (1U << (bit_idx % 8U))) != 0U) {
+        missing_word_idx_lst.push_back(LOST_WORD_IDX_LST[0] + num_frames * 32U + bit_idx);
+      }
+    }
+
+    num_frames++;
+    getHandle().processNextResponse();
+  }
+
+  EXPECT_EQ(num_frames, 2U);
+  ASSERT_EQ(missing_word_idx_lst.size(), LOST_WORD_IDX_LST.size());
+  EXPECT_TRUE(std::equal(missing_word_idx_lst.begin(), missing_word_idx_lst.end(), LOST_WORD_IDX_LST.begin()));
+
+  /* Retransmit only the missing words, last one closes the gap and is acknowledged */
+  for (const auto data_word_idx : missing_word_idx_lst) {
+    send_word(data_word_idx);
+  }
+
+  ASSERT_TRUE(getHandle().isResponseAvl());
+  const msg::Msg response = getHandle().getResponse();
+  EXPECT_EQ(response.result, msg::RES_OK);
+  EXPECT_EQ(response.packet_id, NUM_MSGS - 1U);
+  EXPECT_EQ(msg::convertMsgDataToU32(response.data), NUM_MSGS * 4U);
+
+  for (auto byte_idx = 0U; byte_idx < data_lst.size(); byte_idx++) {
+    EXPECT_EQ(getHandle().getByteFromPageBuffer(byte_idx), data_lst.at(byte_idx));
+  }
+
+  /* Nothing missing behind the write position anymore -> one empty frame */
+  msg::convertU32ToMsgData(NUM_MSGS, request.data);
+  getHandle().processRequest(request);
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_OK);
+  EXPECT_EQ(msg::convertMsgDataToU32(getHandle().getResponse().data), 0U);
+  getHandle().processNextResponse();
+  EXPECT_FALSE(getHandle().isResponseAvl());
+}
+
+TEST_F(PageBufferTests, PageBufferWriteWordAheadOfGap) {  // NOLINT
+  constexpr msg::RequestType REQUEST = msg::REQ_PAGE_BUFFER_WRITE_WORD;
+
+  msg::Msg word_0 = msg::Msg(REQUEST, msg::RES_NONE, 0U);
+  msg::convertU32ToMsgData(0xDDCCBBAAU, word_0.data);
+  msg::Msg word_1 = msg::Msg(REQUEST, msg::RES_NONE, 1U);
+  msg::convertU32ToMsgData(0x44332211U, word_1.data);
+
+  /* Word 0 is lost, word 1 is accepted nevertheless */
+  getHandle().processRequest(word_1);
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_OK);
+
+  msg::Msg request = msg::Msg(msg::REQ_PAGE_BUFFER_MISSING_WORDS, msg::RES_NONE, 0U);
+  getHandle().processRequest(request);
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_OK);
+  EXPECT_EQ(msg::convertMsgDataToU32(getHandle().getResponse().data), 1U);
+
+  /* Repeat lost word, afterwards every word is received */
+  getHandle().processRequest(word_0);
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_OK);
+
+  getHandle().processRequest(request);
+  EXPECT_EQ(msg::convertMsgDataToU32(getHandle().getResponse().data), 0U);
+
+  EXPECT_EQ(getHandle().getByteFromPageBuffer(0U), 0xAA);
+  EXPECT_EQ(getHandle().getByteFromPageBuffer(4U), 0x11);
+
+  /* Words behind the write position are rejected */
+  getHandle().processRequest(msg::Msg(REQUEST, msg::RES_NONE, 1U));
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_ERR);
+  EXPECT_EQ(getHandle().getByteFromPageBuffer(4U), 0x11);
+}
+
+TEST_F(PageBufferTests, PageBufferMissingWordsInvldArg) {  // NOLINT
+  msg::Msg request = msg::Msg(msg::REQ_PAGE_BUFFER_MISSING_WORDS, msg::RES_NONE, 0U);
+  msg::convertU32ToMsgData(FLASH_PAGE_SIZE / 4U, request.data);
+  getHandle().processRequest(request);
+
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_ERR_INVLD_ARG);
+  getHandle().processNextResponse();
+  EXPECT_FALSE(getHandle().isResponseAvl());
+}
+
+TEST_F(PageBufferTests, PageBufferWriteWordAt) {  // NOLINT
+  constexpr msg::RequestType REQUEST = msg::REQ_PAGE_BUFFER_WRITE_WORD_AT;
+  constexpr uint32_t NUM_MSGS = (FLASH_PAGE_SIZE / 4U);
+
+  /* Write page in reverse order, word index exceeds 8-bit packet id */
+  for (auto data_word_idx = NUM_MSGS; data_word_idx-- > 0U;) {
+    msg::Msg request = msg::Msg(REQUEST, static_cast<msg::ResultType>(data_word_idx >> 8U),
+                                static_cast<uint8_t>(data_word_idx & 0xFF));
+    msg::convertU32ToMsgData(data_word_idx, request.data);
+    getHandle().processRequest(request);
+
+    const msg::Msg response = getHandle().getResponse();
+    EXPECT_EQ(response.request, REQUEST);
+    EXPECT_EQ(response.result, msg::RES_OK);
+    EXPECT_EQ(response.packet_id, static_cast<uint8_t>(data_word_idx & 0xFF));
+    EXPECT_EQ(msg::convertMsgDataToU32(response.data), data_word_idx * 4U);
+  }
+
+  for (auto data_word_idx = 0U; data_word_idx < NUM_MSGS; data_word_idx++) {
+    EXPECT_EQ(getHandle().getByteFromPageBuffer(data_word_idx * 4U), data_word_idx & 0xFF);
+    EXPECT_EQ(getHandle().getByteFromPageBuffer(data_word_idx * 4U + 1U), data_word_idx >> 8U);
+  }
+
+  /* Page buffer is complete -> streamed word is rejected */
+  getHandle().processRequest(msg::Msg(msg::REQ_PAGE_BUFFER_STREAM_WORD, msg::RES_NONE, 0U));
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_ERR_PAGE_FULL);
+}
+
+TEST_F(PageBufferTests, PageBufferWriteWordAtInvldIdx) {  // NOLINT
+  constexpr uint32_t WORD_IDX = (FLASH_PAGE_SIZE / 4U);
+
+  msg::Msg request = msg::Msg(msg::REQ_PAGE_BUFFER_WRITE_WORD_AT, static_cast<msg::ResultType>(WORD_IDX >> 8U),
+                              static_cast<uint8_t>(WORD_IDX & 0xFF));
+  getHandle().processRequest(request);
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_ERR_INVLD_ARG);
+}
+
+TEST_F(PageBufferTests, PageBufferWriteLargePage) {  // NOLINT
+  constexpr uint32_t LARGE_PAGE_SIZE = 128U * 1024U;
+  constexpr uint32_t NUM_MSGS = LARGE_PAGE_SIZE / 4U;
+  constexpr uint32_t WORD_IDX_STRIDE = 7919U;
+
+  using LargePageHandler = Handler<FLASH_START, 1U, 8U * LARGE_PAGE_SIZE, LARGE_PAGE_SIZE, 16U,
+                                   msg::MSG_DATA_SIZE_CAN, 0U, 0U, 1U, TestHWI>;
+  auto handler = std::make_unique<LargePageHandler>(getHWI());
+
+  /* Stream the page, sequence number wraps 128 times */
+  uint32_t num_responses = 0U;
+  for (auto data_word_idx = 0U; data_word_idx < NUM_MSGS; data_word_idx++) {
+    auto request = msg::Msg(msg::REQ_PAGE_BUFFER_STREAM_WORD, msg::RES_NONE, static_cast<uint8_t>(data_word_idx));
+    handler->processRequest(request);
+
+    if (handler->isResponseAvl()) {
+      EXPECT_EQ(handler->getResponse().result, msg::RES_OK);
+      EXPECT_EQ(msg::convertMsgDataToU32(handler->getResponse().data), (data_word_idx + 1U) * 4U);
+      num_responses++;
+    }
+  }
+
+  EXPECT_EQ(num_responses, NUM_MSGS / handler->getStreamWindowSize());
+  EXPECT_EQ(handler->getPageBufferNumBytesFree(), 0U);
+
+  /* Fill the page out of order with the full word index */
+  handler->processRequest(msg::Msg(msg::REQ_PAGE_BUFFER_CLEAR, msg::RES_NONE, 0U));
+  for (auto msg_idx = 0U; msg_idx < NUM_MSGS; msg_idx++) {
+    const uint32_t data_word_idx = (msg_idx * WORD_IDX_STRIDE) % NUM_MSGS;
+
+    msg::Msg request = msg::Msg(msg::REQ_PAGE_BUFFER_WRITE_WORD_AT, static_cast<msg::ResultType>(data_word_idx >> 8U),
+                                static_cast<uint8_t>(data_word_idx & 0xFF));
+    msg::convertU32ToMsgData(data_word_idx, request.data);
+    handler->processRequest(request);
+    EXPECT_EQ(handler->getResponse().result, msg::RES_OK);
+  }
+
+  EXPECT_EQ(handler->getPageBufferNumBytesFree(), 0U);
+  for (auto data_word_idx = 0U; data_word_idx < NUM_MSGS; data_word_idx++) {
+    EXPECT_EQ(handler->getByteFromPageBuffer(data_word_idx * 4U), data_word_idx & 0xFF);
+    EXPECT_EQ(handler->getByteFromPageBuffer(data_word_idx * 4U + 1U), (data_word_idx >> 8U) & 0xFF);
+  }
+}
+
+TEST_F(PageBufferTests, PageBufferRandomAccessMultiSource) {  // NOLINT
+  constexpr uint32_t NUM_WORDS = (FLASH_PAGE_SIZE / 4U);
+  constexpr uint32_t BLOCK_SIZE = 64U;
+  setErasePageResult(true);
+  setWriteToFlashResult(true);
+
+  /* Create random data for one page */
+  std::array<uint8_t, FLASH_PAGE_SIZE> data_lst;
+  for (auto& entry : data_lst) {
+    entry = rand() % std::numeric_limits<uint8_t>::max();
+  }
+
+  auto get_num_words_rcvd = [&]() {
+    getHandle().processRequest(msg::Msg(msg::REQ_PAGE_BUFFER_STATUS, msg::RES_NONE, 0U));
+    EXPECT_EQ(getHandle().getResponse().result, msg::RES_OK);
+    return msg::convertMsgDataToU32(getHandle().getResponse().data);
+  };
+
+  msg::Msg flash_request = msg::Msg(msg::REQ_PAGE_BUFFER_WRITE_TO_FLASH, msg::RES_NONE, 0U);
+  msg::convertU32ToMsgData(FLASH_APP_FIRST_PAGE, flash_request.data);
+
+  /* Link 1 (CAN) fills the page from the start word by word, link 2 (UART) from the end block by block */
+  uint32_t can_word_idx = 0U;
+  uint32_t uart_byte_idx = FLASH_PAGE_SIZE;
+  while (can_word_idx * 4U < uart_byte_idx) {
+    const auto can_word_idx_high = static_cast<msg::ResultType>(can_word_idx >> 8U);
+    msg::Msg can_request =
+        msg::Msg(msg::REQ_PAGE_BUFFER_WRITE_WORD_AT, can_word_idx_high, static_cast<uint8_t>(can_word_idx & 0xFF));
+    for (auto idx = 0U; idx < 4U; idx++) {
+      can_request.data[idx] = data_lst.at(can_word_idx * 4U + idx);
+    }
+    getHandle().processRequest(can_request);
+    EXPECT_EQ(getHandle().getResponse().result, msg::RES_OK);
+    can_word_idx++;
+
+    if ((can_word_idx % 4U) == 0U && (can_word_idx * 4U < uart_byte_idx)) {
+      uart_byte_idx -= BLOCK_SIZE;
+      msg::Msg uart_request = msg::Msg(msg::REQ_PAGE_BUFFER_WRITE_BLOCK_AT, msg::RES_NONE, 0U);
+      msg::convertU32ToMsgData(uart_byte_idx, uart_request.data);
+      getHandle().processBlockRequest(uart_request, data_lst.data() + uart_byte_idx, BLOCK_SIZE);
+      EXPECT_EQ(getHandle().getResponse().result, msg::RES_OK);
+      EXPECT_EQ(msg::convertMsgDataToU32(getHandle().getResponse().data), uart_byte_idx + BLOCK_SIZE);
+    }
+
+    /* Page is not written before every word is received */
+    if (can_word_idx == 8U) {
+      EXPECT_EQ(get_num_words_rcvd(), 8U + 2U * (BLOCK_SIZE / 4U));
+      getHandle().processRequest(flash_request);
+      EXPECT_EQ(getHandle().getResponse().result, msg::RES_ERR_PAGE_INCOMPLETE);
+    }
+  }
+
+  EXPECT_EQ(get_num_words_rcvd(), NUM_WORDS);
+  for (auto byte_idx = 0U; byte_idx < FLASH_PAGE_SIZE; byte_idx++) {
+    EXPECT_EQ(getHandle().getByteFromPageBuffer(byte_idx), data_lst.at(byte_idx));
+  }
+
+  getHandle().processRequest(flash_request);
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_OK);
+}
+
+TEST_F(PageBufferTests, PageBufferWriteBlockAtInvldArgs) {  // NOLINT
+  constexpr msg::RequestType REQUEST = msg::REQ_PAGE_BUFFER_WRITE_BLOCK_AT;
+  std::array<uint8_t, 8U> block = {0};
+
+  /* Offset not word aligned */
+  msg::Msg request = msg::Msg(REQUEST, msg::RES_NONE, 0U);
+  msg::convertU32ToMsgData(2U, request.data);
+  getHandle().processBlockRequest(request, block.data(), block.size());
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_ERR_INVLD_ARG);
+
+  /* Block exceeds page */
+  msg::convertU32ToMsgData(FLASH_PAGE_SIZE - 4U, request.data);
+  getHandle().processBlockRequest(request, block.data(), block.size());
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_ERR_PAGE_FULL);
+
+  /* No block */
+  msg::convertU32ToMsgData(0U, request.data);
+  getHandle().processRequest(request);
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_ERR_INVLD_ARG);
+}
+
+TEST_F(PageBufferTests, PageBufferWriteToFlashWithGap) {  // NOLINT
+  setErasePageResult(true);
+  setWriteToFlashResult(true);
+
+  /* Word 0 lost, word 1 received */
+  getHandle().processRequest(msg::Msg(msg::REQ_PAGE_BUFFER_STREAM_WORD, msg::RES_NONE, 1U));
+
+  msg::Msg flash_request = msg::Msg(msg::REQ_PAGE_BUFFER_WRITE_TO_FLASH, msg::RES_NONE, 0U);
+  msg::convertU32ToMsgData(FLASH_APP_FIRST_PAGE, flash_request.data);
+  getHandle().processRequest(flash_request);
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_ERR_PAGE_INCOMPLETE);
+
+  /* Sequentially written pages may be shorter than the page buffer */
+  getHandle().processRequest(msg::Msg(msg::REQ_PAGE_BUFFER_STREAM_WORD, msg::RES_NONE, 0U));
+  getHandle().processRequest(flash_request);
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_OK);
+}
+
+TEST_F(PageBufferTests, PageBufferWritePageCanFd) {  // NOLINT
+  constexpr msg::RequestType REQUEST = msg::REQ_PAGE_BUFFER_WRITE_WORD;
+  constexpr size_t DATA_SIZE = msg::MSG_DATA_SIZE_CAN_FD;
+  constexpr uint32_t NUM_MSGS = (FLASH_PAGE_SIZE + DATA_SIZE - 1U) / DATA_SIZE;
+
+  using CanFdHandler = TestHandler<16U, DATA_SIZE>;
+  CanFdHandler handler(getHWI());
+
+  /* Create random data for one page */
+  std::array<uint8_t, NUM_MSGS * DATA_SIZE> data_lst;
+  for (auto& entry : data_lst) {
+    entry = rand() % std::numeric_limits<uint8_t>::max();
+  }
+
+  for (auto data_word_idx = 0U; data_word_idx < NUM_MSGS; data_word_idx++) {
+    const auto packet_id = static_cast<uint8_t>(data_word_idx & 0xFF);
+    CanFdHandler::Msg request = CanFdHandler::Msg(REQUEST, msg::RES_NONE, packet_id);
+    for (auto idx = 0U; idx < DATA_SIZE; idx++) {
+      request.data[idx] = data_lst.at((data_word_idx * DATA_SIZE) + idx);
+    }
+
+    handler.processRequest(request);
+
+    const auto response = handler.getResponse();
+    EXPECT_EQ(response.request, REQUEST);
+    EXPECT_EQ(response.packet_id, packet_id);
+    EXPECT_EQ(response.result, msg::RES_OK);
+  }
+
+  /* Page is full -> next word is rejected */
+  handler.processRequest(CanFdHandler::Msg(REQUEST, msg::RES_NONE, static_cast<uint8_t>(NUM_MSGS)));
+  EXPECT_EQ(handler.getResponse().result, msg::RES_ERR_PAGE_FULL);
+
+  /* Check if data is written correctly to buffer */
+  for (auto byte_idx = 0U; byte_idx < FLASH_PAGE_SIZE; byte_idx++) {
+    EXPECT_EQ(handler.getByteFromPageBuffer(byte_idx), data_lst.at(byte_idx));
+  }
+}
+
+TEST_F(PageBufferTests, PageBufferFill) {  // NOLINT
+  constexpr uint32_t WORD_SIZE = msg::MSG_DATA_SIZE_CAN;
+  constexpr uint32_t NUM_WORDS = 300U;
+
+  /* First word written, fill continues at the write position */
+  auto word_request = msg::Msg(msg::REQ_PAGE_BUFFER_WRITE_WORD, msg::RES_NONE, 0U);
+  word_request.data = {0x01, 0x02, 0x03, 0x04};
+  getHandle().processRequest(word_request);
+
+  auto request = msg::Msg(msg::REQ_PAGE_BUFFER_FILL, static_cast<msg::ResultType>(NUM_WORDS >> 8U),
+                          static_cast<uint8_t>(NUM_WORDS));
+  msg::convertU32ToMsgData(0xDDCCBBAAU, request.data);
+  getHandle().processRequest(request);
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_ERR_PAGE_FULL);
+
+  request = msg::Msg(msg::REQ_PAGE_BUFFER_FILL, msg::RES_NONE, 0U);
+  getHandle().processRequest(request);
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_ERR_INVLD_ARG);
+
+  request = msg::Msg(msg::REQ_PAGE_BUFFER_FILL, msg::RES_NONE, 10U);
+  msg::convertU32ToMsgData(0xDDCCBBAAU, request.data);
+  getHandle().processRequest(request);
+
+  EXPECT_TRUE(getHandle().isResponseAvl());
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_OK);
+  EXPECT_EQ(msg::convertMsgDataToU32(getHandle().getResponse().data), 11U * WORD_SIZE);
+  EXPECT_EQ(getHandle().getPageBufferNumBytesFree(), FLASH_PAGE_SIZE - 11U * WORD_SIZE);
+
+  EXPECT_EQ(getHandle().getByteFromPageBuffer(0U), 0x01);
+  for (auto byte_idx = WORD_SIZE; byte_idx < (11U * WORD_SIZE); byte_idx++) {
+    EXPECT_EQ(getHandle().getByteFromPageBuffer(byte_idx), request.data.at(byte_idx % 4U));
+  }
+}
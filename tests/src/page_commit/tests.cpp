@@ -0,0 +1,237 @@
+/**
+ * @file tests.cpp
+ * @author Martin Bauernschmitt (martin.bauernschmitt@francor.de)
+ * @brief Unit Tests of FRANCORs Frankly Bootloader - Deferred Page Buffer Writes
+ * @version 0.1
+ * @date 2022-11-26
+ *
+ * @copyright Copyright (c) 2022 - BSD-3-clause - FRANCOR e.V.
+ *
+ */
+
+#include <francor/frankly_test_utils.h>
+
+#include <array>
+#include <limits>
+
+using namespace franklyboot;              // NOLINT
+using namespace franklyboot::test_utils;  // NOLINT
+
+// Defines / Constexpr ------------------------------------------------------------------------------------------------
+
+/** \brief Handler receiving the next page while the last page is written */
+using DoubleBufferHandler = TestHandler<16U, msg::MSG_DATA_SIZE_CAN, 0U, 0U, 2U>;
+
+// Test Fixture Class -------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Test class for deferred page buffer writes
+ */
+class PageCommitTests : public TestHelper {
+ public:
+  PageCommitTests() = default;
+
+  /**
+   * @brief Fills the complete receiving page buffer with a pattern (REQ_PAGE_BUFFER_FILL)
+   */
+  template <typename HANDLER>
+  static void fillPage(HANDLER& handler, const uint32_t pattern) {
+    constexpr uint32_t NUM_WORDS = FLASH_PAGE_SIZE / msg::MSG_DATA_SIZE_CAN;
+
+    auto request = msg::Msg(msg::REQ_PAGE_BUFFER_FILL, static_cast<msg::ResultType>(NUM_WORDS >> 8U),
+                            static_cast<uint8_t>(NUM_WORDS));
+    msg::convertU32ToMsgData(pattern, request.data);
+    handler.processRequest(request);
+    EXPECT_EQ(handler.getResponse().result, msg::RES_OK);
+  }
+
+  /**
+   * @brief Creates a write request of the page buffer
+   */
+  [[nodiscard]] static msg::Msg createWriteRequest(const uint32_t page_id, const uint8_t flags) {
+    auto request = msg::Msg(msg::REQ_PAGE_BUFFER_WRITE_TO_FLASH, static_cast<msg::ResultType>(flags), 0U);
+    msg::convertU32ToMsgData(page_id, request.data);
+    return request;
+  }
+
+  template <typename HANDLER>
+  [[nodiscard]] static msg::Msg readCommitStatus(HANDLER& handler, const uint32_t buffer_idx) {
+    auto request = msg::Msg(msg::REQ_PAGE_BUFFER_COMMIT_STATUS, msg::RES_NONE, 0U);
+    msg::convertU32ToMsgData(buffer_idx, request.data);
+    handler.processRequest(request);
+    return handler.getResponse();
+  }
+
+  [[nodiscard]] bool isPageEqual(const uint32_t page_id, const uint32_t pattern) {
+    const uint32_t address = FLASH_START + page_id * FLASH_PAGE_SIZE;
+    for (auto idx = 0U; idx < FLASH_PAGE_SIZE; idx++) {
+      if (readByteFromFlash(address + idx) != static_cast<uint8_t>(pattern >> ((idx % 4U) * 8U))) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+};
+
+// Tests --------------------------------------------------------------------------------------------------------------
+
+TEST_F(PageCommitTests, Capabilities) {  // NOLINT
+  const auto capabilities = DoubleBufferHandler::getCapabilities();
+  EXPECT_EQ(capabilities.at(msg::CAP_NUM_PAGE_BUFFERS), 2U);
+  EXPECT_NE(capabilities.at(msg::CAP_FEATURES) & msg::FEATURE_WRITE_DEFER, 0U);
+
+  const auto capabilities_single = TestHandler<>::getCapabilities();
+  EXPECT_EQ(capabilities_single.at(msg::CAP_NUM_PAGE_BUFFERS), 1U);
+  EXPECT_EQ(capabilities_single.at(msg::CAP_FEATURES) & msg::FEATURE_WRITE_DEFER, 0U);
+}
+
+TEST_F(PageCommitTests, DeferredWrite) {  // NOLINT
+  constexpr uint32_t PATTERN_A = 0xA1A2A3A4U;
+  constexpr uint32_t PATTERN_B = 0xB1B2B3B4U;
+  constexpr uint32_t CRC_VALUE = 0xDEADBEEFU;
+  constexpr uint8_t FLAGS = msg::WRITE_TO_FLASH_DEFER | msg::WRITE_TO_FLASH_VERIFY;
+
+  DoubleBufferHandler handler(getHWI());
+  setErasePageResult(true);
+  setWriteToFlashResult(true);
+  setCRCResult(CRC_VALUE);
+
+  /* Page buffer 0 is handed over, page buffer 1 receives */
+  fillPage(handler, PATTERN_A);
+  handler.processRequest(createWriteRequest(FLASH_APP_FIRST_PAGE, FLAGS));
+  EXPECT_EQ(handler.getResponse().result, msg::RES_OK);
+  EXPECT_EQ(handler.getResponse().packet_id, 0U);
+  EXPECT_EQ(msg::convertMsgDataToU32(handler.getResponse().data), FLASH_APP_FIRST_PAGE);
+  EXPECT_FALSE(erasePageCalled());
+  EXPECT_FALSE(writeToFlashCalled());
+
+  handler.processRequest(msg::Msg(msg::REQ_PAGE_BUFFER_STATUS, msg::RES_NONE, 0U));
+  EXPECT_EQ(handler.getResponse().packet_id, 1U);
+  EXPECT_EQ(msg::convertMsgDataToU32(handler.getResponse().data), 0U);
+  EXPECT_EQ(handler.getByteFromPageBuffer(0U), std::numeric_limits<uint8_t>::max());
+
+  EXPECT_EQ(readCommitStatus(handler, 0U).result, msg::RES_BUSY);
+  EXPECT_EQ(readCommitStatus(handler, 1U).result, msg::RES_NONE);
+
+  /* Next page is received, but cannot be handed over until page buffer 0 is written */
+  fillPage(handler, PATTERN_B);
+  handler.processRequest(createWriteRequest(FLASH_APP_FIRST_PAGE + 1U, FLAGS));
+  EXPECT_EQ(handler.getResponse().result, msg::RES_BUSY);
+  EXPECT_EQ(handler.getResponse().packet_id, 1U);
+
+  handler.processBufferedCmds();
+  EXPECT_TRUE(isPageEqual(FLASH_APP_FIRST_PAGE, PATTERN_A));
+
+  const auto status = readCommitStatus(handler, 0U);
+  EXPECT_EQ(status.result, msg::RES_OK);
+  EXPECT_EQ(status.packet_id, 0U);
+  EXPECT_EQ(msg::convertMsgDataToU32(status.data), CRC_VALUE);
+
+  /* Repeated write is accepted now */
+  handler.processRequest(createWriteRequest(FLASH_APP_FIRST_PAGE + 1U, FLAGS));
+  EXPECT_EQ(handler.getResponse().result, msg::RES_OK);
+  EXPECT_EQ(handler.getResponse().packet_id, 1U);
+
+  handler.processBufferedCmds();
+  EXPECT_TRUE(isPageEqual(FLASH_APP_FIRST_PAGE + 1U, PATTERN_B));
+  EXPECT_EQ(readCommitStatus(handler, 1U).result, msg::RES_OK);
+
+  /* Nothing left to write */
+  handler.processBufferedCmds();
+  EXPECT_EQ(readCommitStatus(handler, 0U).result, msg::RES_OK);
+}
+
+TEST_F(PageCommitTests, DeferredWriteHWError) {  // NOLINT
+  DoubleBufferHandler handler(getHWI());
+  setErasePageResult(false);
+  setByteInFlash(FLASH_START + FLASH_APP_FIRST_PAGE * FLASH_PAGE_SIZE, 0x00U);
+
+  fillPage(handler, 0x12345678U);
+  handler.processRequest(createWriteRequest(FLASH_APP_FIRST_PAGE, msg::WRITE_TO_FLASH_DEFER));
+  EXPECT_EQ(handler.getResponse().result, msg::RES_OK);
+
+  handler.processBufferedCmds();
+  EXPECT_TRUE(erasePageCalled());
+
+  const auto status = readCommitStatus(handler, 0U);
+  EXPECT_EQ(status.result, msg::RES_ERR);
+  EXPECT_EQ(msg::convertMsgDataToU32(status.data), FLASH_APP_FIRST_PAGE);
+}
+
+TEST_F(PageCommitTests, DeferredWriteBusy) {  // NOLINT
+  DoubleBufferHandler handler(getHWI());
+  setErasePageResult(true);
+  setWriteToFlashResult(true);
+
+  fillPage(handler, 0x12345678U);
+  handler.processRequest(createWriteRequest(FLASH_APP_FIRST_PAGE, msg::WRITE_TO_FLASH_DEFER));
+  EXPECT_EQ(handler.getResponse().result, msg::RES_OK);
+
+  /* Flash is modified / read by these requests, they wait for the pending write */
+  const std::array<msg::RequestType, 5U> rejected_requests = {
+      msg::REQ_START_APP, msg::REQ_FLASH_WRITE_ERASE_PAGE, msg::REQ_FLASH_WRITE_APP_CRC,
+      msg::REQ_FLASH_WRITE_ERASE_RANGE, msg::REQ_PAGE_BUFFER_COPY_FROM_FLASH};
+
+  for (const auto request : rejected_requests) {
+    handler.processRequest(msg::Msg(request, msg::RES_NONE, 0U));
+    EXPECT_EQ(handler.getResponse().request, request);
+    EXPECT_EQ(handler.getResponse().result, msg::RES_BUSY);
+  }
+
+  /* Direct write keeps the order of the pages */
+  fillPage(handler, 0x9ABCDEF0U);
+  handler.processRequest(createWriteRequest(FLASH_APP_FIRST_PAGE + 1U, 0U));
+  EXPECT_EQ(handler.getResponse().result, msg::RES_BUSY);
+  EXPECT_FALSE(startAppCalled());
+
+  handler.processBufferedCmds();
+  handler.processRequest(createWriteRequest(FLASH_APP_FIRST_PAGE + 1U, 0U));
+  EXPECT_EQ(handler.getResponse().result, msg::RES_OK);
+  EXPECT_EQ(handler.getResponse().packet_id, 1U);
+  EXPECT_TRUE(isPageEqual(FLASH_APP_FIRST_PAGE + 1U, 0x9ABCDEF0U));
+}
+
+TEST_F(PageCommitTests, DeferredWriteEraseRangeBusy) {  // NOLINT
+  DoubleBufferHandler handler(getHWI());
+  setErasePageResult(true);
+  setWriteToFlashResult(true);
+
+  auto erase_request = msg::Msg(msg::REQ_FLASH_WRITE_ERASE_RANGE, msg::RES_NONE, 0U);
+  erase_request.data = {FLASH_APP_FIRST_PAGE, 0U, 1U, 0U};
+  handler.processRequest(erase_request);
+  EXPECT_EQ(handler.getResponse().result, msg::RES_OK);
+
+  fillPage(handler, 0x12345678U);
+  handler.processRequest(createWriteRequest(FLASH_APP_FIRST_PAGE, msg::WRITE_TO_FLASH_DEFER));
+  EXPECT_EQ(handler.getResponse().result, msg::RES_BUSY);
+
+  handler.processBufferedCmds();
+  handler.processRequest(createWriteRequest(FLASH_APP_FIRST_PAGE, msg::WRITE_TO_FLASH_DEFER));
+  EXPECT_EQ(handler.getResponse().result, msg::RES_OK);
+}
+
+TEST_F(PageCommitTests, SingleBufferWritesDirectly) {  // NOLINT
+  constexpr uint32_t CRC_VALUE = 0x0BADF00DU;
+
+  setErasePageResult(true);
+  setWriteToFlashResult(true);
+  setCRCResult(CRC_VALUE);
+
+  /* Defer flag is ignored with one page buffer, the status reports the last write */
+  fillPage(getHandle(), 0x12345678U);
+  getHandle().processRequest(
+      createWriteRequest(FLASH_APP_FIRST_PAGE, msg::WRITE_TO_FLASH_DEFER | msg::WRITE_TO_FLASH_VERIFY));
+  EXPECT_EQ(getHandle().getResponse().result, msg::RES_OK);
+  EXPECT_EQ(msg::convertMsgDataToU32(getHandle().getResponse().data), CRC_VALUE);
+  EXPECT_TRUE(isPageEqual(FLASH_APP_FIRST_PAGE, 0x12345678U));
+
+  const auto status = readCommitStatus(getHandle(), 0U);
+  EXPECT_EQ(status.result, msg::RES_OK);
+  EXPECT_EQ(msg::convertMsgDataToU32(status.data), CRC_VALUE);
+
+  /* Page buffer is kept for a repeated write */
+  EXPECT_EQ(getHandle().getByteFromPageBuffer(0U), 0x78U);
+
+  EXPECT_EQ(readCommitStatus(getHandle(), 1U).result, msg::RES_ERR_INVLD_ARG);
+}
@@ -30,12 +30,22 @@ extern "C" bool SIM_addDevice(uint8_t node_id);
 /** \brief Get number of devices registered to simulator */
 extern "C" uint32_t SIM_getDeviceCount();
 
-/** \brief Send broadcast message to all devices */
+/**
+ * \brief Send broadcast message to all devices
+ *
+ * Messages are queued until SIM_updateDevices() is called, page buffer fills are processed silently.
+ */
 extern "C" void SIM_sendBroadcastMsg(uint8_t* const raw_msg_ptr);
 
+/** \brief Simulates the loss of the next broadcast message at one device */
+extern "C" void SIM_dropNextBroadcastMsg(uint8_t node_id);
+
 /** \brief Send node specific message to device */
 extern "C" void SIM_sendNodeMsg(uint8_t node_id, uint8_t* const raw_msg_ptr);
 
+/** \brief Send node specific ISO-TP frame to device */
+extern "C" void SIM_sendNodeIsoTpFrame(uint8_t node_id, uint8_t* const raw_frame_ptr);
+
 /** \brief Update devices */
 extern "C" void SIM_updateDevices();
 
@@ -45,6 +55,9 @@ extern "C" bool SIM_getBroadcastResponseMsg(uint8_t* node_id, uint8_t* raw_msg_p
 /** \brief Get node specific response msg */
 extern "C" bool SIM_getNodeResponseMsg(uint8_t node_id, uint8_t* raw_msg_ptr);
 
+/** \brief Get node specific ISO-TP frame (flow control) */
+extern "C" bool SIM_getNodeIsoTpFrame(uint8_t node_id, uint8_t* raw_frame_ptr);
+
 #endif /* __cplusplus */
 
 #endif /* DEVICE_SIM_API_H_ */
\ No newline at end of file
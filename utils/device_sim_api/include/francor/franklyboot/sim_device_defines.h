@@ -30,6 +30,9 @@ constexpr uint32_t FLASH_APP_FIRST_PAGE = {4U};
 constexpr uint32_t FLASH_SIZE = {1024 * 1024U};
 constexpr uint32_t FLASH_PAGE_SIZE = {2048U};
 constexpr uint32_t FLASH_APP_START_ADDR = FLASH_START_ADDR + FLASH_APP_FIRST_PAGE * FLASH_PAGE_SIZE;
+
+constexpr uint8_t ISOTP_BLOCK_SIZE = {32U};      //!< Consecutive frames send without flow control
+constexpr uint8_t ISOTP_SEPARATION_TIME = {0U};  //!< Min. time between consecutive frames (STmin)
 };  // namespace sim_device
 
 #endif /* __cplusplus */
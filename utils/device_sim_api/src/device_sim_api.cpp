@@ -14,8 +14,11 @@
 // Includes -----------------------------------------------------------------------------------------------------------
 #include <francor/franklyboot/device_sim_api.h>
 #include <francor/franklyboot/handler.h>
+#include <francor/franklyboot/isotp.h>
 
 #include <cstring>
+#include <deque>
+#include <utility>
 #include <vector>
 
 // Private typedefs ----------------------------------------------------------------------------------------------------
@@ -25,50 +28,120 @@ using namespace franklyboot;
 using SimDeviceHandler = Handler<sim_device::FLASH_APP_START_ADDR, sim_device::FLASH_APP_FIRST_PAGE,
                                  sim_device::FLASH_SIZE, sim_device::FLASH_PAGE_SIZE>;
 
+/** \brief Max. size of a logical ISO-TP message (msg + complete page) */
+constexpr uint32_t ISOTP_MAX_MSG_SIZE = msg::MSG_HEADER_SIZE + msg::MSG_DATA_SIZE_CAN + sim_device::FLASH_PAGE_SIZE;
+
 class SimDevice {
  public:
   explicit SimDevice(uint8_t node_id) : _node_id(node_id) {}
 
   void broadcastMsg(const msg::Msg& msg) {
-    _request_msg = msg;
-    _new_broadcast_msg = true;
+    if (_drop_broadcast_msg) {
+      _drop_broadcast_msg = false;
+      return;
+    }
+
+    _request_lst.emplace_back(msg, true);
   }
 
-  void nodeMsg(const msg::Msg& msg) {
-    _request_msg = msg;
-    _new_msg = true;
+  void dropNextBroadcastMsg() { _drop_broadcast_msg = true; }
+
+  void nodeMsg(const msg::Msg& msg) { _request_lst.emplace_back(msg, false); }
+
+  void nodeIsoTpFrame(const isotp::Frame& frame) {
+    isotp::Frame flow_control;
+    if (_isotp_receiver.processFrame(frame, flow_control)) {
+      _isotp_frame_lst.push_back(flow_control);
+    }
   }
 
   void processRequest() {
-    if (_new_msg || _new_broadcast_msg) {
-      _handler.processRequest(_request_msg);
-      _new_response_msg = _new_msg;
-      _new_broadcast_response_msg = _new_broadcast_msg;
+    if (_isotp_receiver.isMsgAvl()) {
+      processIsoTpMsg();
+    }
 
-      _new_msg = false;
-      _new_broadcast_msg = false;
+    /* Requests are queued, so the host can stream broadcast data without updating the devices in between */
+    while (!_request_lst.empty()) {
+      const auto [request_msg, broadcast] = _request_lst.front();
+      _request_lst.pop_front();
+
+      if (broadcast) {
+        _handler.processBroadcastRequest(request_msg);
+        queueResponseMsgs(_broadcast_response_lst);
+      } else {
+        _handler.processRequest(request_msg);
+        queueResponseMsgs(_response_lst);
+      }
     }
+
+    /* Continues background operations (e.g. REQ_FLASH_WRITE_ERASE_RANGE) */
+    _handler.processBufferedCmds();
   }
 
-  [[nodiscard]] msg::Msg getResponseMsg() {
-    _new_response_msg = false;
-    _new_broadcast_response_msg = false;
-    return _handler.getResponse();
+  [[nodiscard]] msg::Msg getBroadcastResponseMsg() { return popResponseMsg(_broadcast_response_lst); }
+  [[nodiscard]] msg::Msg getNodeResponseMsg() { return popResponseMsg(_response_lst); }
+
+  [[nodiscard]] bool getIsoTpFrame(isotp::Frame& frame) {
+    if (_isotp_frame_lst.empty()) {
+      return false;
+    }
+
+    frame = _isotp_frame_lst.front();
+    _isotp_frame_lst.pop_front();
+    return true;
   }
 
   [[nodiscard]] uint8_t getNodeId() const { return _node_id; }
-  [[nodiscard]] bool isBroadcastResponseAvl() const { return _new_broadcast_response_msg; }
-  [[nodiscard]] bool isNodeResponseAvl() const { return _new_response_msg; }
+  [[nodiscard]] bool isBroadcastResponseAvl() const { return !_broadcast_response_lst.empty(); }
+  [[nodiscard]] bool isNodeResponseAvl() const { return !_response_lst.empty(); }
 
  private:
+  void queueResponseMsgs(std::deque<msg::Msg>& response_lst) {
+    /* Multi-frame responses: all frames are transmitted back-to-back */
+    while (_handler.isResponseAvl()) {
+      response_lst.push_back(_handler.getResponse());
+      _handler.processNextResponse();
+    }
+  }
+
+  [[nodiscard]] static msg::Msg popResponseMsg(std::deque<msg::Msg>& response_lst) {
+    const auto response_msg = response_lst.front();
+    response_lst.pop_front();
+    return response_msg;
+  }
+
+  void processIsoTpMsg() {
+    msg::MsgRaw request_msg_raw = msg::MsgRaw();
+    const uint32_t msg_size = _isotp_receiver.getMsgSize();
+
+    /* Logical message: [msg | data block] */
+    if (msg_size >= request_msg_raw.size()) {
+      std::memcpy(request_msg_raw.data(), _isotp_receiver.getMsgData(), request_msg_raw.size());
+      const auto request_msg = msg::convertBytesToMsg(request_msg_raw);
+
+      const uint8_t* block_ptr = _isotp_receiver.getMsgData() + request_msg_raw.size();
+      const uint32_t block_size = msg_size - static_cast<uint32_t>(request_msg_raw.size());
+      _handler.processBlockRequest(request_msg, block_ptr, block_size);
+      queueResponseMsgs(_response_lst);
+    }
+
+    isotp::Frame flow_control;
+    if (_isotp_receiver.releaseMsg(flow_control)) {
+      _isotp_frame_lst.push_back(flow_control);
+    }
+  }
+
   const uint8_t _node_id;  //!< Node ID of the device
 
-  msg::Msg _request_msg;              //!< Last request msg
-  bool _new_msg = {false};            //!< Flag if new request msg is available
-  bool _new_broadcast_msg = {false};  //!< Flag if new request msg is a broadcast msg
+  std::deque<std::pair<msg::Msg, bool>> _request_lst;  //!< Received request msgs (msg, broadcast flag)
+  bool _drop_broadcast_msg = {false};                   //!< Next broadcast msg is lost (error simulation)
+
+  std::deque<msg::Msg> _response_lst;            //!< Responses to node specific requests
+  std::deque<msg::Msg> _broadcast_response_lst;  //!< Responses to broadcast requests
 
-  bool _new_response_msg = {false};            //!< Flash indicating that new response is avl
-  bool _new_broadcast_response_msg = {false};  //!< Flag indicating that new broadcast response is avl
+  isotp::Receiver<ISOTP_MAX_MSG_SIZE> _isotp_receiver = {
+      isotp::Receiver<ISOTP_MAX_MSG_SIZE>(sim_device::ISOTP_BLOCK_SIZE, sim_device::ISOTP_SEPARATION_TIME)};
+  std::deque<isotp::Frame> _isotp_frame_lst;  //!< ISO-TP frames (flow control) to transmit
 
   SimDeviceHandler _handler;  //!< Handler for the device
 };
@@ -107,6 +180,14 @@ extern "C" void SIM_sendBroadcastMsg(uint8_t* const raw_msg_ptr) {
   }
 }
 
+extern "C" void SIM_dropNextBroadcastMsg(const uint8_t node_id) {
+  for (auto& device : sim_device_lst) {
+    if (node_id == device.getNodeId()) {
+      device.dropNextBroadcastMsg();
+    }
+  }
+}
+
 extern "C" void SIM_sendNodeMsg(const uint8_t node_id, uint8_t* const raw_msg_ptr) {
   msg::MsgRaw request_msg_raw = msg::MsgRaw();
   std::memcpy(request_msg_raw.data(), raw_msg_ptr, request_msg_raw.size());
@@ -120,6 +201,17 @@ extern "C" void SIM_sendNodeMsg(const uint8_t node_id, uint8_t* const raw_msg_pt
   }
 }
 
+extern "C" void SIM_sendNodeIsoTpFrame(const uint8_t node_id, uint8_t* const raw_frame_ptr) {
+  isotp::Frame frame = isotp::Frame();
+  std::memcpy(frame.data(), raw_frame_ptr, frame.size());
+
+  for (auto& device : sim_device_lst) {
+    if (node_id == device.getNodeId()) {
+      device.nodeIsoTpFrame(frame);
+    }
+  }
+}
+
 /** \brief Update devices */
 extern "C" void SIM_updateDevices() {
   for (auto& device : sim_device_lst) {
@@ -132,7 +224,7 @@ extern "C" bool SIM_getBroadcastResponseMsg(uint8_t* node_id, uint8_t* raw_msg_p
   // Loop through all devices and send message to specified node
   for (auto& device : sim_device_lst) {
     if (device.isBroadcastResponseAvl()) {
-      const auto response_msg = device.getResponseMsg();
+      const auto response_msg = device.getBroadcastResponseMsg();
       const auto response_msg_raw = msg::convertMsgToBytes(response_msg);
       std::memcpy(raw_msg_ptr, response_msg_raw.data(), response_msg_raw.size());
       (*node_id) = device.getNodeId();
@@ -148,7 +240,7 @@ extern "C" bool SIM_getNodeResponseMsg(const uint8_t node_id, uint8_t* raw_msg_p
   // Loop through all devices and send message to specified node
   for (auto& device : sim_device_lst) {
     if (node_id == device.getNodeId() && device.isNodeResponseAvl()) {
-      const auto response_msg = device.getResponseMsg();
+      const auto response_msg = device.getNodeResponseMsg();
       const auto response_msg_raw = msg::convertMsgToBytes(response_msg);
       std::memcpy(raw_msg_ptr, response_msg_raw.data(), response_msg_raw.size());
       return true;
@@ -158,6 +250,19 @@ extern "C" bool SIM_getNodeResponseMsg(const uint8_t node_id, uint8_t* raw_msg_p
   return false;
 }
 
+/** \brief Get node specific ISO-TP frame (flow control) */
+extern "C" bool SIM_getNodeIsoTpFrame(const uint8_t node_id, uint8_t* raw_frame_ptr) {
+  for (auto& device : sim_device_lst) {
+    isotp::Frame frame;
+    if (node_id == device.getNodeId() && device.getIsoTpFrame(frame)) {
+      std::memcpy(raw_frame_ptr, frame.data(), frame.size());
+      return true;
+    }
+  }
+
+  return false;
+}
+
 // Device HWI ---------------------------------------------------------------------------------------------------------
 
 void hwi::resetDevice() {}